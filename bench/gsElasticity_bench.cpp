@@ -0,0 +1,815 @@
+/// This is the benchmark suite of gsElasticity. It consists of
+/// - microbenchmarks: per-element cost of the element visitors for different degrees and dimensions,
+///   tensor kernels of the material laws, bijectivity checks and sampling of the output;
+/// - end-to-end cases: Cook's membrane, the Terrific part and the flapping beam benchmarks CSM1, CFD1 and FSI2
+///   on sweeps of uniform refinement.
+/// The results are written to <output>.csv and <output>.json. If a baseline CSV file written by a previous run
+/// is given, every case is compared to it and the program returns a non-zero exit code if a case became slower
+/// than the tolerance allows. The baseline must have been run with the same number of threads; a different
+/// number of repetitions is reported as a warning. With the environmental variable ELAST_PROFILE set, the timings are additionally
+/// split into assembly, factorization and solve phases (see gsProfiler.h).
+///
+/// Author: A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+#include <gismo.h>
+#include <gsElasticity/gsElasticityAssembler.h>
+#include <gsElasticity/gsMassAssembler.h>
+#include <gsElasticity/gsNsAssembler.h>
+#include <gsElasticity/gsElPoissonAssembler.h>
+#include <gsElasticity/gsBiharmonicAssembler.h>
+#include <gsElasticity/gsIterative.h>
+#include <gsElasticity/gsElTimeIntegrator.h>
+#include <gsElasticity/gsNsTimeIntegrator.h>
+#include <gsElasticity/gsALE.h>
+#include <gsElasticity/gsPartitionedFSI.h>
+#include <gsElasticity/gsElasticityFunctions.h>
+#include <gsElasticity/gsVisitorElUtils.h>
+#include <gsElasticity/gsGeoUtils.h>
+#include <gsElasticity/gsGridEvaluator.h>
+#include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace gismo;
+
+//=====================================//
+        // Timing and reporting //
+//=====================================//
+
+/// one benchmarked case; <count> is the number of units (elements, points, calls, time steps) processed per run
+struct benchResult
+{
+    std::string group, name, params;
+    index_t dofs, count;
+    std::string unit;
+    index_t reps;
+    real_t seconds; // best time over the repetitions
+
+    std::string key() const { return group + "/" + name + "/" + params; }
+    real_t perUnit() const { return count > 0 ? seconds/count : seconds; }
+};
+
+class benchReport
+{
+public:
+    benchReport(std::string const & filter, index_t numThreads) : m_filter(filter), m_numThreads(numThreads) {}
+
+    /// checks whether a case is selected by the filter
+    bool selected(std::string const & name) const
+    { return m_filter.empty() || name.find(m_filter) != std::string::npos; }
+
+    void add(std::string const & group, std::string const & name, std::string const & params,
+             index_t dofs, index_t count, std::string const & unit, index_t reps, real_t seconds)
+    {
+        benchResult result = {group,name,params,dofs,count,unit,reps,seconds};
+        m_results.push_back(result);
+        gsInfo << std::left << std::setw(12) << group << std::setw(40) << name << std::setw(10) << params
+               << std::right << std::setw(12) << seconds << " s" << std::setw(14) << result.perUnit()
+               << " s/" << unit << "\n";
+    }
+
+    void writeCSV(std::string const & fileName) const
+    {
+        std::ofstream file(fileName.c_str());
+        file << std::setprecision(9);
+        file << "group,name,params,dofs,count,unit,threads,reps,seconds,per_unit\n";
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const benchResult & r = m_results[i];
+            file << r.group << "," << r.name << "," << r.params << "," << r.dofs << "," << r.count << ","
+                 << r.unit << "," << m_numThreads << "," << r.reps << "," << r.seconds << "," << r.perUnit() << "\n";
+        }
+    }
+
+    void writeJSON(std::string const & fileName) const
+    {
+        std::ofstream file(fileName.c_str());
+        file << std::setprecision(9);
+        file << "{\n\"version\": 1,\n\"threads\": " << m_numThreads << ",\n\"results\": [";
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const benchResult & r = m_results[i];
+            file << (i == 0 ? "\n" : ",\n")
+                 << "  {\"group\": \"" << r.group << "\", \"name\": \"" << r.name << "\", \"params\": \"" << r.params
+                 << "\", \"dofs\": " << r.dofs << ", \"count\": " << r.count << ", \"unit\": \"" << r.unit
+                 << "\", \"reps\": " << r.reps << ", \"seconds\": " << r.seconds << ", \"per_unit\": " << r.perUnit() << "}";
+        }
+        file << "\n]\n}\n";
+    }
+
+    /// compares the results with a CSV file of a previous run; returns the number of regressions,
+    /// i.e. cases which are slower than the baseline by more than the relative tolerance.
+    /// Timings with different numbers of threads are not comparable, so such a baseline is rejected.
+    index_t compare(std::string const & fileName, real_t tolerance) const
+    {
+        std::ifstream file(fileName.c_str());
+        GISMO_ENSURE(file.good(),"Cannot open the baseline file " + fileName);
+        std::map<std::string,std::pair<real_t,index_t> > baseline; // seconds and repetitions
+        std::string line;
+        std::getline(file,line);
+        GISMO_ENSURE(line == "group,name,params,dofs,count,unit,threads,reps,seconds,per_unit",
+                     "The baseline file " + fileName + " does not record the number of threads, rerun the baseline");
+        while (std::getline(file,line))
+        {
+            std::vector<std::string> columns;
+            std::stringstream stream(line);
+            std::string column;
+            while (std::getline(stream,column,','))
+                columns.push_back(column);
+            if (columns.size() != 10)
+                continue;
+            const index_t threads = atoi(columns[6].c_str());
+            GISMO_ENSURE(threads == m_numThreads,"The baseline " + fileName + " was run with " + columns[6] +
+                         " thread(s), this run uses " + util::to_string(m_numThreads) + "; set OMP_NUM_THREADS to match");
+            baseline[columns[0] + "/" + columns[1] + "/" + columns[2]] =
+                    std::make_pair(atof(columns[8].c_str()),atoi(columns[7].c_str()));
+        }
+
+        index_t numRegressions = 0;
+        gsInfo << "\nComparison with the baseline " << fileName << " (tolerance " << tolerance*100 << "%):\n";
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const benchResult & r = m_results[i];
+            std::map<std::string,std::pair<real_t,index_t> >::const_iterator it = baseline.find(r.key());
+            if (it == baseline.end() || it->second.first <= 0.)
+            {
+                gsInfo << std::left << std::setw(64) << r.key() << "  no baseline\n";
+                continue;
+            }
+            const real_t ratio = r.seconds/it->second.first;
+            const bool regression = ratio > 1. + tolerance;
+            if (regression)
+                ++numRegressions;
+            gsInfo << std::left << std::setw(64) << r.key() << std::right << std::setw(10) << ratio << "x"
+                   << (regression ? "  REGRESSION" : (ratio < 1. - tolerance ? "  improved" : ""));
+            // the best of fewer repetitions is biased towards slower times
+            if (it->second.second != r.reps)
+                gsInfo << "  (warning: best of " << it->second.second << " in the baseline, " << r.reps << " now)";
+            gsInfo << "\n";
+        }
+        gsInfo << numRegressions << " regression(s).\n";
+        return numRegressions;
+    }
+
+protected:
+    std::string m_filter;
+    index_t m_numThreads;
+    std::vector<benchResult> m_results;
+};
+
+/// best wall-clock time of an operation over several repetitions
+template <class Operation>
+real_t bestTime(Operation operation, index_t reps)
+{
+    real_t best = std::numeric_limits<real_t>::max();
+    gsStopwatch clock;
+    for (index_t r = 0; r < reps; ++r)
+    {
+        clock.restart();
+        operation();
+        best = std::min<real_t>(best,clock.stop());
+    }
+    return best;
+}
+
+//=====================================//
+        // Microbenchmarks //
+//=====================================//
+
+/// unit square or cube with a basis of the given degree and uniform refinement
+void unitDomain(short_t dim, index_t degree, index_t numUniRef, gsMultiPatch<> & domain, gsMultiBasis<> & basis)
+{
+    domain.clear();
+    if (dim == 2)
+        domain.addPatch(*gsNurbsCreator<>::BSplineSquare(1.));
+    else
+        domain.addPatch(*gsNurbsCreator<>::BSplineCube(1.));
+    domain.computeTopology();
+    basis = gsMultiBasis<>(domain);
+    if (degree > 1)
+        basis.degreeElevate(degree-1);
+    for (index_t i = 0; i < numUniRef; ++i)
+        basis.uniformRefine();
+}
+
+/// a smooth solution vector of small magnitude used as the current state of nonlinear assemblies
+gsMatrix<> perturbation(index_t numDofs, real_t magnitude = 1e-3)
+{
+    gsMatrix<> vector(numDofs,1);
+    for (index_t i = 0; i < numDofs; ++i)
+        vector(i,0) = magnitude*sin(real_t(i));
+    return vector;
+}
+
+/// per-element cost of the element visitors: the whole assembly divided by the number of elements
+void benchVisitors(benchReport & report, index_t reps, index_t maxDegree, index_t numUniRef2D, index_t numUniRef3D)
+{
+    for (short_t dim = 2; dim <= 3; ++dim)
+        for (index_t degree = 1; degree <= maxDegree; ++degree)
+        {
+            gsMultiPatch<> domain;
+            gsMultiBasis<> basis;
+            unitDomain(dim,degree,dim == 2 ? numUniRef2D : numUniRef3D,domain,basis);
+            // subgrid mixed elements: the displacement/velocity basis is refined once more
+            gsMultiBasis<> basisFine(basis);
+            basisFine.uniformRefine();
+            const index_t numElements = basis.totalElements();
+            const index_t numElementsFine = basisFine.totalElements();
+            const std::string params = util::to_string(dim) + "D_p" + util::to_string(degree);
+
+            gsVector<> unitVector(dim);
+            unitVector.setConstant(1.);
+            gsConstantFunction<> force(unitVector,dim);
+            gsConstantFunction<> scalarForce(1.,dim);
+            gsBoundaryConditions<> bcVector, bcScalar, bcBiharmonic;
+            for (short_t d = 0; d < dim; ++d)
+                bcVector.addCondition(0,boundary::west,condition_type::dirichlet,0,d);
+            bcScalar.addCondition(0,boundary::west,condition_type::dirichlet,0,0);
+            bcBiharmonic.addCondition(0,boundary::west,condition_type::dirichlet,0,0);
+            bcBiharmonic.addCondition(0,boundary::west,condition_type::dirichlet,0,1);
+
+            if (report.selected("linear elasticity"))
+            {
+                gsElasticityAssembler<real_t> assembler(domain,basis,bcVector,force);
+                report.add("visitor","linear elasticity",params,assembler.numDofs(),numElements,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+
+            const index_t laws[] = {material_law::saint_venant_kirchhoff,material_law::neo_hooke_ln,material_law::neo_hooke_quad};
+            const std::string lawNames[] = {"St.Venant-Kirchhoff","neo-Hooke ln","neo-Hooke quad"};
+            for (index_t l = 0; l < 3; ++l)
+                if (report.selected("nonlinear elasticity " + lawNames[l]))
+                {
+                    gsElasticityAssembler<real_t> assembler(domain,basis,bcVector,force);
+                    assembler.options().setInt("MaterialLaw",laws[l]);
+                    gsMultiPatch<> displacement;
+                    assembler.constructSolution(perturbation(assembler.numDofs()),assembler.allFixedDofs(),displacement);
+                    report.add("visitor","nonlinear elasticity " + lawNames[l],params,assembler.numDofs(),numElements,"element",reps,
+                               bestTime([&](){ assembler.assemble(displacement); },reps));
+                }
+
+            if (report.selected("mixed linear elasticity"))
+            {
+                gsElasticityAssembler<real_t> assembler(domain,basisFine,basis,bcVector,force);
+                assembler.options().setInt("MaterialLaw",material_law::mixed_hooke);
+                report.add("visitor","mixed linear elasticity",params,assembler.numDofs(),numElementsFine,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+
+            if (report.selected("mixed nonlinear elasticity"))
+            {
+                gsElasticityAssembler<real_t> assembler(domain,basisFine,basis,bcVector,force);
+                assembler.options().setInt("MaterialLaw",material_law::mixed_neo_hooke_ln);
+                gsMultiPatch<> displacement, pressure;
+                assembler.constructSolution(perturbation(assembler.numDofs()),assembler.allFixedDofs(),displacement,pressure);
+                report.add("visitor","mixed nonlinear elasticity",params,assembler.numDofs(),numElementsFine,"element",reps,
+                           bestTime([&](){ assembler.assemble(displacement,pressure); },reps));
+            }
+
+            if (report.selected("mass"))
+            {
+                gsMassAssembler<real_t> assembler(domain,basis,bcVector,force);
+                report.add("visitor","mass",params,assembler.numDofs(),numElements,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+
+            if (report.selected("Stokes"))
+            {
+                gsNsAssembler<real_t> assembler(domain,basisFine,basis,bcVector,force);
+                report.add("visitor","Stokes",params,assembler.numDofs(),numElementsFine,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+
+            if (report.selected("Navier-Stokes"))
+            {
+                gsNsAssembler<real_t> assembler(domain,basisFine,basis,bcVector,force);
+                gsMultiPatch<> velocity, pressure;
+                assembler.constructSolution(perturbation(assembler.numDofs()),assembler.allFixedDofs(),velocity,pressure);
+                report.add("visitor","Navier-Stokes",params,assembler.numDofs(),numElementsFine,"element",reps,
+                           bestTime([&](){ assembler.assemble(velocity,pressure); },reps));
+            }
+
+            if (report.selected("Poisson"))
+            {
+                gsElPoissonAssembler<real_t> assembler(domain,basis,bcScalar,scalarForce);
+                report.add("visitor","Poisson",params,assembler.numDofs(),numElements,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+
+            if (report.selected("bi-harmonic"))
+            {
+                gsBiharmonicAssembler<real_t> assembler(domain,basis,bcBiharmonic,scalarForce);
+                report.add("visitor","bi-harmonic",params,assembler.numDofs(),numElements,"element",reps,
+                           bestTime([&](){ assembler.assemble(); },reps));
+            }
+        }
+}
+
+/// tensor kernels of the nonlinear material laws, evaluated once per quadrature point and basis function
+void benchTensorKernels(benchReport & report, index_t reps, index_t numCalls)
+{
+    for (short_t dim = 2; dim <= 3; ++dim)
+    {
+        const std::string params = util::to_string(dim) + "D";
+        gsMatrix<> F = gsMatrix<>::Identity(dim,dim);
+        for (short_t i = 0; i < dim; ++i)
+            for (short_t j = 0; j < dim; ++j)
+                F(i,j) += 1e-2*(i+2*j+1);
+        gsMatrix<> RCG = F.transpose()*F;
+        gsMatrix<> RCGinv = RCG.cramerInverse();
+        gsVector<> grad(dim);
+        grad.setConstant(0.5);
+        gsMatrix<> C, B;
+        gsVector<> Svec;
+        real_t sink = 0.; // keeps the compiler from dropping the loops
+
+        if (report.selected("matrixTraceTensor"))
+            report.add("kernel","matrixTraceTensor",params,0,numCalls,"call",reps,bestTime([&]()
+            {
+                for (index_t i = 0; i < numCalls; ++i)
+                {
+                    matrixTraceTensor<real_t>(C,RCGinv,RCGinv);
+                    sink += C(0,0);
+                }
+            },reps));
+        if (report.selected("symmetricIdentityTensor"))
+            report.add("kernel","symmetricIdentityTensor",params,0,numCalls,"call",reps,bestTime([&]()
+            {
+                for (index_t i = 0; i < numCalls; ++i)
+                {
+                    symmetricIdentityTensor<real_t>(C,RCGinv);
+                    sink += C(0,0);
+                }
+            },reps));
+        if (report.selected("setB"))
+            report.add("kernel","setB",params,0,numCalls,"call",reps,bestTime([&]()
+            {
+                for (index_t i = 0; i < numCalls; ++i)
+                {
+                    setB<real_t>(B,F,grad);
+                    sink += B(0,0);
+                }
+            },reps));
+        if (report.selected("voigtStress"))
+            report.add("kernel","voigtStress",params,0,numCalls,"call",reps,bestTime([&]()
+            {
+                for (index_t i = 0; i < numCalls; ++i)
+                {
+                    voigtStress<real_t>(Svec,RCG);
+                    sink += Svec(0);
+                }
+            },reps));
+        if (sink == std::numeric_limits<real_t>::max())
+            gsInfo << sink << "\n";
+    }
+}
+
+/// bijectivity checks of a deformed configuration by sampling and by Bezier coefficients
+void benchBijectivity(benchReport & report, index_t reps, index_t numUniRef2D, index_t numUniRef3D)
+{
+    for (short_t dim = 2; dim <= 3; ++dim)
+    {
+        gsMultiPatch<> domain;
+        gsMultiBasis<> basis;
+        unitDomain(dim,2,dim == 2 ? numUniRef2D : numUniRef3D,domain,basis);
+        gsVector<> zeroVector(dim);
+        zeroVector.setZero();
+        gsConstantFunction<> force(zeroVector,dim);
+        gsBoundaryConditions<> bc;
+        gsElasticityAssembler<real_t> assembler(domain,basis,bc,force);
+        gsMultiPatch<> displacement;
+        assembler.constructSolution(perturbation(assembler.numDofs(),1e-2),assembler.allFixedDofs(),displacement);
+        const std::string params = util::to_string(dim) + "D_p2";
+
+        if (report.selected("checkDisplacement sampling"))
+            report.add("bijectivity","checkDisplacement sampling",params,assembler.numDofs(),basis.totalElements(),"element",reps,
+                       bestTime([&](){ checkDisplacement(domain,displacement,bijectivity_check::sampling); },reps));
+        if (report.selected("checkDisplacement bezier"))
+            report.add("bijectivity","checkDisplacement bezier",params,assembler.numDofs(),basis.totalElements(),"element",reps,
+                       bestTime([&](){ checkDisplacement(domain,displacement,bijectivity_check::bezier); },reps));
+    }
+}
+
+/// sampling of a displacement field on the output grid and writing of a Paraview file
+void benchOutput(benchReport & report, index_t reps, index_t numPoints)
+{
+    for (short_t dim = 2; dim <= 3; ++dim)
+    {
+        gsMultiPatch<> domain;
+        gsMultiBasis<> basis;
+        unitDomain(dim,2,dim == 2 ? 4 : 2,domain,basis);
+        gsVector<> zeroVector(dim);
+        zeroVector.setZero();
+        gsConstantFunction<> force(zeroVector,dim);
+        gsBoundaryConditions<> bc;
+        gsElasticityAssembler<real_t> assembler(domain,basis,bc,force);
+        gsMultiPatch<> displacement;
+        assembler.constructSolution(perturbation(assembler.numDofs()),assembler.allFixedDofs(),displacement);
+        const std::string params = util::to_string(dim) + "D_p2";
+
+        gsMatrix<> ab = domain.patch(0).support();
+        gsVector<unsigned> np = uniformSampleCount(ab.col(0),ab.col(1),numPoints);
+        gsMatrix<> points = gsPointGrid(ab.col(0),ab.col(1),np);
+        gsMatrix<> values, derivs;
+
+        if (report.selected("grid evaluation"))
+        {
+            gsGridEvaluator<real_t> grid(points,np);
+            report.add("output","grid evaluation",params,assembler.numDofs(),points.cols(),"point",reps,bestTime([&]()
+            {
+                grid.eval_into(displacement.patch(0),values);
+                grid.jacobian_into(displacement.patch(0),derivs);
+            },reps));
+        }
+        if (report.selected("pointwise evaluation"))
+            report.add("output","pointwise evaluation",params,assembler.numDofs(),points.cols(),"point",reps,bestTime([&]()
+            {
+                displacement.patch(0).eval_into(points,values);
+                displacement.patch(0).deriv_into(points,derivs);
+            },reps));
+        if (report.selected("Paraview raw"))
+        {
+            gsField<> field(domain,displacement);
+            std::map<std::string,const gsField<> *> fields;
+            fields["Displacement"] = &field;
+            report.add("output","Paraview raw",params,assembler.numDofs(),points.cols(),"point",reps,bestTime([&]()
+            {
+                gsWriteParaviewMultiPhysics(fields,"gsElasticity_bench_output",numPoints,false,false,vtk_format::raw);
+            },reps));
+            // the written files are only a by-product of the measurement
+            std::remove("gsElasticity_bench_output.pvd");
+            for (index_t p = 0; p < (index_t)(domain.nPatches()); ++p)
+                std::remove(("gsElasticity_bench_output" + util::to_string(p) + ".vts").c_str());
+        }
+    }
+}
+
+//=====================================//
+        // End-to-end cases //
+//=====================================//
+
+/// Cook's membrane with the nonlinear neo-Hookean material (see cooks_nonLinElast2D)
+void runCooks(index_t numUniRef, index_t & numDofs)
+{
+    gsMultiPatch<> geometry;
+    gsReadFile<>(ELAST_DATA_DIR"/cooks.xml",geometry);
+    gsMultiBasis<> basis(geometry);
+    basis.degreeElevate();
+    for (index_t i = 0; i < numUniRef; ++i)
+        basis.uniformRefine();
+
+    gsConstantFunction<> f(0.,625e4,2);
+    gsConstantFunction<> g(0.,0.,2);
+    gsBoundaryConditions<> bcInfo;
+    for (index_t d = 0; d < 2; ++d)
+        bcInfo.addCondition(0,boundary::west,condition_type::dirichlet,nullptr,d);
+    bcInfo.addCondition(0,boundary::east,condition_type::neumann,&f);
+
+    gsElasticityAssembler<real_t> assembler(geometry,basis,bcInfo,g);
+    assembler.options().setReal("YoungsModulus",240.565e6);
+    assembler.options().setReal("PoissonsRatio",0.4);
+    assembler.options().setInt("MaterialLaw",material_law::neo_hooke_ln);
+    numDofs = assembler.numDofs();
+
+    gsIterative<real_t> solver(assembler);
+    solver.options().setInt("Verbosity",solver_verbosity::none);
+    solver.options().setInt("Solver",linear_solver::LDLT);
+    solver.solve();
+}
+
+/// Terrific part with linear elasticity (see terrific_linElast3D)
+void runTerrific(index_t numUniRef, index_t & numDofs)
+{
+    gsMultiPatch<> geometry;
+    gsReadFile<>(ELAST_DATA_DIR"/terrific.xml",geometry);
+    gsMultiBasis<> basis(geometry);
+    for (index_t i = 0; i < numUniRef; ++i)
+        basis.uniformRefine();
+
+    gsConstantFunction<> f(0.,0.,0.,3);
+    gsConstantFunction<> g(20e6,-14e6,0,3);
+    gsBoundaryConditions<> bcInfo;
+    for (index_t d = 0; d < 3; d++)
+    {
+        bcInfo.addCondition(0,boundary::back,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(1,boundary::back,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(2,boundary::south,condition_type::dirichlet,0,d);
+    }
+    bcInfo.addCondition(13,boundary::front,condition_type::neumann,&g);
+    bcInfo.addCondition(14,boundary::north,condition_type::neumann,&g);
+
+    gsElasticityAssembler<real_t> assembler(geometry,basis,bcInfo,f);
+    assembler.options().setReal("YoungsModulus",74e9);
+    assembler.options().setReal("PoissonsRatio",0.33);
+    assembler.options().setInt("DirichletValues",dirichlet::l2Projection);
+    assembler.assemble();
+    numDofs = assembler.numDofs();
+
+#ifdef GISMO_WITH_PARDISO
+    gsSparseSolver<>::PardisoLDLT solver;
+#else
+    gsSparseSolver<>::SimplicialLDLT solver;
+#endif
+    gsProfiledFactorize(solver,assembler.matrix());
+    gsVector<> solVector = gsProfiledSolve(solver,assembler.rhs());
+}
+
+/// stationary deflection of the elastic beam (see flappingBeam_CSM1_nonLinElast2D)
+void runCSM1(index_t numUniRef, index_t & numDofs)
+{
+    gsMultiPatch<> geometry;
+    gsReadFile<>(ELAST_DATA_DIR"/flappingBeam_beam.xml",geometry);
+    gsMultiBasis<> basis(geometry);
+    for (index_t i = 0; i < numUniRef; ++i)
+        basis.uniformRefine();
+
+    gsBoundaryConditions<> bcInfo;
+    bcInfo.addCondition(0,boundary::west,condition_type::dirichlet,0,0);
+    bcInfo.addCondition(0,boundary::west,condition_type::dirichlet,0,1);
+    gsConstantFunction<> gravity(0.,2.*1.0e3,2);
+
+    gsElasticityAssembler<real_t> assembler(geometry,basis,bcInfo,gravity);
+    assembler.options().setReal("YoungsModulus",1.4e6);
+    assembler.options().setReal("PoissonsRatio",0.4);
+    assembler.options().setInt("MaterialLaw",material_law::saint_venant_kirchhoff);
+    numDofs = assembler.numDofs();
+
+    gsIterative<real_t> solver(assembler);
+    solver.options().setInt("Verbosity",solver_verbosity::none);
+    solver.options().setInt("Solver",linear_solver::LDLT);
+    solver.solve();
+}
+
+/// no-slip walls of the flow domain of the flapping beam benchmarks
+void flowWalls(gsBoundaryConditions<> & bcInfo)
+{
+    for (index_t d = 0; d < 2; ++d)
+    {
+        bcInfo.addCondition(0,boundary::east,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(1,boundary::south,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(1,boundary::north,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(2,boundary::south,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(2,boundary::north,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(3,boundary::south,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(3,boundary::north,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(4,boundary::south,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(4,boundary::north,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(5,boundary::west,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(6,boundary::south,condition_type::dirichlet,0,d);
+        bcInfo.addCondition(6,boundary::north,condition_type::dirichlet,0,d);
+    }
+}
+
+/// steady-state flow around the rigid beam with subgrid elements (see flappingBeam_CFD1_NS2D)
+void runCFD1(index_t numUniRef, index_t & numDofs)
+{
+    gsMultiPatch<> geometry;
+    gsReadFile<>(ELAST_DATA_DIR"/flappingBeam_flow.xml",geometry);
+    gsMultiBasis<> basisVelocity(geometry);
+    gsMultiBasis<> basisPressure(geometry);
+    for (index_t i = 0; i < numUniRef; ++i)
+    {
+        basisVelocity.uniformRefine();
+        basisPressure.uniformRefine();
+    }
+    basisVelocity.uniformRefine();
+
+    gsFunctionExpr<> inflow("0.2*6*y*(0.41-y)/0.41^2",2);
+    gsBoundaryConditions<> bcInfo;
+    bcInfo.addCondition(0,boundary::west,condition_type::dirichlet,&inflow,0);
+    bcInfo.addCondition(0,boundary::west,condition_type::dirichlet,0,1);
+    flowWalls(bcInfo);
+    gsConstantFunction<> g(0.,0.,2);
+
+    gsNsAssembler<real_t> assembler(geometry,basisVelocity,basisPressure,bcInfo,g);
+    assembler.options().setReal("Viscosity",0.001);
+    assembler.options().setReal("Density",1.0e3);
+    assembler.options().setInt("DirichletValues",dirichlet::interpolation);
+    assembler.options().setInt("Assembly",ns_assembly::newton_next);
+    numDofs = assembler.numDofs();
+
+    gsIterative<real_t> solver(assembler);
+    solver.options().setInt("Verbosity",solver_verbosity::none);
+    solver.options().setInt("Solver",linear_solver::LU);
+    solver.options().setInt("IterType",iteration_type::next);
+    solver.solve();
+}
+
+/// first time steps of the two-way coupled flapping beam (see flappingBeam_FSI2_coupledTime2D)
+void runFSI2(index_t numUniRef, index_t numSteps, index_t & numDofs)
+{
+    const real_t viscosity = 0.001;
+    const real_t densityFluid = 1.0e3;
+    const real_t timeStep = 0.01;
+
+    gsMultiPatch<> geoFlow;
+    gsReadFile<>(ELAST_DATA_DIR"/flappingBeam_flow.xml",geoFlow);
+    gsMultiPatch<> geoBeam;
+    gsReadFile<>(ELAST_DATA_DIR"/flappingBeam_beam.xml",geoBeam);
+    gsMultiPatch<> geoALE;
+    for (index_t p = 0; p < 3; ++p)
+        geoALE.addPatch(geoFlow.patch(p+3).clone());
+    geoALE.computeTopology();
+
+    gsMultiBasis<> basisDisplacement(geoBeam);
+    for (index_t i = 0; i < numUniRef; ++i)
+    {
+        basisDisplacement.uniformRefine();
+        geoFlow.uniformRefine();
+        geoALE.uniformRefine();
+    }
+    gsMultiBasis<> basisPressure(geoFlow);
+    basisDisplacement.uniformRefine();
+    geoALE.uniformRefine();
+    geoFlow.uniformRefine();
+    gsMultiBasis<> basisVelocity(geoFlow);
+
+    gsConstantFunction<> gZero(0.,0.,2);
+    gsFunctionExpr<> inflow("6*y*(0.41-y)/0.41^2",2);
+
+    gsMultiPatch<> velFlow, presFlow, dispBeam, dispALE, velALE;
+    gsBoundaryConditions<> bcInfoFlow;
+    bcInfoFlow.addCondition(0,boundary::west,condition_type::dirichlet,&inflow,0);
+    bcInfoFlow.addCondition(0,boundary::west,condition_type::dirichlet,0,1);
+    flowWalls(bcInfoFlow);
+    gsBoundaryConditions<> bcInfoBeam;
+    for (index_t d = 0; d < 2; ++d)
+        bcInfoBeam.addCondition(0,boundary::west,condition_type::dirichlet,0,d);
+    gsFsiLoad<real_t> fSouth(geoALE,dispALE,1,boundary::north,velFlow,presFlow,4,viscosity,densityFluid);
+    gsFsiLoad<real_t> fEast(geoALE,dispALE,2,boundary::west,velFlow,presFlow,5,viscosity,densityFluid);
+    gsFsiLoad<real_t> fNorth(geoALE,dispALE,0,boundary::south,velFlow,presFlow,3,viscosity,densityFluid);
+    bcInfoBeam.addCondition(0,boundary::south,condition_type::neumann,&fSouth);
+    bcInfoBeam.addCondition(0,boundary::east,condition_type::neumann,&fEast);
+    bcInfoBeam.addCondition(0,boundary::north,condition_type::neumann,&fNorth);
+
+    gsBoundaryInterface interfaceBeam2ALE;
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::north,0,boundary::south);
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::south,1,boundary::north);
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::east,2,boundary::west);
+    gsBoundaryInterface interfaceALE2Flow;
+    interfaceALE2Flow.addInterfaceSide(0,boundary::south,3,boundary::south);
+    interfaceALE2Flow.addInterfaceSide(1,boundary::north,4,boundary::north);
+    interfaceALE2Flow.addInterfaceSide(2,boundary::west,5,boundary::west);
+    interfaceALE2Flow.addPatches(0,3);
+    interfaceALE2Flow.addPatches(1,4);
+    interfaceALE2Flow.addPatches(2,5);
+
+    gsNsAssembler<real_t> nsAssembler(geoFlow,basisVelocity,basisPressure,bcInfoFlow,gZero);
+    nsAssembler.options().setReal("Viscosity",viscosity);
+    nsAssembler.options().setReal("Density",densityFluid);
+    gsMassAssembler<real_t> nsMassAssembler(geoFlow,basisVelocity,bcInfoFlow,gZero);
+    nsMassAssembler.options().setReal("Density",densityFluid);
+    gsNsTimeIntegrator<real_t> nsTimeSolver(nsAssembler,nsMassAssembler,&velALE,&interfaceALE2Flow);
+    nsTimeSolver.options().setInt("Scheme",time_integration::implicit_linear);
+    nsTimeSolver.options().setReal("Theta",0.5);
+    nsTimeSolver.options().setSwitch("ALE",true);
+    gsElasticityAssembler<real_t> elAssembler(geoBeam,basisDisplacement,bcInfoBeam,gZero);
+    elAssembler.options().setReal("YoungsModulus",1.4e6);
+    elAssembler.options().setReal("PoissonsRatio",0.4);
+    elAssembler.options().setInt("MaterialLaw",material_law::saint_venant_kirchhoff);
+    gsMassAssembler<real_t> elMassAssembler(geoBeam,basisDisplacement,bcInfoBeam,gZero);
+    elMassAssembler.options().setReal("Density",1.0e4);
+    gsElTimeIntegrator<real_t> elTimeSolver(elAssembler,elMassAssembler);
+    elTimeSolver.options().setInt("Scheme",time_integration::implicit_nonlinear);
+    gsALE<real_t> moduleALE(geoALE,dispBeam,interfaceBeam2ALE,ale_method::TINE);
+    moduleALE.options().setReal("LocalStiff",2.5);
+    moduleALE.options().setReal("PoissonsRatio",0.4);
+    moduleALE.options().setSwitch("Check",true);
+    gsPartitionedFSI<real_t> moduleFSI(nsTimeSolver,velFlow,presFlow,elTimeSolver,dispBeam,moduleALE,dispALE,velALE);
+    moduleFSI.options().setInt("MaxIter",10);
+    moduleFSI.options().setReal("AbsTol",1e-10);
+    moduleFSI.options().setReal("RelTol",1e-6);
+    numDofs = nsAssembler.numDofs() + elAssembler.numDofs() + moduleALE.numDofs();
+
+    gsMatrix<> inflowDDoFs;
+    nsAssembler.getFixedDofs(0,boundary::west,inflowDDoFs);
+    nsAssembler.homogenizeFixedDofs(-1);
+    nsTimeSolver.setSolutionVector(gsMatrix<>::Zero(nsAssembler.numDofs(),1));
+    nsTimeSolver.setFixedDofs(nsAssembler.allFixedDofs());
+    elTimeSolver.setDisplacementVector(gsMatrix<>::Zero(elAssembler.numDofs(),1));
+    elTimeSolver.setVelocityVector(gsMatrix<>::Zero(elAssembler.numDofs(),1));
+    nsAssembler.constructSolution(nsTimeSolver.solutionVector(),nsTimeSolver.allFixedDofs(),velFlow,presFlow);
+    elAssembler.constructSolution(elTimeSolver.displacementVector(),elTimeSolver.allFixedDofs(),dispBeam);
+    moduleALE.constructSolution(dispALE);
+
+    // the inflow is ramped up as in the example
+    real_t simTime = 0.;
+    for (index_t step = 0; step < numSteps; ++step)
+    {
+        nsAssembler.setFixedDofs(0,boundary::west,inflowDDoFs*(1-cos(M_PI*(simTime+timeStep)/2.))/2);
+        if (!moduleFSI.makeTimeStep(timeStep))
+        {
+            gsWarn << "Invalid ALE mapping in the FSI2 benchmark.\n";
+            break;
+        }
+        simTime += timeStep;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    gsInfo << "This is the benchmark suite of gsElasticity.\n";
+
+    //=====================================//
+                // Input //
+    //=====================================//
+
+    std::string output = "gsElasticity_bench";
+    std::string baseline = "";
+    std::string filter = "";
+    real_t tolerance = 0.1;
+    index_t reps = 3;
+    index_t maxDegree = 3;
+    index_t numLevels = 2;
+    index_t numSteps = 5;
+    index_t numPoints = 100000;
+    bool onlyMicro = false;
+    bool onlyEndToEnd = false;
+
+    // minimalistic user interface for terminal
+    gsCmdLine cmd("This is the benchmark suite of gsElasticity.");
+    cmd.addString("o","output","Prefix of the CSV and JSON result files",output);
+    cmd.addString("b","baseline","CSV file of a previous run to compare with",baseline);
+    cmd.addReal("t","tolerance","Relative slowdown with respect to the baseline reported as a regression",tolerance);
+    cmd.addString("c","case","Run only the cases whose name contains this string",filter);
+    cmd.addInt("n","reps","Number of repetitions of each case; the best time is reported",reps);
+    cmd.addInt("d","degree","Maximal degree of the visitor microbenchmarks",maxDegree);
+    cmd.addInt("l","levels","Number of refinement levels of the end-to-end sweeps",numLevels);
+    cmd.addInt("s","steps","Number of time steps of the FSI case",numSteps);
+    cmd.addInt("p","points","Number of points of the output microbenchmarks",numPoints);
+    cmd.addSwitch("m","micro","Run only the microbenchmarks",onlyMicro);
+    cmd.addSwitch("e","endtoend","Run only the end-to-end cases",onlyEndToEnd);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    index_t numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    gsInfo << "Running with " << numThreads << " thread(s), best of " << reps << " repetition(s).\n\n";
+
+    benchReport report(filter,numThreads);
+
+    //=====================================//
+            // Microbenchmarks //
+    //=====================================//
+
+    if (!onlyEndToEnd)
+    {
+        benchVisitors(report,reps,maxDegree,4,3);
+        benchTensorKernels(report,reps,100000);
+        benchBijectivity(report,reps,4,2);
+        benchOutput(report,reps,numPoints);
+    }
+
+    //=====================================//
+            // End-to-end cases //
+    //=====================================//
+
+    if (!onlyMicro)
+    {
+        // refinement sweeps start at the coarsest meaningful level of each case
+        index_t numDofs = 0;
+        for (index_t l = 0; l < numLevels; ++l)
+        {
+            const std::string params = "r" + util::to_string(2+l);
+            if (report.selected("cooks"))
+            {
+                const real_t time = bestTime([&](){ runCooks(2+l,numDofs); },reps);
+                report.add("endtoend","cooks",params,numDofs,1,"run",reps,time);
+            }
+            if (report.selected("terrific"))
+            {
+                const real_t time = bestTime([&](){ runTerrific(l,numDofs); },reps);
+                report.add("endtoend","terrific","r" + util::to_string(l),numDofs,1,"run",reps,time);
+            }
+            if (report.selected("flappingBeam CSM1"))
+            {
+                const real_t time = bestTime([&](){ runCSM1(2+l,numDofs); },reps);
+                report.add("endtoend","flappingBeam CSM1",params,numDofs,1,"run",reps,time);
+            }
+            if (report.selected("flappingBeam CFD1"))
+            {
+                const real_t time = bestTime([&](){ runCFD1(1+l,numDofs); },reps);
+                report.add("endtoend","flappingBeam CFD1","r" + util::to_string(1+l),numDofs,1,"run",reps,time);
+            }
+            if (report.selected("flappingBeam FSI2"))
+            {
+                const real_t time = bestTime([&](){ runFSI2(1+l,numSteps,numDofs); },reps);
+                report.add("endtoend","flappingBeam FSI2","r" + util::to_string(1+l),numDofs,numSteps,"step",reps,time);
+            }
+        }
+    }
+
+    //=====================================//
+                // Output //
+    //=====================================//
+
+    report.writeCSV(output + ".csv");
+    report.writeJSON(output + ".json");
+    gsInfo << "\nResults written to \"" << output << ".csv\" and \"" << output << ".json\".\n";
+
+    if (!baseline.empty() && report.compare(baseline,tolerance) > 0)
+        return 1;
+    return 0;
+}
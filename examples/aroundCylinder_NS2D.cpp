@@ -4,8 +4,11 @@
 /// Author: A.Shamanskiy (2016 - ...., TU Kaiserslautern)
 #include <gismo.h>
 #include <gsElasticity/gsNsAssembler.h>
+#include <gsElasticity/gsMassAssembler.h>
+#include <gsElasticity/gsNsPseudoTransient.h>
 #include <gsElasticity/gsIterative.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsDiscretizationCache.h>
 
 using namespace gismo;
 
@@ -36,9 +39,13 @@ int main(int argc, char* argv[]){
     index_t numDegElev = 0;
     index_t numBLRef = 1;
     bool subgridOrTaylorHood = false;
+    bool useCache = false;
     // output
     index_t numPlotPoints = 10000;
     bool plotMesh = false;
+    // nonlinear solver
+    index_t andersonDepth = 0;
+    bool usePTC = false;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("Testing the Stokes solver in 2D.");
@@ -48,6 +55,9 @@ int main(int argc, char* argv[]){
     cmd.addSwitch("e","element","Mixed element: false = subgrid (default), true = Taylor-Hood",subgridOrTaylorHood);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
     cmd.addSwitch("m","mesh","Plot computational mesh",plotMesh);
+    cmd.addInt("a","anderson","Depth of Anderson-accelerated Oseen iterations; 0 - Newton's method",andersonDepth);
+    cmd.addSwitch("t","ptc","Use pseudo-transient continuation",usePTC);
+    cmd.addSwitch("k","cache","Store the refined discretization in a binary file and reuse it in the next runs",useCache);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
     gsInfo << "Using " << (subgridOrTaylorHood ? "Taylor-Hood " : "subgrid ") << "mixed elements.\n";
 
@@ -55,31 +65,42 @@ int main(int argc, char* argv[]){
         // Scanning geometry and creating bases //
     //=============================================//
 
-    // scanning geometry
     gsMultiPatch<> geometry;
-    gsReadFile<>(filename, geometry);
-
-    // creating bases
-    gsMultiBasis<> basisVelocity(geometry);
-    gsMultiBasis<> basisPressure(geometry);
-    for (index_t i = 0; i < numDegElev; ++i)
-    {
-        basisVelocity.degreeElevate();
-        basisPressure.degreeElevate();
-    }
-    for (index_t i = 0; i < numUniRef; ++i)
+    gsMultiBasis<> basisVelocity, basisPressure;
+    // the cache hashes the geometry file, so it is only created if requested
+    std::unique_ptr<gsDiscretizationCache<real_t> > cache;
+    if (useCache)
+        cache.reset(new gsDiscretizationCache<real_t>(filename,"d" + util::to_string(numDegElev) + "_r" + util::to_string(numUniRef) +
+                                                      "_l" + util::to_string(numBLRef) + (subgridOrTaylorHood ? "_th" : "_sg")));
+    if (!cache || !cache->load(geometry,{&basisVelocity,&basisPressure}))
     {
-        basisVelocity.uniformRefine();
-        basisPressure.uniformRefine();
+        // scanning geometry
+        gsReadFile<>(filename, geometry);
+
+        // creating bases
+        basisVelocity = gsMultiBasis<>(geometry);
+        basisPressure = gsMultiBasis<>(geometry);
+        for (index_t i = 0; i < numDegElev; ++i)
+        {
+            basisVelocity.degreeElevate();
+            basisPressure.degreeElevate();
+        }
+        for (index_t i = 0; i < numUniRef; ++i)
+        {
+            basisVelocity.uniformRefine();
+            basisPressure.uniformRefine();
+        }
+        // additional refinement of the boundary layer around the cylinder
+        for (index_t i = 0; i < numBLRef; ++i)
+            refineBoundaryLayer(basisVelocity,basisPressure);
+        // additional velocity refinement for stable mixed FEM
+        if (!subgridOrTaylorHood) // subgrid
+            basisVelocity.uniformRefine();
+        else // Taylor-Hood
+            basisVelocity.degreeElevate();
+        if (cache)
+            cache->save(geometry,{&basisVelocity,&basisPressure});
     }
-    // additional refinement of the boundary layer around the cylinder
-    for (index_t i = 0; i < numBLRef; ++i)
-        refineBoundaryLayer(basisVelocity,basisPressure);
-    // additional velocity refinement for stable mixed FEM
-    if (!subgridOrTaylorHood) // subgrid
-        basisVelocity.uniformRefine();
-    else // Taylor-Hood
-        basisVelocity.degreeElevate();
 
     //=============================================//
         // Setting loads and boundary conditions //
@@ -118,19 +139,26 @@ int main(int argc, char* argv[]){
     gsInfo << "Initialized system with " << assembler.numDofs() << " dofs.\n";
 
     // set assembly type: linear system for Newton's method in the next-solution form
-    assembler.options().setInt("Assembly",ns_assembly::newton_next);
+    // or the Oseen linearization for a fixed-point iteration
+    assembler.options().setInt("Assembly",andersonDepth > 0 ? ns_assembly::ossen : ns_assembly::newton_next);
+    // velocity mass matrix for pseudo-transient continuation
+    gsMassAssembler<real_t> massAssembler(geometry,basisVelocity,bcInfo,g);
+    massAssembler.options().setReal("Density",density);
+    gsNsPseudoTransient<real_t> ptcAssembler(assembler,massAssembler);
     // setting Newton's method
-    gsIterative<real_t> solver(assembler);
+    gsIterative<real_t> solver(usePTC ? static_cast<gsBaseAssembler<real_t> &>(ptcAssembler) : assembler);
     solver.options().setInt("Verbosity",solver_verbosity::all);
     solver.options().setInt("Solver",linear_solver::LU);
     // set iterative solver mode: each iteration yields an update to the solution
-    solver.options().setInt("IterType",iteration_type::next);
+    solver.options().setInt("IterType",usePTC ? iteration_type::update : iteration_type::next);
+    solver.options().setInt("AndersonDepth",andersonDepth);
 
     gsInfo << "Solving...\n";
     gsStopwatch clock;
     clock.restart();
     solver.solve();
-    gsInfo << "Solved the system in " << clock.stop() <<"s.\n";
+    gsInfo << "Solved the system in " << clock.stop() << "s with " << solver.numberIterations()
+           << (usePTC ? " pseudo-transient" : andersonDepth > 0 ? " Anderson-accelerated Oseen" : " Newton's") << " iterations.\n";
 
     //=============================================//
                       // Output //
@@ -75,6 +75,7 @@ int main(int argc, char* argv[]){
     real_t timeStep = 0.01;
     real_t theta = 0.5;
     bool imexOrNewton = false;
+    bool bdf2 = false;
     bool warmUp = false;
     // output
     index_t numPlotPoints = 900;
@@ -89,6 +90,7 @@ int main(int argc, char* argv[]){
     cmd.addReal("s","step","Time step, sec",timeStep);
     cmd.addReal("f","theta","Time integration parameter: 0 - exp.Euler, 1 - imp.Euler, 0.5 - Crank-Nicolson",theta);
     cmd.addSwitch("i","intergration","Time integration scheme: false = IMEX (default), true = Newton",imexOrNewton);
+    cmd.addSwitch("b","bdf2","Use the second-order BDF instead of the theta-scheme (IMEX: extrapolated convection)",bdf2);
     cmd.addSwitch("w","warmup","Use large time steps during the first 2 seconds",warmUp);
     cmd.addInt("p","points","Number of sampling points per patch for Paraview (0 = no plotting)",numPlotPoints);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
@@ -165,7 +167,10 @@ int main(int argc, char* argv[]){
 
     // creating time integrator
     gsNsTimeIntegrator<real_t> timeSolver(assembler,massAssembler);
-    timeSolver.options().setInt("Scheme",imexOrNewton ? time_integration::implicit_nonlinear : time_integration::implicit_linear);
+    if (bdf2)
+        timeSolver.options().setInt("Scheme",imexOrNewton ? time_integration::bdf2 : time_integration::imex_bdf2);
+    else
+        timeSolver.options().setInt("Scheme",imexOrNewton ? time_integration::implicit_nonlinear : time_integration::implicit_linear);
     timeSolver.options().setReal("Theta",theta);
 
     //=============================================//
@@ -24,6 +24,7 @@ int main(int argc, char* argv[]){
     index_t numUniRef = 4;
     index_t numDegElev = 1;
     index_t numPlotPoints = 10000;
+    index_t globalization = newton_globalization::none;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("This is Cook's membrane benchmark with nonlinear elasticity solver.");
@@ -31,6 +32,7 @@ int main(int argc, char* argv[]){
     cmd.addInt("r","refine","Number of uniform refinement application",numUniRef);
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addInt("s","point","Number of points to plot to Paraview",numPlotPoints);
+    cmd.addInt("g","glob","Globalization of Newton's method: 0 - none, 1 - line search, 2 - trust region",globalization);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
     //=============================================//
@@ -78,6 +80,7 @@ int main(int argc, char* argv[]){
     gsIterative<real_t> solver(assembler);
     solver.options().setInt("Verbosity",solver_verbosity::all);
     solver.options().setInt("Solver",linear_solver::LDLT);
+    solver.options().setInt("Globalization",globalization);
 
     gsInfo << "Solving...\n";
     gsStopwatch clock;
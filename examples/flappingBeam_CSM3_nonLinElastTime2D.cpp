@@ -42,6 +42,7 @@ int main(int argc, char* argv[]){
     // time integration
     real_t timeSpan = 2;
     real_t timeStep = 0.01;
+    real_t rhoInf = -1.;
     // output
     index_t numPlotPoints = 1000;
 
@@ -52,6 +53,7 @@ int main(int argc, char* argv[]){
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addReal("t","time","Time span, sec",timeSpan);
     cmd.addReal("s","step","Time step, sec",timeStep);
+    cmd.addReal("g","genalpha","Spectral radius for the generalized-alpha scheme (negative = Newmark)",rhoInf);
     cmd.addInt("p","points","Number of sampling points to plot to Paraview",numPlotPoints);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
@@ -101,6 +103,7 @@ int main(int argc, char* argv[]){
     gsElTimeIntegrator<real_t> timeSolver(assembler,massAssembler);
     timeSolver.options().setInt("Scheme",time_integration::implicit_nonlinear);
     timeSolver.options().setInt("Verbosity",solver_verbosity::none);
+    timeSolver.options().setReal("SpectralRadius",rhoInf);
 
     //=============================================//
             // Setting output & auxilary//
@@ -11,7 +11,11 @@
 #include <gsElasticity/gsMassAssembler.h>
 #include <gsElasticity/gsALE.h>
 #include <gsElasticity/gsPartitionedFSI.h>
+#include <gsElasticity/gsFsiInterfaceLoad.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsAsyncParaviewWriter.h>
+#include <gsElasticity/gsXdmfCollection.h>
+#include <gsElasticity/gsCheckpoint.h>
 #include <gsElasticity/gsGeoUtils.h>
 
 using namespace gismo;
@@ -81,6 +85,7 @@ int main(int argc, char* argv[])
     index_t ALEmethod = ale_method::TINE;
     bool check = true;
     bool oneWay = false;
+    bool assembledLoad = false;
     // space discretization
     index_t numUniRef = 3;
     // time integration
@@ -88,12 +93,17 @@ int main(int argc, char* argv[])
     real_t timeSpan = 15.;
     real_t thetaFluid = 0.5;
     real_t thetaSolid = 1.;
+    real_t rhoInf = -1.;
     index_t maxCouplingIter = 10;
     bool imexOrNewton = false;
     bool warmUp = false;
     // output parameters
     index_t numPlotPoints = 0.;
+    bool xdmfOutput = false;
     index_t verbosity = 0;
+    // checkpoint/restart
+    index_t checkpointSteps = 0;
+    std::string restartFile = "";
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("Testing the two-way fluid-structure interaction solver in 2D.");
@@ -102,14 +112,19 @@ int main(int argc, char* argv[])
     cmd.addReal("x","chi","Local stiffening degree for ALE",meshStiff);
     cmd.addSwitch("c","check","Check bijectivity of the ALE displacement field",check);
     cmd.addSwitch("o","oneway","Run as a oneway coupled simulation: beam-to-flow",oneWay);
+    cmd.addSwitch("f","fsiload","Transfer the fluid load via an assembled interface vector instead of Neumann BCs",assembledLoad);
     cmd.addInt("a","ale","ALE mesh method: 0 - HE, 1 - IHE, 2 - LE, 3 - ILE, 4 - TINE, 5 - BHE",ALEmethod);
     cmd.addInt("r","refine","Number of uniform refinement applications",numUniRef);
     cmd.addReal("t","time","Time span, sec",timeSpan);
     cmd.addReal("s","step","Time step",timeStep);
     cmd.addInt("i","iter","Number of coupling iterations",maxCouplingIter);
     cmd.addSwitch("w","warmup","Use large time steps during the first 2 seconds",warmUp);
+    cmd.addReal("g","genalpha","Spectral radius for the generalized-alpha scheme in the solid (negative = Newmark)",rhoInf);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
+    cmd.addSwitch("e","xdmf","Write the output to single HDF5/XDMF files instead of Paraview collections",xdmfOutput);
     cmd.addInt("v","verbosity","Amount of info printed to the prompt: 0 - none, 1 - crucial, 2 - all",verbosity);
+    cmd.addInt("k","checkpoint","Write a checkpoint to \"flappingBeam_FSI2.ckpt\" every N time steps (0 - never)",checkpointSteps);
+    cmd.addString("u","restart","Continue the simulation from a checkpoint file",restartFile);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
     if (oneWay)
@@ -194,7 +209,7 @@ int main(int argc, char* argv[])
                             velFlow,presFlow,5,viscosity,densityFluid);
     gsFsiLoad<real_t> fNorth(geoALE,dispALE,0,boundary::south,
                              velFlow,presFlow,3,viscosity,densityFluid);
-    if (!oneWay)
+    if (!oneWay && !assembledLoad)
     {
         bcInfoBeam.addCondition(0,boundary::south,condition_type::neumann,&fSouth);
         bcInfoBeam.addCondition(0,boundary::east,condition_type::neumann,&fEast);
@@ -244,6 +259,7 @@ int main(int argc, char* argv[])
     elTimeSolver.options().setInt("Scheme",time_integration::implicit_nonlinear);
     elTimeSolver.options().setReal("Beta",thetaSolid/2);
     elTimeSolver.options().setReal("Gamma",thetaSolid);
+    elTimeSolver.options().setReal("SpectralRadius",rhoInf);
     gsInfo << "Initialized elasticity system with " << elAssembler.numDofs() << " dofs.\n";
     // mesh deformation module
     gsALE<real_t> moduleALE(geoALE,dispBeam,interfaceBeam2ALE,ale_method::method(ALEmethod));
@@ -259,6 +275,17 @@ int main(int argc, char* argv[])
     moduleFSI.options().setReal("AbsTol",1e-10);
     moduleFSI.options().setReal("RelTol",1e-6);
     moduleFSI.options().setInt("Verbosity",verbosity);
+    // alternative flow to beam interface: the fluid traction is integrated once per coupling iteration
+    // and transfered to the beam DoFs by a precomputed sparse matrix
+    gsFsiInterfaceLoad<real_t> interfaceLoad(elAssembler,geoALE,dispALE,velFlow,presFlow,viscosity,densityFluid);
+    interfaceLoad.addInterfaceSide(0,boundary::south,1,boundary::north,4);
+    interfaceLoad.addInterfaceSide(0,boundary::east,2,boundary::west,5);
+    interfaceLoad.addInterfaceSide(0,boundary::north,0,boundary::south,3);
+    if (!oneWay && assembledLoad)
+    {
+        elAssembler.setExternalLoad(&interfaceLoad.vector());
+        moduleFSI.setInterfaceLoad(&interfaceLoad);
+    }
 
     //=============================================//
              // Setting output and auxilary //
@@ -282,15 +309,15 @@ int main(int argc, char* argv[])
     fieldsBeam["von Mises"] = &stressField;
     std::map<std::string,const gsField<> *> fieldsALE;
     fieldsALE["ALE"] = &aleField;
-    // paraview collection of time steps
-    gsParaviewCollection collectionFlow("flappingBeam_FSI2_flow");
-    gsParaviewCollection collectionBeam("flappingBeam_FSI2_beam");
-    gsParaviewCollection collectionALE("flappingBeam_FSI2_ALE");
-
     std::ofstream logFile;
-    logFile.open("flappingBeam_FSI2.txt");
-    logFile << "# simTime drag lift presDiff dispAx dispAy aleNorm aleTime flowTime"
-            << " beamTime couplingIter flowIter beamIter omega resAbs resRel\n";
+    if (restartFile.empty())
+    {
+        logFile.open("flappingBeam_FSI2.txt");
+        logFile << "# simTime drag lift presDiff dispAx dispAy aleNorm aleTime flowTime"
+                << " beamTime couplingIter flowIter beamIter omega resAbs resRel\n";
+    }
+    else // a restarted simulation continues the log
+        logFile.open("flappingBeam_FSI2.txt",std::ios::app);
 
     gsProgressBar bar;
     gsStopwatch totalClock, iterClock;
@@ -317,20 +344,55 @@ int main(int argc, char* argv[])
     elAssembler.constructCauchyStresses(dispBeam,stresses,stress_components::von_mises);
     moduleALE.constructSolution(dispALE);
 
-    if (numPlotPoints > 0)
+    real_t simTime = 0.;
+    real_t numTimeStep = 0;
+    // the states of the solvers and the solution fields are overwritten by the checkpoint
+    if (!restartFile.empty())
+    {
+        gsCheckpointReader<real_t> checkpoint(restartFile);
+        checkpoint.read("simTime",simTime);
+        checkpoint.read("numTimeStep",numTimeStep);
+        moduleFSI.readCheckpoint(checkpoint);
+        gsInfo << "Restarted from \"" << restartFile << "\" at time " << simTime << ".\n";
+    }
+
+    // a restarted simulation writes new collections instead of overwriting the ones of the previous run
+    const std::string outputName = restartFile.empty() ? "flappingBeam_FSI2" :
+                                   "flappingBeam_FSI2_restart" + util::to_string(index_t(numTimeStep));
+    // paraview collection of time steps
+    gsParaviewCollection collectionFlow(outputName + "_flow");
+    gsParaviewCollection collectionBeam(outputName + "_beam");
+    gsParaviewCollection collectionALE(outputName + "_ALE");
+    // samples and writes the time steps in the background while the simulation continues
+    gsAsyncParaviewWriter<> outputWriter;
+    // alternative single-file output; only the ALE-deformed flow geometry is stored at every time step
+    std::unique_ptr<gsXdmfCollection<> > xdmfFlow, xdmfBeam, xdmfALE;
+    if (numPlotPoints > 0 && xdmfOutput)
+    {
+        xdmfFlow.reset(new gsXdmfCollection<>(outputName + "_flow"));
+        xdmfBeam.reset(new gsXdmfCollection<>(outputName + "_beam"));
+        xdmfALE.reset(new gsXdmfCollection<>(outputName + "_ALE"));
+    }
+
+    if (numPlotPoints > 0 && xdmfOutput)
+    {
+        xdmfFlow->addTimestep(fieldsFlow,simTime,numPlotPoints);
+        xdmfBeam->addTimestep(fieldsBeam,simTime,numPlotPoints);
+        xdmfALE->addTimestep(fieldsALE,simTime,numPlotPoints);
+    }
+    else if (numPlotPoints > 0)
     {
-        gsWriteParaviewMultiPhysicsTimeStep(fieldsFlow,"flappingBeam_FSI2_flow",collectionFlow,0,numPlotPoints);
-        gsWriteParaviewMultiPhysicsTimeStep(fieldsBeam,"flappingBeam_FSI2_beam",collectionBeam,0,numPlotPoints);
-        plotDeformation(geoALE,dispALE,"flappingBeam_FSI2_ALE",collectionALE,0);
+        outputWriter.push(fieldsFlow,outputName + "_flow",collectionFlow,numTimeStep,numPlotPoints);
+        outputWriter.push(fieldsBeam,outputName + "_beam",collectionBeam,numTimeStep,numPlotPoints);
+        outputWriter.push(fieldsALE,outputName + "_ALE",collectionALE,numTimeStep,numPlotPoints);
     }
-    writeLog(logFile,nsAssembler,velFlow,presFlow,dispBeam,geoALE,dispALE,0.,0.,0.,0.,0,0,0,1.,0.,0.);
+    if (restartFile.empty())
+        writeLog(logFile,nsAssembler,velFlow,presFlow,dispBeam,geoALE,dispALE,0.,0.,0.,0.,0,0,0,1.,0.,0.);
 
     //=============================================//
                    // Coupled simulation //
     //=============================================//
 
-    real_t simTime = 0.;
-    real_t numTimeStep = 0;
     real_t timeALE = 0.;
     real_t timeFlow = 0.;
     real_t timeBeam = 0.;
@@ -360,17 +422,31 @@ int main(int argc, char* argv[])
         timeFlow += moduleFSI.timeNS();
         numTimeStep++;
 
-        if (numPlotPoints > 0)
+        if (numPlotPoints > 0 && xdmfOutput)
         {
-            gsWriteParaviewMultiPhysicsTimeStep(fieldsFlow,"flappingBeam_FSI2_flow",collectionFlow,numTimeStep,numPlotPoints);
-            gsWriteParaviewMultiPhysicsTimeStep(fieldsBeam,"flappingBeam_FSI2_beam",collectionBeam,numTimeStep,numPlotPoints);
-            //gsWriteParaviewMultiPhysicsTimeStep(fieldsALE,"flappingBeam_FSI2_ALE",collectionALE,numTimeStep,numPlotPoints);
-            plotDeformation(geoALE,dispALE,"flappingBeam_FSI2_ALE",collectionALE,numTimeStep);
+            xdmfFlow->addTimestep(fieldsFlow,simTime,numPlotPoints);
+            xdmfBeam->addTimestep(fieldsBeam,simTime,numPlotPoints);
+            xdmfALE->addTimestep(fieldsALE,simTime,numPlotPoints);
+        }
+        else if (numPlotPoints > 0)
+        {
+            outputWriter.push(fieldsFlow,outputName + "_flow",collectionFlow,numTimeStep,numPlotPoints);
+            outputWriter.push(fieldsBeam,outputName + "_beam",collectionBeam,numTimeStep,numPlotPoints);
+            outputWriter.push(fieldsALE,outputName + "_ALE",collectionALE,numTimeStep,numPlotPoints);
         }
         writeLog(logFile,nsAssembler,velFlow,presFlow,dispBeam,geoALE,dispALE,
                  simTime,timeALE,timeFlow,timeBeam, moduleFSI.numberIterations(),
                  nsTimeSolver.numberIterations(),elTimeSolver.numberIterations(),
                  moduleFSI.aitkenOmega(),moduleFSI.residualNormAbs(),moduleFSI.residualNormRel());
+
+        if (checkpointSteps > 0 && index_t(numTimeStep) % checkpointSteps == 0)
+        {
+            gsCheckpointWriter<real_t> checkpoint("flappingBeam_FSI2.ckpt");
+            checkpoint.write("simTime",simTime);
+            checkpoint.write("numTimeStep",numTimeStep);
+            moduleFSI.writeCheckpoint(checkpoint);
+            checkpoint.close();
+        }
     }
 
     //=============================================//
@@ -382,12 +458,20 @@ int main(int argc, char* argv[])
            << ", flow time: " << secToHMS(timeFlow)
            << ", beam time: " << secToHMS(timeBeam) << std::endl;
 
-    if (numPlotPoints > 0)
+    if (numPlotPoints > 0 && xdmfOutput)
+    {
+        xdmfFlow->save();
+        xdmfBeam->save();
+        xdmfALE->save();
+        gsInfo << "Open \"" << outputName << "_*.xdmf\" in Paraview for visualization.\n";
+    }
+    else if (numPlotPoints > 0)
     {
+        outputWriter.flush();
         collectionFlow.save();
         collectionBeam.save();
         collectionALE.save();
-        gsInfo << "Open \"flappingBeam_FSI2_*.pvd\" in Paraview for visualization.\n";
+        gsInfo << "Open \"" << outputName << "_*.pvd\" in Paraview for visualization.\n";
     }
     logFile.close();
     gsInfo << "Log file created in \"flappingBeam_FSI2.txt\".\n";
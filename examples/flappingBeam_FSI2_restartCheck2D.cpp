@@ -0,0 +1,267 @@
+/// This is a reproducibility check of the checkpoint/restart of the partitioned FSI solver
+/// on the FSI2 benchmark (see flappingBeam_FSI2_coupledTime2D). The simulation is run for N time steps
+/// without interruption, then for N/2 time steps and restarted from the checkpoint for the remaining N/2.
+/// The final checkpoints of both runs must be identical byte for byte. The assembly runs
+/// on one thread since the parallel assembly sums element contributions in varying order.
+/// The program returns a non-zero exit code if the checkpoints differ.
+///
+/// Author: A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+#include <gismo.h>
+#include <gsElasticity/gsElasticityAssembler.h>
+#include <gsElasticity/gsElTimeIntegrator.h>
+#include <gsElasticity/gsNsAssembler.h>
+#include <gsElasticity/gsNsTimeIntegrator.h>
+#include <gsElasticity/gsMassAssembler.h>
+#include <gsElasticity/gsALE.h>
+#include <gsElasticity/gsPartitionedFSI.h>
+#include <gsElasticity/gsCheckpoint.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace gismo;
+
+/// runs the FSI2 benchmark from a checkpoint (or from the initial state if restartFile is empty)
+/// until numSteps time steps are made in total and writes the final state to checkpointFile
+void simulate(index_t numUniRef, index_t ALEmethod, real_t timeStep, index_t numSteps,
+              std::string const & restartFile, std::string const & checkpointFile)
+{
+    // beam parameters
+    std::string filenameBeam = ELAST_DATA_DIR"/flappingBeam_beam.xml";
+    real_t youngsModulus = 1.4e6;
+    real_t poissonsRatio = 0.4;
+    real_t densitySolid = 1.0e4;
+    // flow parameters
+    std::string filenameFlow = ELAST_DATA_DIR"/flappingBeam_flow.xml";
+    real_t viscosity = 0.001;
+    real_t meanVelocity = 1.;
+    real_t densityFluid = 1.0e3;
+
+    //=============================================//
+        // Scanning geometry and creating bases //
+    //=============================================//
+
+    gsMultiPatch<> geoFlow;
+    gsReadFile<>(filenameFlow, geoFlow);
+    gsMultiPatch<> geoBeam;
+    gsReadFile<>(filenameBeam, geoBeam);
+    gsMultiPatch<> geoALE;
+    for (index_t p = 0; p < 3; ++p)
+        geoALE.addPatch(geoFlow.patch(p+3).clone());
+    geoALE.computeTopology();
+
+    gsMultiBasis<> basisDisplacement(geoBeam);
+    for (index_t i = 0; i < numUniRef; ++i)
+    {
+        basisDisplacement.uniformRefine();
+        geoFlow.uniformRefine();
+        geoALE.uniformRefine();
+    }
+    gsMultiBasis<> basisPressure(geoFlow);
+    basisDisplacement.uniformRefine();
+    geoALE.uniformRefine();
+    geoFlow.uniformRefine();
+    gsMultiBasis<> basisVelocity(geoFlow);
+
+    //=============================================//
+        // Setting loads and boundary conditions //
+    //=============================================//
+
+    gsConstantFunction<> gZero(0.,0.,2);
+    gsFunctionExpr<> inflow(util::to_string(meanVelocity) + "*6*y*(0.41-y)/0.41^2",2);
+
+    gsMultiPatch<> velFlow, presFlow, dispBeam, dispALE, velALE;
+    // boundary conditions: flow
+    gsBoundaryConditions<> bcInfoFlow;
+    bcInfoFlow.addCondition(0,boundary::west,condition_type::dirichlet,&inflow,0);
+    bcInfoFlow.addCondition(0,boundary::west,condition_type::dirichlet,0,1);
+    for (index_t d = 0; d < 2; ++d)
+    {   // no slip conditions
+        bcInfoFlow.addCondition(0,boundary::east,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(1,boundary::south,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(1,boundary::north,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(2,boundary::south,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(2,boundary::north,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(3,boundary::south,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(3,boundary::north,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(4,boundary::south,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(4,boundary::north,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(5,boundary::west,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(6,boundary::south,condition_type::dirichlet,0,d);
+        bcInfoFlow.addCondition(6,boundary::north,condition_type::dirichlet,0,d);
+    }
+    // boundary conditions: beam
+    gsBoundaryConditions<> bcInfoBeam;
+    for (index_t d = 0; d < 2; ++d)
+        bcInfoBeam.addCondition(0,boundary::west,condition_type::dirichlet,0,d);
+    gsFsiLoad<real_t> fSouth(geoALE,dispALE,1,boundary::north,
+                             velFlow,presFlow,4,viscosity,densityFluid);
+    gsFsiLoad<real_t> fEast(geoALE,dispALE,2,boundary::west,
+                            velFlow,presFlow,5,viscosity,densityFluid);
+    gsFsiLoad<real_t> fNorth(geoALE,dispALE,0,boundary::south,
+                             velFlow,presFlow,3,viscosity,densityFluid);
+    bcInfoBeam.addCondition(0,boundary::south,condition_type::neumann,&fSouth);
+    bcInfoBeam.addCondition(0,boundary::east,condition_type::neumann,&fEast);
+    bcInfoBeam.addCondition(0,boundary::north,condition_type::neumann,&fNorth);
+
+    gsBoundaryInterface interfaceBeam2ALE;
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::north,0,boundary::south);
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::south,1,boundary::north);
+    interfaceBeam2ALE.addInterfaceSide(0,boundary::east,2,boundary::west);
+
+    gsBoundaryInterface interfaceALE2Flow;
+    interfaceALE2Flow.addInterfaceSide(0,boundary::south,3,boundary::south);
+    interfaceALE2Flow.addInterfaceSide(1,boundary::north,4,boundary::north);
+    interfaceALE2Flow.addInterfaceSide(2,boundary::west,5,boundary::west);
+    interfaceALE2Flow.addPatches(0,3);
+    interfaceALE2Flow.addPatches(1,4);
+    interfaceALE2Flow.addPatches(2,5);
+
+    //=============================================//
+          // Setting assemblers and solvers //
+    //=============================================//
+
+    gsNsAssembler<real_t> nsAssembler(geoFlow,basisVelocity,basisPressure,bcInfoFlow,gZero);
+    nsAssembler.options().setReal("Viscosity",viscosity);
+    nsAssembler.options().setReal("Density",densityFluid);
+    gsMassAssembler<real_t> nsMassAssembler(geoFlow,basisVelocity,bcInfoFlow,gZero);
+    nsMassAssembler.options().setReal("Density",densityFluid);
+    gsNsTimeIntegrator<real_t> nsTimeSolver(nsAssembler,nsMassAssembler,&velALE,&interfaceALE2Flow);
+    nsTimeSolver.options().setInt("Scheme",time_integration::implicit_linear);
+    nsTimeSolver.options().setReal("Theta",0.5);
+    nsTimeSolver.options().setSwitch("ALE",true);
+    gsElasticityAssembler<real_t> elAssembler(geoBeam,basisDisplacement,bcInfoBeam,gZero);
+    elAssembler.options().setReal("YoungsModulus",youngsModulus);
+    elAssembler.options().setReal("PoissonsRatio",poissonsRatio);
+    elAssembler.options().setInt("MaterialLaw",material_law::saint_venant_kirchhoff);
+    gsMassAssembler<real_t> elMassAssembler(geoBeam,basisDisplacement,bcInfoBeam,gZero);
+    elMassAssembler.options().setReal("Density",densitySolid);
+    gsElTimeIntegrator<real_t> elTimeSolver(elAssembler,elMassAssembler);
+    elTimeSolver.options().setInt("Scheme",time_integration::implicit_nonlinear);
+    elTimeSolver.options().setReal("Beta",0.5);
+    elTimeSolver.options().setReal("Gamma",1.);
+    gsALE<real_t> moduleALE(geoALE,dispBeam,interfaceBeam2ALE,ale_method::method(ALEmethod));
+    moduleALE.options().setReal("LocalStiff",2.5);
+    moduleALE.options().setReal("PoissonsRatio",0.4);
+    gsPartitionedFSI<real_t> moduleFSI(nsTimeSolver,velFlow, presFlow,
+                                       elTimeSolver,dispBeam,
+                                       moduleALE,dispALE,velALE);
+    moduleFSI.options().setInt("MaxIter",10);
+    moduleFSI.options().setReal("AbsTol",1e-10);
+    moduleFSI.options().setReal("RelTol",1e-6);
+
+    //=============================================//
+                   // Initial condtions //
+    //=============================================//
+
+    gsMatrix<> inflowDDoFs;
+    nsAssembler.getFixedDofs(0,boundary::west,inflowDDoFs);
+    nsAssembler.homogenizeFixedDofs(-1);
+    nsTimeSolver.setSolutionVector(gsMatrix<>::Zero(nsAssembler.numDofs(),1));
+    nsTimeSolver.setFixedDofs(nsAssembler.allFixedDofs());
+    elTimeSolver.setDisplacementVector(gsMatrix<>::Zero(elAssembler.numDofs(),1));
+    elTimeSolver.setVelocityVector(gsMatrix<>::Zero(elAssembler.numDofs(),1));
+    nsAssembler.constructSolution(nsTimeSolver.solutionVector(),nsTimeSolver.allFixedDofs(),velFlow,presFlow);
+    elAssembler.constructSolution(elTimeSolver.displacementVector(),elTimeSolver.allFixedDofs(),dispBeam);
+    moduleALE.constructSolution(dispALE);
+
+    real_t simTime = 0.;
+    index_t numTimeStep = 0;
+    if (!restartFile.empty())
+    {
+        gsCheckpointReader<real_t> checkpoint(restartFile);
+        checkpoint.read("simTime",simTime);
+        checkpoint.read("numTimeStep",numTimeStep);
+        moduleFSI.readCheckpoint(checkpoint);
+    }
+
+    //=============================================//
+                   // Coupled simulation //
+    //=============================================//
+
+    // the time steps fall into the warm-up phase, so the inflow Dirichlet DoFs change at every step
+    while (numTimeStep < numSteps)
+    {
+        if (simTime < 2.)
+            nsAssembler.setFixedDofs(0,boundary::west,inflowDDoFs*(1-cos(M_PI*(simTime+timeStep)/2.))/2);
+        GISMO_ENSURE(moduleFSI.makeTimeStep(timeStep),"Invalid ALE mapping at time " + util::to_string(simTime));
+        simTime += timeStep;
+        ++numTimeStep;
+    }
+
+    gsCheckpointWriter<real_t> checkpoint(checkpointFile);
+    checkpoint.write("simTime",simTime);
+    checkpoint.write("numTimeStep",numTimeStep);
+    moduleFSI.writeCheckpoint(checkpoint);
+    checkpoint.close();
+}
+
+/// returns the offset of the first differing byte of two files or -1 if the files are identical
+index_t firstDifference(std::string const & fileA, std::string const & fileB)
+{
+    std::ifstream streamA(fileA.c_str(),std::ios::binary);
+    std::ifstream streamB(fileB.c_str(),std::ios::binary);
+    GISMO_ENSURE(streamA.good() && streamB.good(),"Cannot open " + fileA + " or " + fileB);
+    const std::string dataA((std::istreambuf_iterator<char>(streamA)),std::istreambuf_iterator<char>());
+    const std::string dataB((std::istreambuf_iterator<char>(streamB)),std::istreambuf_iterator<char>());
+    const size_t size = std::min(dataA.size(),dataB.size());
+    for (size_t i = 0; i < size; ++i)
+        if (dataA[i] != dataB[i])
+            return i;
+    return dataA.size() == dataB.size() ? -1 : index_t(size);
+}
+
+int main(int argc, char* argv[])
+{
+    gsInfo << "Checking that a restarted FSI simulation reproduces an uninterrupted one bit for bit.\n";
+
+    //=====================================//
+                // Input //
+    //=====================================//
+
+    index_t numUniRef = 1;
+    index_t ALEmethod = ale_method::TINE;
+    real_t timeStep = 0.01;
+    index_t numSteps = 10;
+
+    // minimalistic user interface for terminal
+    gsCmdLine cmd("Checking that a restarted FSI simulation reproduces an uninterrupted one bit for bit.");
+    cmd.addInt("r","refine","Number of uniform refinement applications",numUniRef);
+    cmd.addInt("a","ale","ALE mesh method: 0 - HE, 1 - IHE, 2 - LE, 3 - ILE, 4 - TINE, 5 - BHE",ALEmethod);
+    cmd.addReal("s","step","Time step",timeStep);
+    cmd.addInt("n","steps","Total number of time steps; the checkpoint is written after half of them",numSteps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    GISMO_ENSURE(numSteps >= 2,"At least two time steps are required.");
+
+#ifdef _OPENMP
+    // the guarantee holds for a deterministic assembly only
+    omp_set_num_threads(1);
+#endif
+
+    //=====================================//
+                // Running //
+    //=====================================//
+
+    gsStopwatch clock;
+    gsInfo << "Running " << numSteps << " time steps without interruption...\n";
+    simulate(numUniRef,ALEmethod,timeStep,numSteps,"","restartCheck_full.ckpt");
+    gsInfo << "Running " << numSteps/2 << " time steps and writing a checkpoint...\n";
+    simulate(numUniRef,ALEmethod,timeStep,numSteps/2,"","restartCheck_half.ckpt");
+    gsInfo << "Restarting from the checkpoint for " << numSteps - numSteps/2 << " time steps...\n";
+    simulate(numUniRef,ALEmethod,timeStep,numSteps,"restartCheck_half.ckpt","restartCheck_restarted.ckpt");
+    gsInfo << "Complete in " << clock.stop() << "s.\n";
+
+    //=====================================//
+                // Comparing //
+    //=====================================//
+
+    const index_t offset = firstDifference("restartCheck_full.ckpt","restartCheck_restarted.ckpt");
+    if (offset >= 0)
+    {
+        gsInfo << "FAILED: the final checkpoints differ starting from byte " << offset << ".\n";
+        return 1;
+    }
+    gsInfo << "Passed: the final checkpoints are identical.\n";
+    return 0;
+}
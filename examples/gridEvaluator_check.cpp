@@ -0,0 +1,107 @@
+/// This is a consistency check of the sum-factorized grid evaluation used for the Paraview output.
+/// Values and jacobians computed by gsGridEvaluator are compared with the pointwise evaluation
+/// of the geometry for a 2D NURBS patch, a 2D B-spline patch and a 3D B-spline patch.
+/// The program returns a non-zero exit code if the difference exceeds the tolerance.
+///
+/// Author: A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+#include <gismo.h>
+#include <gsElasticity/gsGridEvaluator.h>
+
+using namespace gismo;
+
+// returns the maximum difference between the grid and the pointwise evaluation
+real_t compare(const gsGeometry<> & geometry, index_t numPoints, real_t & gridTime, real_t & pointTime)
+{
+    gsMatrix<> ab = geometry.support();
+    gsVector<> a = ab.col(0);
+    gsVector<> b = ab.col(1);
+    gsVector<unsigned> np = uniformSampleCount(a,b,numPoints);
+    gsMatrix<> pts = gsPointGrid(a,b,np);
+    const index_t d = geometry.domainDim();
+
+    gsStopwatch clock;
+    gsGridEvaluator<real_t> grid(pts,np);
+    gsMatrix<> values, jacobians;
+    grid.eval_into(geometry,values);
+    grid.jacobian_into(geometry,jacobians);
+    gridTime = clock.stop();
+
+    clock.restart();
+    gsMatrix<> refValues = geometry.eval(pts);
+    gsMatrix<> refJacobians(geometry.targetDim(),d*pts.cols());
+    for (index_t q = 0; q < pts.cols(); ++q)
+        refJacobians.middleCols(q*d,d) = geometry.jacobian(pts.col(q));
+    pointTime = clock.stop();
+
+    return std::max((values-refValues).cwiseAbs().maxCoeff(),
+                    (jacobians-refJacobians).cwiseAbs().maxCoeff());
+}
+
+int main(int argc, char* argv[]){
+
+    gsInfo << "This is a consistency check of the grid evaluation of tensor-product patches.\n";
+
+    //=====================================//
+                // Input //
+    //=====================================//
+
+    std::string filename = ELAST_DATA_DIR"/cooks.xml";
+    index_t numUniRef = 3;
+    index_t numDegElev = 1;
+    index_t numPoints = 10000;
+    real_t tolerance = 1e-10;
+
+    // minimalistic user interface for terminal
+    gsCmdLine cmd("This is a consistency check of the grid evaluation of tensor-product patches.");
+    cmd.addInt("r","refine","Number of uniform refinement application",numUniRef);
+    cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
+    cmd.addInt("s","point","Number of grid points per patch",numPoints);
+    cmd.addReal("t","tol","Tolerance for the maximum difference",tolerance);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    //=============================================//
+                // Creating geometries //
+    //=============================================//
+
+    std::vector<std::pair<std::string,gsGeometry<>::uPtr> > patches;
+    // rational patch: values and jacobians use the quotient rule
+    gsGeometry<>::uPtr annulus(gsNurbsCreator<>::NurbsQuarterAnnulus());
+    patches.push_back(std::make_pair(std::string("2D NURBS quarter annulus"),give(annulus)));
+    // polynomial patch from file
+    gsMultiPatch<> cooks;
+    gsReadFile<>(filename,cooks);
+    patches.push_back(std::make_pair(std::string("2D B-spline Cook's membrane"),cooks.patch(0).clone()));
+    // 3D patch with perturbed control points
+    gsKnotVector<> kv(0.,1.,0,3);
+    gsTensorBSplineBasis<3,real_t> basis(kv,kv,kv);
+    gsMatrix<> coefs = basis.anchors().transpose();
+    coefs += 0.05*gsMatrix<>::Random(coefs.rows(),coefs.cols());
+    patches.push_back(std::make_pair(std::string("3D B-spline cube"),basis.makeGeometry(give(coefs))));
+
+    for (size_t p = 0; p < patches.size(); ++p)
+    {
+        for (index_t i = 0; i < numDegElev; ++i)
+            patches[p].second->degreeElevate();
+        for (index_t i = 0; i < numUniRef; ++i)
+            patches[p].second->uniformRefine();
+    }
+
+    //=====================================//
+                // Comparing //
+    //=====================================//
+
+    bool passed = true;
+    for (size_t p = 0; p < patches.size(); ++p)
+    {
+        GISMO_ENSURE(gsGridEvaluator<real_t>::applicable(patches[p].second->basis()),
+                     "The basis of " + patches[p].first + " is not tensor-product");
+        real_t gridTime, pointTime;
+        const real_t error = compare(*patches[p].second,numPoints,gridTime,pointTime);
+        passed = passed && error <= tolerance;
+        gsInfo << patches[p].first << ": max difference " << error
+               << (error <= tolerance ? " (passed)" : " (FAILED)")
+               << ", grid " << gridTime << "s, pointwise " << pointTime << "s.\n";
+    }
+
+    return passed ? 0 : 1;
+}
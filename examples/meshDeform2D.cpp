@@ -5,6 +5,7 @@
 #include <gsElasticity/gsGeoUtils.h>
 #include <gsElasticity/gsALE.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsDeformationPlotter.h>
 
 using namespace gismo;
 
@@ -82,8 +83,14 @@ int main(int argc, char* argv[])
              // Setting output and auxilary //
     //=============================================//
 
-    // container for displacements
-    std::vector<gsMultiPatch<> > displacements;
+    filename = filename.substr(filename.find_last_of("/\\")+1); // file name without a path
+    filename = filename.substr(0,filename.find_last_of(".\\")); // file name without an extension
+    filename = filename.substr(0,filename.find_last_of("_\\"));
+
+    // intermediate deformed meshes are plotted as soon as they are computed
+    gsDeformationPlotter<real_t> plotter(initGeo,filename,numPlotPoints);
+    plotter.addStep();
+    gsMultiPatch<> displacement;
     gsStopwatch clock;
     gsProgressBar bar;
 
@@ -114,37 +121,33 @@ int main(int argc, char* argv[])
     //=====================================//
 
     gsInfo << "Solving...\n";
-    clock.restart();
+    real_t compTime = 0.;
     for (index_t i = 0; i < numSteps; ++i)
     {
         bar.display(i+1,numSteps);
+        clock.restart();
         // deform mesh to match the current bdry displacement
         meshDeformer.updateMesh();
-        // save the displacement
-        displacements.push_back(gsMultiPatch<>());
-        meshDeformer.constructSolution(displacements.back());
+        meshDeformer.constructSolution(displacement);
+        compTime += clock.stop();
+        // plot the deformed mesh (not included in the solution time)
+        plotter.addStep(displacement);
         // increase the bdry displacement for the next step
         bdryDisplacement.patch(0).coefs() *= 1.*(i+2)/(i+1);
     }
 
-    gsInfo << "Solved in "<< clock.stop() <<"s.\n";
+    gsInfo << "Solved in "<< compTime <<"s.\n";
 
     //=====================================//
                 // Output //
     //=====================================//
 
-    filename = filename.substr(filename.find_last_of("/\\")+1); // file name without a path
-    filename = filename.substr(0,filename.find_last_of(".\\")); // file name without an extension
-    filename = filename.substr(0,filename.find_last_of("_\\"));
-
     // save initial domain
     gsInfo << "The initial domain is saved to \"" << filename << "_2D_init.xml\".\n";
     gsWrite(initGeo,filename + "_2D_init");
     // save resulting domain
     gsInfo << "The result of the deformation algorithm is saved to \"" << filename << "_2D.xml\".\n";
     gsWrite(initGeo,filename + "_2D");
-    // plotting all intermediate deformed meshes
-    plotDeformation(initGeo,displacements,filename,numPlotPoints);
     gsInfo << "Open \"" << filename << "_mesh.pvd\" in Paraview for visualization.\n";
 
     return 0;
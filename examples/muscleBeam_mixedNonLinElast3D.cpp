@@ -6,7 +6,9 @@
 #include <gismo.h>
 #include <gsElasticity/gsElasticityAssembler.h>
 #include <gsElasticity/gsIterative.h>
+#include <gsElasticity/gsContinuation.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsDiscretizationCache.h>
 
 using namespace gismo;
 
@@ -28,6 +30,8 @@ int main(int argc, char* argv[]){
     index_t numDegElev = 0;
     bool subgridOrTaylorHood = false;
     index_t numPlotPoints = 64000;
+    bool useContinuation = false;
+    bool useCache = false;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("This is a muscle fiber benchmark with mixed nonlinear elasticity solver.");
@@ -36,6 +40,8 @@ int main(int argc, char* argv[]){
     cmd.addInt("d","degelev","Number of degree elevation applications",numDegElev);
     cmd.addSwitch("e","element","True - subgrid, false - TH",subgridOrTaylorHood);
     cmd.addInt("s","points","Number of points to plot to Paraview",numPlotPoints);
+    cmd.addSwitch("c","continuation","Apply the load in adaptive load steps",useContinuation);
+    cmd.addSwitch("k","cache","Store the refined discretization in a binary file and reuse it in the next runs",useCache);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
     gsInfo << "Using " << (subgridOrTaylorHood ? "Taylor-Hood " : "subgrid ") << "mixed elements.\n";
 
@@ -43,34 +49,45 @@ int main(int argc, char* argv[]){
         // Scanning geometry and creating bases //
     //=============================================//
 
-    // scanning geometry
     gsMultiPatch<> geometry;
-    gsReadFile<>(filename, geometry);
-    geometry.computeTopology();
-
-    // creating bases
-    gsMultiBasis<> basisDisplacement(geometry);
-    gsMultiBasis<> basisPressure(geometry);
-    for (index_t i = 0; i < numDegElev; ++i)
-    {
-        basisDisplacement.degreeElevate();
-        basisPressure.degreeElevate();
-    }
-    for (index_t i = 0; i < numUniRef; ++i)
-    {
-        basisDisplacement.uniformRefine();
-        basisPressure.uniformRefine();
-    }
-    for (index_t i = 0; i < numUniRefDirX; ++i)
+    gsMultiBasis<> basisDisplacement, basisPressure;
+    // the cache hashes the geometry file, so it is only created if requested
+    std::unique_ptr<gsDiscretizationCache<real_t> > cache;
+    if (useCache)
+        cache.reset(new gsDiscretizationCache<real_t>(filename,"d" + util::to_string(numDegElev) + "_r" + util::to_string(numUniRef) +
+                                                      "_x" + util::to_string(numUniRefDirX) + (subgridOrTaylorHood ? "_th" : "_sg")));
+    if (!cache || !cache->load(geometry,{&basisDisplacement,&basisPressure}))
     {
-        static_cast<gsTensorNurbsBasis<3,real_t> &>(basisDisplacement.basis(0)).knots(0).uniformRefine();
-        static_cast<gsTensorNurbsBasis<3,real_t> &>(basisPressure.basis(0)).knots(0).uniformRefine();
+        // scanning geometry
+        gsReadFile<>(filename, geometry);
+        geometry.computeTopology();
+
+        // creating bases
+        basisDisplacement = gsMultiBasis<>(geometry);
+        basisPressure = gsMultiBasis<>(geometry);
+        for (index_t i = 0; i < numDegElev; ++i)
+        {
+            basisDisplacement.degreeElevate();
+            basisPressure.degreeElevate();
+        }
+        for (index_t i = 0; i < numUniRef; ++i)
+        {
+            basisDisplacement.uniformRefine();
+            basisPressure.uniformRefine();
+        }
+        for (index_t i = 0; i < numUniRefDirX; ++i)
+        {
+            static_cast<gsTensorNurbsBasis<3,real_t> &>(basisDisplacement.basis(0)).knots(0).uniformRefine();
+            static_cast<gsTensorNurbsBasis<3,real_t> &>(basisPressure.basis(0)).knots(0).uniformRefine();
+        }
+        // additional displacement refinement for stable mixed FEM
+        if (!subgridOrTaylorHood) // subgrid
+            basisDisplacement.uniformRefine();
+        else  // Taylor-Hood
+            basisDisplacement.degreeElevate();
+        if (cache)
+            cache->save(geometry,{&basisDisplacement,&basisPressure});
     }
-    // additional displacement refinement for stable mixed FEM
-    if (!subgridOrTaylorHood) // subgrid
-        basisDisplacement.uniformRefine();
-    else  // Taylor-Hood
-        basisDisplacement.degreeElevate();
 
     //=============================================//
         // Setting loads and boundary conditions //
@@ -107,7 +124,23 @@ int main(int argc, char* argv[]){
     gsInfo << "Solving...\n";
     gsStopwatch clock;
     clock.restart();
-    solver.solve();
+    gsMatrix<> solVector;
+    std::vector<gsMatrix<> > fixedDoFs;
+    if (useContinuation)
+    {
+        gsContinuation<real_t> continuation(assembler);
+        continuation.options().setInt("Verbosity",solver_verbosity::some);
+        continuation.solver().options().setInt("Solver",linear_solver::LDLT);
+        continuation.solve();
+        solVector = continuation.solution();
+        fixedDoFs = continuation.allFixedDofs();
+    }
+    else
+    {
+        solver.solve();
+        solVector = solver.solution();
+        fixedDoFs = solver.allFixedDofs();
+    }
     gsInfo << "Solved the system in " << clock.stop() <<"s.\n";
 
     //=============================================//
@@ -116,7 +149,7 @@ int main(int argc, char* argv[]){
 
     // displacement and pressure as isogeometric fields
     gsMultiPatch<> displacement,pressure;
-    assembler.constructSolution(solver.solution(),solver.allFixedDofs(),displacement,pressure);
+    assembler.constructSolution(solVector,fixedDoFs,displacement,pressure);
 
     if (numPlotPoints > 0) // visualization
     {
@@ -25,6 +25,8 @@ int main(int argc, char* argv[]){
     index_t numDegElev = 0;
     index_t numPlotPoints = 10000;
     bool plotMesh = false;
+    index_t numThreads = 0;
+    bool benchOutput = false;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("This is the 2D linear elasticity benchmark: infinite plate with circular hole with two patches.");
@@ -32,6 +34,8 @@ int main(int argc, char* argv[]){
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
     cmd.addSwitch("m","mesh","Plot computational mesh",plotMesh);
+    cmd.addInt("t","threads","Number of threads writing patches to Paraview: 0 - all available",numThreads);
+    cmd.addSwitch("b","bench","Report the output time for an increasing number of threads",benchOutput);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
     //=============================================//
@@ -131,8 +135,23 @@ int main(int argc, char* argv[]){
         fields["Deformation"] = &solutionField;
         fields["Stress"] = &stressField;
         fields["StressAnalytical"] = &analyticalStressField;
-        gsWriteParaviewMultiPhysics(fields,"plateWithHoleMP",numPlotPoints,plotMesh);
+        gsWriteParaviewMultiPhysics(fields,"plateWithHoleMP",numPlotPoints,plotMesh,false,vtk_format::ascii,numThreads);
         gsInfo << "Open \"plateWithHoleMP.pvd\" in Paraview for visualization.\n";
+
+        if (benchOutput)
+        {
+            // patches are distributed between threads, so more threads than patches do not help
+            const index_t numP = geometry.nPatches();
+            gsStopwatch outputClock;
+            gsInfo << "Threads\tsec/output\n";
+            for (index_t t = 1; t < 2*numP; t *= 2)
+            {
+                outputClock.restart();
+                gsWriteParaviewMultiPhysics(fields,"plateWithHoleMP_bench",numPlotPoints,plotMesh,false,
+                                            vtk_format::ascii,std::min(t,numP));
+                gsInfo << std::min(t,numP) << "\t" << outputClock.stop() << "\n";
+            }
+        }
     }
 
     // eval stress at the top of the circular cut
@@ -8,6 +8,7 @@
 #include <gismo.h>
 #include <gsElasticity/gsThermoAssembler.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsAsyncParaviewWriter.h>
 
 using namespace gismo;
 
@@ -115,6 +116,8 @@ int main(int argc, char *argv[])
     fields["Temperature"] = &tempField;
     fields["Displacement"] = &dispField;
     gsParaviewCollection collection("rotor");
+    // samples and writes the time steps in the background while the simulation continues
+    gsAsyncParaviewWriter<> outputWriter;
 
     gsStopwatch totalClock, iterClock;
     gsProgressBar bar;
@@ -148,7 +151,7 @@ int main(int argc, char *argv[])
     elastAssembler.constructSolution(solVectorElast,elastAssembler.allFixedDofs(),displacement);
 
     if (numPlotPoints > 0)
-        gsWriteParaviewMultiPhysicsTimeStep(fields,"rotor",collection,0,numPlotPoints);
+        outputWriter.push(fields,"rotor",collection,0,numPlotPoints);
 
     //=============================================//
                   // Solving //
@@ -191,7 +194,7 @@ int main(int argc, char *argv[])
 
         // output
         if (numPlotPoints > 0)
-            gsWriteParaviewMultiPhysicsTimeStep(fields,"rotor",collection,i+1,numPlotPoints);
+            outputWriter.push(fields,"rotor",collection,i+1,numPlotPoints);
     }
 
     //=============================================//
@@ -204,6 +207,7 @@ int main(int argc, char *argv[])
 
     if (numPlotPoints > 0)
     {
+        outputWriter.flush();
         collection.save();
         gsInfo << "Open \"rotor.pvd\" in Paraview for visualization.\n";
     }
@@ -4,6 +4,7 @@
 #include <gismo.h>
 #include <gsElasticity/gsElasticityAssembler.h>
 #include <gsElasticity/gsIterative.h>
+#include <gsElasticity/gsContinuation.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
 #include <gsElasticity/gsGeoUtils.h>
 
@@ -26,7 +27,10 @@ int main(int argc, char* argv[]){
     index_t numDegElev = 0;
     index_t numUniRefX = 3;
     index_t numPlotPoints = 10000;
+    index_t numThreads = 0;
+    bool benchOutput = false;
     bool plotMesh = false;
+    bool useContinuation = false;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("Testing the linear elasticity solver in 3D.");
@@ -37,6 +41,9 @@ int main(int argc, char* argv[]){
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
     cmd.addSwitch("m","mesh","Plot computational mesh",plotMesh);
+    cmd.addInt("t","threads","Number of threads writing patches to Paraview: 0 - all available",numThreads);
+    cmd.addSwitch("b","bench","Report the output time for an increasing number of threads",benchOutput);
+    cmd.addSwitch("c","continuation","Apply the load in adaptive load steps",useContinuation);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
     //=============================================//
@@ -105,8 +112,26 @@ int main(int argc, char* argv[]){
     newton.compute();
     gsInfo << newton.status() << std::endl;
     gsVector<> linSolVector = newton.solution();
-    // continue iterations till convergence
-    newton.solve();
+    gsMatrix<> solVector;
+    std::vector<gsMatrix<> > fixedDoFs;
+    if (useContinuation)
+    {
+        // apply the pull gradually starting from zero load
+        gsContinuation<real_t> continuation(assembler);
+        continuation.options().setInt("Load",continuation_load::dirichlet);
+        continuation.options().setInt("Verbosity",solver_verbosity::some);
+        continuation.solver().options().setInt("Solver",linear_solver::LDLT);
+        continuation.solve();
+        solVector = continuation.solution();
+        fixedDoFs = continuation.allFixedDofs();
+    }
+    else
+    {
+        // continue iterations till convergence
+        newton.solve();
+        solVector = newton.solution();
+        fixedDoFs = newton.allFixedDofs();
+    }
     gsInfo << "Solved the system in " << clock.stop() <<"s.\n";
 
     //=============================================//
@@ -117,7 +142,7 @@ int main(int argc, char* argv[]){
     gsMultiPatch<> solutionLinear;
     assembler.constructSolution(linSolVector,newton.allFixedDofs(),solutionLinear);
     gsMultiPatch<> solutionNonlinear;
-    assembler.constructSolution(newton.solution(),newton.allFixedDofs(),solutionNonlinear);
+    assembler.constructSolution(solVector,fixedDoFs,solutionNonlinear);
     // constructing stress tensor
     gsPiecewiseFunction<> stresses;
     assembler.constructCauchyStresses(solutionNonlinear,stresses,stress_components::von_mises);
@@ -132,8 +157,23 @@ int main(int argc, char* argv[]){
         fields["Deformation (nonlinElast)"] = &nonlinearSolutionField;
         fields["Deformation (linElast)"] = &linearSolutionField;
         fields["von Mises"] = &stressField;
-        gsWriteParaviewMultiPhysics(fields,"spring",numPlotPoints,plotMesh);
+        gsWriteParaviewMultiPhysics(fields,"spring",numPlotPoints,plotMesh,false,vtk_format::ascii,numThreads);
         gsInfo << "Open \"spring.pvd\" in Paraview for visualization.\n";
+
+        if (benchOutput)
+        {
+            // patches are distributed between threads, so more threads than patches do not help
+            const index_t numP = geometry.nPatches();
+            gsStopwatch outputClock;
+            gsInfo << "Threads\tsec/output\n";
+            for (index_t t = 1; t < 2*numP; t *= 2)
+            {
+                outputClock.restart();
+                gsWriteParaviewMultiPhysics(fields,"spring_bench",numPlotPoints,plotMesh,false,
+                                            vtk_format::ascii,std::min(t,numP));
+                gsInfo << std::min(t,numP) << "\t" << outputClock.stop() << "\n";
+            }
+        }
     }
 
     return 0;
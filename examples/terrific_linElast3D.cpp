@@ -7,6 +7,7 @@
 #include <gsElasticity/gsElasticityAssembler.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
 #include <gsElasticity/gsGeoUtils.h>
+#include <gsElasticity/gsDiscretizationCache.h>
 
 using namespace gismo;
 
@@ -24,27 +25,43 @@ int main(int argc, char* argv[]){
     index_t numUniRef = 0;
     index_t numDegElev = 0;
     index_t numPlotPoints = 10000;
+    index_t outputFormat = vtk_format::ascii;
+    bool benchOutput = false;
+    bool useCache = false;
 
     // minimalistic user interface for terminal
     gsCmdLine cmd("Testing the linear elasticity solver in 3D.");
     cmd.addInt("r","refine","Number of uniform refinement application",numUniRef);
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
+    cmd.addInt("f","format","Paraview format: 0 - ascii, 1 - base64, 2 - base64+zlib, 3 - raw, 4 - raw+zlib",outputFormat);
+    cmd.addSwitch("b","bench","Write the output in all formats and report bytes and seconds per frame",benchOutput);
+    cmd.addSwitch("k","cache","Store the refined discretization in a binary file and reuse it in the next runs",useCache);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
     //=============================================//
         // Scanning geometry and creating bases //
     //=============================================//
 
-    // scanning geometry
     gsMultiPatch<> geometry;
-    gsReadFile<>(filename, geometry);
-    // creating basis
-    gsMultiBasis<> basis(geometry);
-    for (index_t i = 0; i < numDegElev; ++i)
-        basis.degreeElevate();
-    for (index_t i = 0; i < numUniRef; ++i)
-        basis.uniformRefine();
+    gsMultiBasis<> basis;
+    // the cache hashes the geometry file, so it is only created if requested
+    std::unique_ptr<gsDiscretizationCache<real_t> > cache;
+    if (useCache)
+        cache.reset(new gsDiscretizationCache<real_t>(filename,"d" + util::to_string(numDegElev) + "_r" + util::to_string(numUniRef)));
+    if (!cache || !cache->load(geometry,basis))
+    {
+        // scanning geometry
+        gsReadFile<>(filename, geometry);
+        // creating basis
+        basis = gsMultiBasis<>(geometry);
+        for (index_t i = 0; i < numDegElev; ++i)
+            basis.degreeElevate();
+        for (index_t i = 0; i < numUniRef; ++i)
+            basis.uniformRefine();
+        if (cache)
+            cache->save(geometry,basis);
+    }
 
     //=============================================//
         // Setting loads and boundary conditions //
@@ -117,8 +134,28 @@ int main(int argc, char* argv[]){
         std::map<std::string,const gsField<> *> fields;
         fields["Deformation"] = &solutionField;
         fields["von Mises"] = &stressField;
-        gsWriteParaviewMultiPhysics(fields,"terrific",numPlotPoints);
+        gsWriteParaviewMultiPhysics(fields,"terrific",numPlotPoints,false,false,vtk_format::format(outputFormat));
         gsInfo << "Open \"terrific.pvd\" in Paraview for visualization.\n";
+
+        if (benchOutput)
+        {
+            const std::string formatNames[] = {"ascii","base64","base64+zlib","raw","raw+zlib"};
+            gsInfo << "Format\t\tbytes/frame\tsec/frame\n";
+            for (index_t f = vtk_format::ascii; f <= vtk_format::raw_zlib; ++f)
+            {
+                clock.restart();
+                gsWriteParaviewMultiPhysics(fields,"terrific_bench",numPlotPoints,false,false,vtk_format::format(f));
+                real_t time = clock.stop();
+                std::streamoff bytes = 0;
+                for (size_t p = 0; p < geometry.nPatches(); ++p)
+                {
+                    std::ifstream file(("terrific_bench" + util::to_string(p) + ".vts").c_str(),
+                                       std::ios::binary | std::ios::ate);
+                    bytes += file.tellg();
+                }
+                gsInfo << formatNames[f] << "\t\t" << bytes << "\t\t" << time << "\n";
+            }
+        }
     }
 
     return 0;
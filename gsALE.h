@@ -26,6 +26,10 @@ template <class T>
 class gsBaseAssembler;
 template <class T>
 class gsIterative;
+template <class T>
+class gsCheckpointWriter;
+template <class T>
+class gsCheckpointReader;
 
 template <class T>
 class gsALE
@@ -55,6 +59,12 @@ public:
     /// recover module state from saved state
     void recoverState();
 
+    /// write the module state to a checkpoint; the saved state is not written
+    void writeCheckpoint(gsCheckpointWriter<T> & writer) const;
+
+    /// restore the module state from a checkpoint
+    void readCheckpoint(gsCheckpointReader<T> & reader);
+
     /// get FSI interface container to access patch sides
     const gsBoundaryInterface & interface() { return m_interface;}
 
@@ -89,9 +99,11 @@ protected:
     bool initialized;
 
 
-    /// saved state
+    /// saved state: control points of the ALE displacement
     bool hasSavedState;
-    gsMultiPatch<T> ALEdispSaved;
+    std::vector<gsMatrix<T> > ALEdispSaved;
+    /// whether the mesh has been updated since the state was saved or recovered
+    bool stateChanged;
 };
 
 } // namespace ends
@@ -21,6 +21,7 @@
 #include <gsElasticity/gsBiharmonicAssembler.h>
 #include <gsElasticity/gsIterative.h>
 #include <gsElasticity/gsGeoUtils.h>
+#include <gsElasticity/gsCheckpoint.h>
 
 namespace gismo
 {
@@ -33,7 +34,8 @@ gsALE<T>::gsALE(gsMultiPatch<T> & geometry, const gsMultiPatch<T> & displacement
       methodALE(method),
       m_options(defaultOptions()),
       initialized(false),
-      hasSavedState(false)
+      hasSavedState(false),
+      stateChanged(false)
 {
     // create input for the assembler
     gsMultiBasis<T> basis(geometry);
@@ -91,6 +93,7 @@ gsOptionList gsALE<T>::defaultOptions()
     opt.addReal("PoissonsRatio","Poisson's ratio of the material (only for elasticity-based methods)",0.4);
     opt.addReal("LocalStiff","Stiffening degree for the Jacobian-based local stiffening",0.);
     opt.addSwitch("Check","Check bijectivity of the resulting ALE displacement field",true);
+    opt.addInt("CheckMethod","Bijectivity check: 0 - sampling, 1 - Bezier coefficients (certified)",bijectivity_check::sampling);
     opt.addInt("NumIter","Number of iterations for nonlinear methods",1);
     return opt;
 }
@@ -121,8 +124,10 @@ void gsALE<T>::initialize()
 template <class T>
 index_t gsALE<T>::updateMesh()
 {
+    ELAST_PROFILE_REGION("ALE update");
     if (!initialized)
         initialize();
+    stateChanged = true;
 
     switch (methodALE)
     {
@@ -150,16 +155,19 @@ index_t gsALE<T>::linearMethod()
     assembler->eliminateFixedDofs();
 
 #ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
+    gsSparseSolver<>::PardisoLDLT solver;
+    gsProfiledFactorize(solver,assembler->matrix());
+    gsMatrix<> solVector = gsProfiledSolve(solver,assembler->rhs());
 #else
-    gsSparseSolver<>::SimplicialLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
+    gsSparseSolver<>::SimplicialLDLT solver;
+    gsProfiledFactorize(solver,assembler->matrix());
+    gsMatrix<> solVector = gsProfiledSolve(solver,assembler->rhs());
 #endif
 
     assembler->constructSolution(solVector,assembler->allFixedDofs(),ALEdisp);
     if (m_options.getSwitch("Check"))
-        return checkDisplacement(assembler->patches(),ALEdisp);
+        return checkDisplacement(assembler->patches(),ALEdisp,
+                                 bijectivity_check::method(m_options.getInt("CheckMethod")));
     else
         return -1;
 }
@@ -176,11 +184,13 @@ index_t gsALE<T>::linearIncrementalMethod()
     assembler->assemble();
 
 #ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
+    gsSparseSolver<>::PardisoLDLT solver;
+    gsProfiledFactorize(solver,assembler->matrix());
+    gsMatrix<> solVector = gsProfiledSolve(solver,assembler->rhs());
 #else
-    gsSparseSolver<>::SimplicialLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
+    gsSparseSolver<>::SimplicialLDLT solver;
+    gsProfiledFactorize(solver,assembler->matrix());
+    gsMatrix<> solVector = gsProfiledSolve(solver,assembler->rhs());
 #endif
 
     gsMultiPatch<T> ALEupdate;
@@ -191,7 +201,8 @@ index_t gsALE<T>::linearIncrementalMethod()
         assembler->patches().patch(p).coefs() += ALEupdate.patch(p).coefs();
     }
     if (m_options.getSwitch("Check"))
-        return checkGeometry(assembler->patches());
+        return checkGeometry(assembler->patches(),
+                             bijectivity_check::method(m_options.getInt("CheckMethod")));
     else
         return -1;
 }
@@ -208,7 +219,8 @@ index_t gsALE<T>::nonlinearMethod()
     solverNL->solve();
     assembler->constructSolution(solverNL->solution(),solverNL->allFixedDofs(),ALEdisp);
     if (m_options.getSwitch("Check"))
-        return checkDisplacement(assembler->patches(),ALEdisp);
+        return checkDisplacement(assembler->patches(),ALEdisp,
+                                 bijectivity_check::method(m_options.getInt("CheckMethod")));
     else
         return -1;
 }
@@ -218,23 +230,69 @@ void gsALE<T>::saveState()
 {
     if (methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
         solverNL->saveState();
-    ALEdispSaved.clear();
+    // only the control points are saved; assignment reuses the allocated memory
+    ALEdispSaved.resize(ALEdisp.nPatches());
     for (size_t p = 0; p < ALEdisp.nPatches(); ++p)
-        ALEdispSaved.addPatch(ALEdisp.patch(p).clone());
+        ALEdispSaved[p] = ALEdisp.patch(p).coefs();
     hasSavedState = true;
+    stateChanged = false;
 }
 
 template <class T>
 void gsALE<T>::recoverState()
 {
     GISMO_ENSURE(hasSavedState,"No state saved!");
+    // nothing to recover if the mesh has not been updated since the state was saved or recovered
+    if (!stateChanged)
+        return;
     if (methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
         solverNL->recoverState();
     if (methodALE == ale_method::IHE || methodALE == ale_method::ILE || methodALE == ale_method::IBHE)
         for (size_t p = 0; p < ALEdisp.nPatches(); ++p)
-            assembler->patches().patch(p).coefs() += ALEdispSaved.patch(p).coefs() - ALEdisp.patch(p).coefs();
+            assembler->patches().patch(p).coefs() += ALEdispSaved[p] - ALEdisp.patch(p).coefs();
     for (size_t p = 0; p < ALEdisp.nPatches(); ++p)
-        ALEdisp.patch(p).coefs() = ALEdispSaved.patch(p).coefs();
+        ALEdisp.patch(p).coefs() = ALEdispSaved[p];
+    stateChanged = false;
+}
+
+template <class T>
+void gsALE<T>::writeCheckpoint(gsCheckpointWriter<T> & writer) const
+{
+    writer.section("gsALE");
+    writer.write("method",index_t(methodALE));
+    writer.writeCoefs("displacement",ALEdisp);
+    // incremental methods update the geometry of the assembler
+    writer.writeCoefs("geometry",assembler->patches());
+    if (methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
+    {
+        writer.write("solution",solverNL->solution());
+        writer.write("fixedDofs",solverNL->allFixedDofs());
+    }
+}
+
+template <class T>
+void gsALE<T>::readCheckpoint(gsCheckpointReader<T> & reader)
+{
+    index_t method;
+    reader.section("gsALE");
+    reader.read("method",method);
+    GISMO_ENSURE(method == methodALE,"Checkpoint was written with a different mesh deformation method.");
+    // linear methods assemble the matrix in the reference configuration
+    if (!initialized)
+        initialize();
+    reader.readCoefs("displacement",ALEdisp);
+    reader.readCoefs("geometry",assembler->patches());
+    if (methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
+    {
+        gsMatrix<T> solution;
+        std::vector<gsMatrix<T> > ddofs;
+        reader.read("solution",solution);
+        reader.read("fixedDofs",ddofs);
+        solverNL->setSolutionVector(solution);
+        solverNL->setFixedDofs(ddofs);
+    }
+    hasSavedState = false;
+    stateChanged = false;
 }
 
 } // namespace ends
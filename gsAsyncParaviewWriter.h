@@ -0,0 +1,110 @@
+/** @file gsAsyncParaviewWriter.h
+
+    @brief Writes time steps of several fields to Paraview files on a background thread.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsIO/gsParaviewCollection.h>
+#include <gsElasticity/gsBaseUtils.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <deque>
+
+namespace gismo
+{
+
+/** @brief Asynchronous replacement for gsWriteParaviewMultiPhysicsTimeStep.
+ *
+ * push() takes a snapshot of the fields and returns; sampling and writing of the Paraview files
+ * is done by a background thread while the simulation continues. A snapshot of an isogeometric field
+ * (and of the geometry) is a copy of its control points into a preallocated slot.
+ * Other fields, e.g. stresses given by gsPiecewiseFunction, depend on the current state of the solution
+ * and are therefore sampled immediately by push(); only their writing is deferred.
+ *
+ * Memory is bounded by the number of slots: if all slots are occupied, push() waits until
+ * the background thread releases one. The collection receives the time step immediately,
+ * so collection.save() can be called any time after flush().
+ *
+ * flush() blocks until all pushed time steps are written and rethrows an error of the background thread;
+ * the destructor flushes as well, so no time step is lost when the writer goes out of scope.
+*/
+template <class T>
+class gsAsyncParaviewWriter
+{
+public:
+    /// @param numSlots maximal number of time steps waiting to be written
+    explicit gsAsyncParaviewWriter(index_t numSlots = 2);
+
+    /// waits for all pending time steps and stops the background thread
+    ~gsAsyncParaviewWriter();
+
+    /// snapshot the fields and add them as a time step to the collection;
+    /// the arguments have the same meaning as for gsWriteParaviewMultiPhysicsTimeStep
+    void push(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
+              gsParaviewCollection & collection, int time, unsigned npts = 1000,
+              vtk_format::format format = vtk_format::ascii);
+
+    /// block until all pushed time steps are written
+    void flush();
+
+    /// number of time steps which are pushed but not yet written
+    index_t pending();
+
+protected:
+    /// a copy of the data necessary to write one time step
+    struct Snapshot
+    {
+        std::string fn;
+        unsigned npts;
+        vtk_format::format format;
+        gsMultiPatch<T> geometry;
+        /// names and control points of the isogeometric fields
+        std::vector<std::string> igaNames;
+        std::vector<gsMultiPatch<T> > igaFields;
+        /// evaluations of other fields: [patch][name]
+        std::vector<std::map<std::string, gsMatrix<T> > > sampled;
+    };
+
+    /// copy control points of the patches into a snapshot multipatch; clone the patches only if their size changed
+    static void copyPatches(const std::vector<const gsGeometry<T> *> & source, gsMultiPatch<T> & result);
+
+    /// fill a free slot with the current state of the fields
+    void takeSnapshot(const std::map<std::string, const gsField<T> *> & fields, Snapshot & snap);
+    /// sample the snapshot and write the files
+    void write(const Snapshot & snap);
+    /// background thread loop
+    void run();
+
+protected:
+    std::vector<Snapshot> m_slots;
+    /// indices of the slots which are free or waiting to be written
+    std::deque<index_t> m_free;
+    std::deque<index_t> m_queue;
+    /// true while the background thread is writing a slot
+    bool m_busy;
+    bool m_stop;
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAsyncParaviewWriter.hpp)
+#endif
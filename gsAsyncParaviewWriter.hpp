@@ -0,0 +1,251 @@
+/** @file gsAsyncParaviewWriter.hpp
+
+    @brief Implementation of gsAsyncParaviewWriter.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsAsyncParaviewWriter.h>
+
+#include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsCore/gsField.h>
+#include <gsElasticity/gsProfiler.h>
+
+namespace gismo
+{
+
+template <class T>
+gsAsyncParaviewWriter<T>::gsAsyncParaviewWriter(index_t numSlots)
+    : m_slots(numSlots > 0 ? numSlots : 1),
+      m_busy(false),
+      m_stop(false)
+{
+    for (size_t i = 0; i < m_slots.size(); ++i)
+        m_free.push_back(i);
+    m_thread = std::thread(&gsAsyncParaviewWriter<T>::run,this);
+}
+
+template <class T>
+gsAsyncParaviewWriter<T>::~gsAsyncParaviewWriter()
+{
+    // write everything that was pushed; errors cannot be propagated from the destructor
+    try
+    {
+        flush();
+    }
+    catch (std::exception & e)
+    {
+        gsWarn << "gsAsyncParaviewWriter: " << e.what() << "\n";
+    }
+    catch (...)
+    {
+        gsWarn << "gsAsyncParaviewWriter: unknown error while writing output.\n";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::push(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
+                                    gsParaviewCollection & collection, int time, unsigned npts,
+                                    vtk_format::format format)
+{
+    GISMO_ENSURE(!fields.empty(),"No fields to write.\n");
+
+    // wait for a free slot; this bounds the memory used by the snapshots
+    index_t slot;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock,[this]{ return !m_free.empty(); });
+        slot = m_free.front();
+        m_free.pop_front();
+    }
+
+    Snapshot & snap = m_slots[slot];
+    snap.fn = fn + util::to_string(time) + "_";
+    snap.npts = npts;
+    snap.format = format;
+    try
+    {
+        takeSnapshot(fields,snap);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(slot);
+        throw;
+    }
+
+    // file names are known in advance, so the collection is updated right away
+    std::string fileName = fn.substr(fn.find_last_of("/\\")+1); // file name without a path
+    for (size_t p = 0; p < snap.geometry.nPatches(); ++p)
+        collection.addTimestep(fileName + util::to_string(time) + "_",p,time,".vts");
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(slot);
+    }
+    m_cond.notify_all();
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock,[this]{ return m_queue.empty() && !m_busy; });
+    if (m_error)
+    {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+template <class T>
+index_t gsAsyncParaviewWriter<T>::pending()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size() + (m_busy ? 1 : 0);
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::copyPatches(const std::vector<const gsGeometry<T> *> & source,
+                                           gsMultiPatch<T> & result)
+{
+    bool sameSize = result.nPatches() == source.size();
+    for (size_t p = 0; p < source.size() && sameSize; ++p)
+        sameSize = result.patch(p).coefs().rows() == source[p]->coefs().rows() &&
+                   result.patch(p).coefs().cols() == source[p]->coefs().cols();
+
+    if (sameSize) // no allocation, only the control points are copied
+        for (size_t p = 0; p < source.size(); ++p)
+            result.patch(p).coefs() = source[p]->coefs();
+    else // first use of the slot or the discretization has changed
+    {
+        result.clear();
+        for (size_t p = 0; p < source.size(); ++p)
+            result.addPatch(source[p]->clone());
+    }
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::takeSnapshot(const std::map<std::string, const gsField<T> *> & fields,
+                                            Snapshot & snap)
+{
+    // all fields are defined on the geometry of the first one
+    const gsField<T> & first = *(fields.begin()->second);
+    const size_t numP = first.patches().nPatches();
+    std::vector<const gsGeometry<T> *> source(numP);
+
+    for (size_t p = 0; p < numP; ++p)
+        source[p] = &first.patch(p);
+    copyPatches(source,snap.geometry);
+
+    std::map<std::string, const gsField<T> *> otherFields;
+    size_t numIga = 0;
+    snap.igaNames.clear();
+    for (typename std::map<std::string, const gsField<T> *>::const_iterator it = fields.begin(); it != fields.end(); ++it)
+    {
+        if (it->second->isParametrized())
+        {
+            for (size_t p = 0; p < numP; ++p)
+                source[p] = &(it->second->igaFunction(p));
+            if (snap.igaFields.size() <= numIga)
+                snap.igaFields.push_back(gsMultiPatch<T>());
+            copyPatches(source,snap.igaFields[numIga]);
+            snap.igaNames.push_back(it->first);
+            ++numIga;
+        }
+        else
+            otherFields[it->first] = it->second;
+    }
+    snap.igaFields.resize(numIga);
+
+    // fields which are not given by control points are sampled right away
+    snap.sampled.resize(numP);
+    gsMatrix<T> points;
+    gsVector<index_t> np;
+    for (size_t p = 0; p < numP; ++p)
+    {
+        snap.sampled[p].clear();
+        if (!otherFields.empty())
+            gsSampleMultiPhysicsSinglePatch(first.patch(p),otherFields,p,snap.npts,points,snap.sampled[p],np);
+    }
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::write(const Snapshot & snap)
+{
+    // isogeometric fields on the geometry of the snapshot
+    std::vector<gsField<T> > igaFields;
+    igaFields.reserve(snap.igaFields.size());
+    std::map<std::string, const gsField<T> *> fields;
+    for (size_t i = 0; i < snap.igaFields.size(); ++i)
+    {
+        igaFields.push_back(gsField<T>(snap.geometry,snap.igaFields[i]));
+        fields[snap.igaNames[i]] = &igaFields.back();
+    }
+
+    gsMatrix<T> points;
+    std::map<std::string, gsMatrix<T> > data;
+    gsVector<index_t> np;
+    for (size_t p = 0; p < snap.geometry.nPatches(); ++p)
+    {
+        gsSampleMultiPhysicsSinglePatch(snap.geometry.patch(p),fields,p,snap.npts,points,data,np);
+        if (np.size() == 0)
+            continue;
+        data.insert(snap.sampled[p].begin(),snap.sampled[p].end());
+        gsWriteParaviewMultiTPgrid(points,data,np,snap.fn + util::to_string(p),snap.format);
+    }
+}
+
+template <class T>
+void gsAsyncParaviewWriter<T>::run()
+{
+    // the output of a time step overlaps with the computation of the next ones
+    ELAST_PROFILE_DETACH_THREAD("background output");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cond.wait(lock,[this]{ return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) // stop requested and nothing left to write
+            return;
+        index_t slot = m_queue.front();
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        try
+        {
+            write(m_slots[slot]);
+        }
+        catch (...)
+        {
+            lock.lock();
+            if (!m_error)
+                m_error = std::current_exception();
+            lock.unlock();
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_free.push_back(slot);
+        m_cond.notify_all();
+    }
+}
+
+} // namespace ends
@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsAsyncParaviewWriter.h>
+#include <gsElasticity/gsAsyncParaviewWriter.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsAsyncParaviewWriter<real_t>;
+}
@@ -15,10 +15,43 @@
 #pragma once
 
 #include <gsAssembler/gsAssembler.h>
+#include <gsElasticity/gsProfiler.h>
 
 namespace gismo
 {
 
+/** @brief Wraps a visitor of gsAssembler::push and profiles its element-wise calls.
+ * Has no effect on the results; with the profiler disabled, the overhead is one branch per call.
+ */
+template <class Visitor>
+class gsProfiledVisitor : public Visitor
+{
+public:
+    using Visitor::Visitor;
+    gsProfiledVisitor(const Visitor & visitor) : Visitor(visitor) {}
+
+    template <class... Args>
+    void evaluate(Args &&... args)
+    {
+        ELAST_PROFILE_SCOPE("evaluate");
+        Visitor::evaluate(std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    void assemble(Args &&... args)
+    {
+        ELAST_PROFILE_SCOPE("assemble");
+        Visitor::assemble(std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    void localToGlobal(Args &&... args)
+    {
+        ELAST_PROFILE_SCOPE("localToGlobal");
+        Visitor::localToGlobal(std::forward<Args>(args)...);
+    }
+};
+
 /** @brief Extends the gsAssembler class by adding functionality necessary for a general nonlinear solver.
  * Potentially, can be merged back into gsAssembler.
  */
@@ -35,6 +68,14 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDDoFs) = 0;
 
+    /// Assembles only the residual of the nonlinear system given the current solution
+    /// (rhs() returns a negative residual -r); the matrix is not updated.
+    /// Useful for line searches and convergence checks. Returns false if the current solution is invalid.
+    /// Falls back to the full assembly if not overloaded.
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs)
+    { return assemble(solutionVector,fixedDoFs); }
+
     /// assembly procedure for linear problems
     virtual void assemble(bool saveEliminationMatrix = false) {};
 
@@ -83,6 +124,22 @@ public:
 
     virtual void setMatrix(const gsSparseMatrix<T> & matrix) {m_system.matrix() = matrix;}
 
+    /// element-wise assembly over the domain by gsAssembler::push; the visitor calls are profiled
+    template <class ElementVisitor>
+    void push(const ElementVisitor & visitor)
+    {
+        ELAST_PROFILE_REGION("push");
+        gsAssembler<T>::template push<gsProfiledVisitor<ElementVisitor> >(visitor);
+    }
+
+    /// element-wise assembly over the given boundary sides by gsAssembler::push; the visitor calls are profiled
+    template <class BElementVisitor>
+    void push(const typename gsBoundaryConditions<T>::bcContainer & BCs)
+    {
+        ELAST_PROFILE_REGION("push boundary");
+        gsAssembler<T>::template push<gsProfiledVisitor<BElementVisitor> >(BCs);
+    }
+
 protected:
     using gsAssembler<T>::m_pde_ptr;
     using gsAssembler<T>::m_bases;
@@ -25,6 +25,7 @@ void gsBaseAssembler<T>::constructSolution(const gsMatrix<T> & solVector,
                                            gsMultiPatch<T> & result,
                                            const gsVector<index_t> & unknowns) const
 {
+    ELAST_PROFILE_REGION("constructSolution");
     result.clear();
     GISMO_ENSURE(unknowns.rows() > 0, "No unknowns provided!");
     index_t nRhs = m_system.rhs().cols();
@@ -150,6 +151,7 @@ index_t gsBaseAssembler<T>::numFixedDofs() const
 template <class T>
 void gsBaseAssembler<T>::eliminateFixedDofs()
 {
+    ELAST_PROFILE_REGION("eliminateFixedDofs");
     // allocate a vector of fixed degrees of freedom
     gsMatrix<T> fixedDofs(numFixedDofs(),m_system.rhs().cols());
     // from a vector of fixed degrees of freedom
@@ -38,6 +38,16 @@ struct ale_method
     };
 };
 
+/// @brief Specifies the method used to check bijectivity of a (deformed) configuration
+struct bijectivity_check
+{
+    enum method
+    {
+        sampling = 0,  /// sample the Jacobian determinant at the quadrature points and the corners of each element
+        bezier = 1     /// check signs of the Bezier coefficients of the Jacobian determinant of each element (certified)
+    };
+};
+
 /// @brief Specifies the iteration type used to solve nonlinear systems
 struct ns_assembly
 {
@@ -57,7 +67,34 @@ struct time_integration
         explicit_ = 0,         /// explicit scheme
         explicit_lumped = 1,   /// explicit scheme with lumped mass matrix
         implicit_linear = 2,   /// implicit scheme with linear problem (theta-scheme)
-        implicit_nonlinear = 3 /// implicit scheme with nonlinear problem (theta-scheme)
+        implicit_nonlinear = 3, /// implicit scheme with nonlinear problem (theta-scheme)
+        bdf2 = 4,              /// second-order backward differentiation with nonlinear problem (Navier-Stokes only)
+        imex_bdf2 = 5          /// second-order backward differentiation with extrapolated explicit convection;
+                               /// constant matrix for a constant time step (Navier-Stokes only)
+    };
+};
+
+/// @brief Specifies the encoding of data arrays in VTK XML files written by gsWriteParaviewMultiPhysics
+struct vtk_format
+{
+    enum format
+    {
+        ascii = 0,       /// human-readable text
+        base64 = 1,      /// binary data encoded inline as base64
+        base64_zlib = 2, /// zlib-compressed binary data encoded inline as base64
+        raw = 3,         /// binary data appended to the end of the file without encoding
+        raw_zlib = 4     /// zlib-compressed binary data appended to the end of the file
+    };
+};
+
+/// @brief Specifies the type of the mass matrix
+struct mass_lumping
+{
+    enum type
+    {
+        consistent = 0, /// consistent mass matrix
+        row_sum = 1,    /// diagonal matrix with row sums of the consistent matrix
+        hrz = 2         /// diagonal of the consistent matrix scaled to preserve the element mass (Hinton-Rock-Zienkiewicz)
     };
 };
 
@@ -95,6 +132,39 @@ struct iteration_type
     };
 };
 
+/// @brief Specifies globalization of Newton's method (update mode of an iterative solver)
+struct newton_globalization
+{
+    enum strategy
+    {
+        none = 0,         /// full Newton steps
+        line_search = 1,  /// backtracking line search on the residual norm
+        trust_region = 2  /// dogleg trust region on the residual norm
+    };
+};
+
+/// @brief Specifies the quasi-Newton update used instead of the tangential matrix (update mode of an iterative solver)
+struct quasi_newton
+{
+    enum method
+    {
+        none = 0,    /// Newton's method, the tangential matrix is assembled and factorized at every iteration
+        lbfgs = 1,   /// limited-memory BFGS, for problems with a symmetric tangent (hyperelasticity)
+        broyden = 2  /// Broyden's method, for problems with a nonsymmetric tangent (Navier-Stokes)
+    };
+};
+
+/// @brief Specifies which part of the loading is scaled by a continuation method
+struct continuation_load
+{
+    enum type
+    {
+        force = 0,      /// volumetric and surface forces (ForceScaling)
+        dirichlet = 1,  /// prescribed Dirichlet values
+        both = 2        /// forces and Dirichlet values simultaneously
+    };
+};
+
 /// @brief Specifies the status of the iterative solver
 enum class solver_status { converged,      /// method successfully converged
                            interrupted,    /// solver was interrupted after exceeding the limit of iterations
@@ -0,0 +1,112 @@
+/** @file gsCheckpoint.h
+
+    @brief Binary checkpoint files for restarting time-dependent simulations.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsMultiBasis.h>
+
+#include <fstream>
+
+namespace gismo
+{
+
+/** @brief Writes a binary checkpoint file.
+ *
+ * A checkpoint is a sequence of named records; every record stores a matrix of reals or integers
+ * with its size followed by the raw bytes of the matrix, so the stored values are restored bitwise.
+ * Multipatches and multibases with tensor B-spline and NURBS bases are stored completely
+ * (knot vectors, weights, control points and topology), so they can be recreated without refinement.
+ * The names are verified when the checkpoint is read, which catches files written
+ * for a different setup. The data is written to fileName.part and renamed to fileName by close(),
+ * so a crash during writing does not destroy the previous checkpoint. If the platform cannot rename
+ * onto an existing file, the previous checkpoint is moved to fileName.bak until the new one is in place.
+*/
+template <class T>
+class gsCheckpointWriter
+{
+public:
+    explicit gsCheckpointWriter(std::string const & fileName);
+
+    /// start a section of records written by one object
+    void section(std::string const & name);
+
+    void write(std::string const & name, const gsMatrix<T> & matrix);
+    void write(std::string const & name, const std::vector<gsMatrix<T> > & matrices);
+    void write(std::string const & name, T value);
+    void write(std::string const & name, index_t value);
+    void write(std::string const & name, const gsMatrix<index_t> & matrix);
+    /// the arrays of the compressed storage are written as they are
+    void write(std::string const & name, const gsSparseMatrix<T> & matrix);
+    void write(std::string const & name, const gsMultiPatch<T> & multiPatch);
+    void write(std::string const & name, const gsMultiBasis<T> & multiBasis);
+
+    /// write the control points of all patches
+    void writeCoefs(std::string const & name, const gsMultiPatch<T> & multiPatch);
+
+    /// finish writing and replace the previous checkpoint with the new one
+    void close();
+
+protected:
+    void writeRecord(std::string const & name, unsigned char type, index_t rows, index_t cols, const char * data, size_t bytes);
+    void writeBasis(std::string const & name, const gsBasis<T> & basis);
+    void writeTopology(std::string const & name, const gsBoxTopology & topology);
+
+protected:
+    std::string m_fileName;
+    std::ofstream m_file;
+};
+
+/** @brief Reads a binary checkpoint file written by gsCheckpointWriter.
+ *
+ * The records must be read in the same order and with the same names as they were written.
+*/
+template <class T>
+class gsCheckpointReader
+{
+public:
+    explicit gsCheckpointReader(std::string const & fileName);
+
+    /// enter a section of records written by one object
+    void section(std::string const & name);
+
+    void read(std::string const & name, gsMatrix<T> & matrix);
+    void read(std::string const & name, std::vector<gsMatrix<T> > & matrices);
+    void read(std::string const & name, T & value);
+    void read(std::string const & name, index_t & value);
+    void read(std::string const & name, gsMatrix<index_t> & matrix);
+    void read(std::string const & name, gsSparseMatrix<T> & matrix);
+    void read(std::string const & name, gsMultiPatch<T> & multiPatch);
+    void read(std::string const & name, gsMultiBasis<T> & multiBasis);
+
+    /// read the control points of all patches; the multipatch must have the same discretization as the written one
+    void readCoefs(std::string const & name, gsMultiPatch<T> & multiPatch);
+
+protected:
+    /// reads the record header, checks its name and type and returns its size
+    void readHeader(std::string const & name, unsigned char type, index_t & rows, index_t & cols);
+    void readData(char * data, size_t bytes);
+    typename gsBasis<T>::uPtr readBasis(std::string const & name);
+    void readTopology(std::string const & name, gsBoxTopology & topology);
+
+protected:
+    std::string m_fileName;
+    std::ifstream m_file;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsCheckpoint.hpp)
+#endif
@@ -0,0 +1,510 @@
+/** @file gsCheckpoint.hpp
+
+    @brief Implementation of gsCheckpointWriter and gsCheckpointReader.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsCheckpoint.h>
+
+#include <gsNurbs/gsBSplineBasis.h>
+#include <gsNurbs/gsTensorBSplineBasis.h>
+#include <gsNurbs/gsNurbsBasis.h>
+#include <gsNurbs/gsTensorNurbsBasis.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace gismo
+{
+
+namespace internal
+{
+/// file layout: magic | version | sizeof(T) | sizeof(index_t) | records
+/// record layout: name length | name | type | rows | cols | raw data in the column-major order
+const char checkpointMagic[8] = {'g','s','E','l','C','k','p','t'};
+/// version of the checkpoint format; files of other versions are rejected
+const uint32_t checkpointVersion = 1;
+
+namespace checkpoint_record
+{
+    enum type
+    {
+        section = 0, /// marks the beginning of the records written by one object
+        real = 1,    /// matrix of reals
+        integer = 2  /// matrix of integers
+    };
+}
+
+/// knot vector of a B-spline basis in the given direction; null for other bases
+template <class T>
+const gsKnotVector<T> * checkpointKnots(const gsBasis<T> & basis, short_t dir)
+{
+    switch (basis.dim())
+    {
+    case 1:
+    {
+        const gsBSplineBasis<T> * bspline = dynamic_cast<const gsBSplineBasis<T> *>(&basis);
+        return bspline == nullptr ? nullptr : &(bspline->knots());
+    }
+    case 2:
+    {
+        const gsTensorBSplineBasis<2,T> * bspline = dynamic_cast<const gsTensorBSplineBasis<2,T> *>(&basis);
+        return bspline == nullptr ? nullptr : &(bspline->knots(dir));
+    }
+    case 3:
+    {
+        const gsTensorBSplineBasis<3,T> * bspline = dynamic_cast<const gsTensorBSplineBasis<3,T> *>(&basis);
+        return bspline == nullptr ? nullptr : &(bspline->knots(dir));
+    }
+    default:
+        return nullptr;
+    }
+}
+}
+
+//--------------------------------------------------------------------------------//
+
+template <class T>
+gsCheckpointWriter<T>::gsCheckpointWriter(std::string const & fileName)
+    : m_fileName(fileName)
+{
+    m_file.open((m_fileName + ".part").c_str(),std::ios::binary | std::ios::trunc);
+    GISMO_ENSURE(m_file.good(),"Cannot open the checkpoint file " + m_fileName + ".part for writing.\n");
+
+    const uint32_t header[3] = {internal::checkpointVersion,uint32_t(sizeof(T)),uint32_t(sizeof(index_t))};
+    m_file.write(internal::checkpointMagic,sizeof(internal::checkpointMagic));
+    m_file.write(reinterpret_cast<const char *>(header),sizeof(header));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::writeRecord(std::string const & name, unsigned char type,
+                                        index_t rows, index_t cols, const char * data, size_t bytes)
+{
+    const uint32_t nameLength = name.size();
+    const int64_t size[2] = {rows,cols};
+    m_file.write(reinterpret_cast<const char *>(&nameLength),sizeof(nameLength));
+    m_file.write(name.data(),nameLength);
+    m_file.write(reinterpret_cast<const char *>(&type),sizeof(type));
+    m_file.write(reinterpret_cast<const char *>(size),sizeof(size));
+    if (bytes > 0)
+        m_file.write(data,bytes);
+}
+
+template <class T>
+void gsCheckpointWriter<T>::section(std::string const & name)
+{
+    writeRecord(name,internal::checkpoint_record::section,0,0,nullptr,0);
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const gsMatrix<T> & matrix)
+{
+    writeRecord(name,internal::checkpoint_record::real,matrix.rows(),matrix.cols(),
+                reinterpret_cast<const char *>(matrix.data()),matrix.size()*sizeof(T));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const std::vector<gsMatrix<T> > & matrices)
+{
+    write(name,index_t(matrices.size()));
+    for (size_t i = 0; i < matrices.size(); ++i)
+        write(name + "[" + util::to_string(i) + "]",matrices[i]);
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, T value)
+{
+    writeRecord(name,internal::checkpoint_record::real,1,1,reinterpret_cast<const char *>(&value),sizeof(T));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, index_t value)
+{
+    writeRecord(name,internal::checkpoint_record::integer,1,1,reinterpret_cast<const char *>(&value),sizeof(index_t));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const gsMatrix<index_t> & matrix)
+{
+    writeRecord(name,internal::checkpoint_record::integer,matrix.rows(),matrix.cols(),
+                reinterpret_cast<const char *>(matrix.data()),matrix.size()*sizeof(index_t));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const gsSparseMatrix<T> & matrix)
+{
+    if (!matrix.isCompressed())
+    {
+        gsSparseMatrix<T> compressed = matrix;
+        compressed.makeCompressed();
+        write(name,compressed);
+        return;
+    }
+    gsMatrix<index_t> size(2,1);
+    size << matrix.rows(), matrix.cols();
+    write(name + ".size",size);
+    writeRecord(name + ".outer",internal::checkpoint_record::integer,matrix.outerSize()+1,1,
+                reinterpret_cast<const char *>(matrix.outerIndexPtr()),(matrix.outerSize()+1)*sizeof(index_t));
+    writeRecord(name + ".inner",internal::checkpoint_record::integer,matrix.nonZeros(),1,
+                reinterpret_cast<const char *>(matrix.innerIndexPtr()),matrix.nonZeros()*sizeof(index_t));
+    writeRecord(name + ".values",internal::checkpoint_record::real,matrix.nonZeros(),1,
+                reinterpret_cast<const char *>(matrix.valuePtr()),matrix.nonZeros()*sizeof(T));
+}
+
+template <class T>
+void gsCheckpointWriter<T>::writeBasis(std::string const & name, const gsBasis<T> & basis)
+{
+    // NURBS bases are stored as the underlying B-spline basis and the weights
+    const gsBasis<T> & source = basis.isRational() ? basis.source() : basis;
+    write(name + ".rational",index_t(basis.isRational()));
+    write(name + ".dim",index_t(source.dim()));
+    for (short_t d = 0; d < source.dim(); ++d)
+    {
+        const gsKnotVector<T> * knots = internal::checkpointKnots(source,d);
+        GISMO_ENSURE(knots != nullptr,"Only tensor B-spline and NURBS bases can be written to a checkpoint.\n");
+        gsMatrix<T> knotValues(knots->size(),1);
+        std::copy(knots->begin(),knots->end(),knotValues.data());
+        write(name + ".degree[" + util::to_string(d) + "]",index_t(knots->degree()));
+        write(name + ".knots[" + util::to_string(d) + "]",knotValues);
+    }
+    if (basis.isRational())
+        write(name + ".weights",basis.weights());
+}
+
+template <class T>
+void gsCheckpointWriter<T>::writeTopology(std::string const & name, const gsBoxTopology & topology)
+{
+    const index_t dim = topology.dim();
+    gsMatrix<index_t> boundaries(2,topology.boundaries().size());
+    for (size_t i = 0; i < topology.boundaries().size(); ++i)
+    {
+        boundaries(0,i) = topology.boundaries()[i].patch;
+        boundaries(1,i) = topology.boundaries()[i].index();
+    }
+    // every interface: patch and side of both boxes, direction map and orientation
+    gsMatrix<index_t> interfaces(4+2*dim,topology.interfaces().size());
+    for (size_t i = 0; i < topology.interfaces().size(); ++i)
+    {
+        const boundaryInterface & bi = topology.interfaces()[i];
+        interfaces(0,i) = bi.first().patch;
+        interfaces(1,i) = bi.first().index();
+        interfaces(2,i) = bi.second().patch;
+        interfaces(3,i) = bi.second().index();
+        for (index_t d = 0; d < dim; ++d)
+        {
+            interfaces(4+d,i) = bi.dirMap()(d);
+            interfaces(4+dim+d,i) = bi.dirOrientation()(d);
+        }
+    }
+    write(name + ".dim",dim);
+    write(name + ".boundaries",boundaries);
+    write(name + ".interfaces",interfaces);
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const gsMultiPatch<T> & multiPatch)
+{
+    write(name,index_t(multiPatch.nPatches()));
+    for (size_t p = 0; p < multiPatch.nPatches(); ++p)
+    {
+        const std::string patchName = name + "[" + util::to_string(p) + "]";
+        writeBasis(patchName,multiPatch.patch(p).basis());
+        write(patchName + ".coefs",multiPatch.patch(p).coefs());
+    }
+    writeTopology(name,multiPatch);
+}
+
+template <class T>
+void gsCheckpointWriter<T>::write(std::string const & name, const gsMultiBasis<T> & multiBasis)
+{
+    write(name,index_t(multiBasis.nBases()));
+    for (size_t p = 0; p < multiBasis.nBases(); ++p)
+        writeBasis(name + "[" + util::to_string(p) + "]",multiBasis.basis(p));
+    writeTopology(name,multiBasis.topology());
+}
+
+template <class T>
+void gsCheckpointWriter<T>::writeCoefs(std::string const & name, const gsMultiPatch<T> & multiPatch)
+{
+    write(name,index_t(multiPatch.nPatches()));
+    for (size_t p = 0; p < multiPatch.nPatches(); ++p)
+        write(name + "[" + util::to_string(p) + "]",multiPatch.patch(p).coefs());
+}
+
+template <class T>
+void gsCheckpointWriter<T>::close()
+{
+    m_file.close();
+    GISMO_ENSURE(!m_file.fail(),"Writing the checkpoint file " + m_fileName + ".part failed.\n");
+    const std::string part = m_fileName + ".part";
+    const std::string backup = m_fileName + ".bak";
+    // rename does not replace existing files on every platform; in this case, the previous checkpoint
+    // is moved aside and only deleted once the new one is in place
+    if (std::rename(part.c_str(),m_fileName.c_str()) != 0)
+    {
+        std::remove(backup.c_str());
+        const bool movedAside = std::rename(m_fileName.c_str(),backup.c_str()) == 0;
+        if (std::rename(part.c_str(),m_fileName.c_str()) != 0)
+        {
+            if (movedAside)
+                std::rename(backup.c_str(),m_fileName.c_str());
+            GISMO_ERROR("Cannot replace the checkpoint file " + m_fileName + ". The new checkpoint is kept in " + part + ".\n");
+        }
+        std::remove(backup.c_str());
+    }
+}
+
+//--------------------------------------------------------------------------------//
+
+template <class T>
+gsCheckpointReader<T>::gsCheckpointReader(std::string const & fileName)
+    : m_fileName(fileName)
+{
+    m_file.open(m_fileName.c_str(),std::ios::binary);
+    GISMO_ENSURE(m_file.good(),"Cannot open the checkpoint file " + m_fileName + ".\n");
+
+    char magic[sizeof(internal::checkpointMagic)];
+    uint32_t header[3];
+    readData(magic,sizeof(magic));
+    GISMO_ENSURE(std::equal(magic,magic+sizeof(magic),internal::checkpointMagic),
+                 m_fileName + " is not a checkpoint file.\n");
+    readData(reinterpret_cast<char *>(header),sizeof(header));
+    GISMO_ENSURE(header[0] == internal::checkpointVersion,"Checkpoint " + m_fileName + " has version " +
+                 util::to_string(header[0]) + ". Supported version: " + util::to_string(internal::checkpointVersion) + ".\n");
+    GISMO_ENSURE(header[1] == sizeof(T) && header[2] == sizeof(index_t),
+                 "Checkpoint " + m_fileName + " was written with different real or index types.\n");
+}
+
+template <class T>
+void gsCheckpointReader<T>::readData(char * data, size_t bytes)
+{
+    m_file.read(data,bytes);
+    GISMO_ENSURE(size_t(m_file.gcount()) == bytes,"Unexpected end of the checkpoint file " + m_fileName + ".\n");
+}
+
+template <class T>
+void gsCheckpointReader<T>::readHeader(std::string const & name, unsigned char type, index_t & rows, index_t & cols)
+{
+    uint32_t nameLength;
+    readData(reinterpret_cast<char *>(&nameLength),sizeof(nameLength));
+    GISMO_ENSURE(nameLength < 1024,"Checkpoint " + m_fileName + " is corrupted.\n");
+    std::string found(nameLength,' ');
+    if (nameLength > 0)
+        readData(&found[0],nameLength);
+    unsigned char foundType;
+    int64_t size[2];
+    readData(reinterpret_cast<char *>(&foundType),sizeof(foundType));
+    readData(reinterpret_cast<char *>(size),sizeof(size));
+    GISMO_ENSURE(found == name && foundType == type,"Checkpoint " + m_fileName + " does not match the setup: expected \"" +
+                 name + "\", found \"" + found + "\".\n");
+    rows = size[0];
+    cols = size[1];
+}
+
+template <class T>
+void gsCheckpointReader<T>::section(std::string const & name)
+{
+    index_t rows, cols;
+    readHeader(name,internal::checkpoint_record::section,rows,cols);
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, gsMatrix<T> & matrix)
+{
+    index_t rows, cols;
+    readHeader(name,internal::checkpoint_record::real,rows,cols);
+    // the data is read directly into the storage of the matrix
+    matrix.resize(rows,cols);
+    readData(reinterpret_cast<char *>(matrix.data()),matrix.size()*sizeof(T));
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, std::vector<gsMatrix<T> > & matrices)
+{
+    index_t size;
+    read(name,size);
+    matrices.resize(size);
+    for (index_t i = 0; i < size; ++i)
+        read(name + "[" + util::to_string(i) + "]",matrices[i]);
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, T & value)
+{
+    index_t rows, cols;
+    readHeader(name,internal::checkpoint_record::real,rows,cols);
+    GISMO_ENSURE(rows == 1 && cols == 1,"Checkpoint " + m_fileName + ": \"" + name + "\" is not a scalar.\n");
+    readData(reinterpret_cast<char *>(&value),sizeof(T));
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, index_t & value)
+{
+    index_t rows, cols;
+    readHeader(name,internal::checkpoint_record::integer,rows,cols);
+    GISMO_ENSURE(rows == 1 && cols == 1,"Checkpoint " + m_fileName + ": \"" + name + "\" is not a scalar.\n");
+    readData(reinterpret_cast<char *>(&value),sizeof(index_t));
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, gsMatrix<index_t> & matrix)
+{
+    index_t rows, cols;
+    readHeader(name,internal::checkpoint_record::integer,rows,cols);
+    matrix.resize(rows,cols);
+    readData(reinterpret_cast<char *>(matrix.data()),matrix.size()*sizeof(index_t));
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, gsSparseMatrix<T> & matrix)
+{
+    gsMatrix<index_t> size;
+    read(name + ".size",size);
+    GISMO_ENSURE(size.size() == 2,"Checkpoint " + m_fileName + ": \"" + name + "\" is corrupted.\n");
+    matrix.resize(size(0),size(1));
+    index_t rows, cols;
+    // the arrays are read directly into the compressed storage of the matrix
+    readHeader(name + ".outer",internal::checkpoint_record::integer,rows,cols);
+    GISMO_ENSURE(rows == matrix.outerSize()+1 && cols == 1,"Checkpoint " + m_fileName + ": \"" + name + "\" is corrupted.\n");
+    readData(reinterpret_cast<char *>(matrix.outerIndexPtr()),rows*sizeof(index_t));
+    readHeader(name + ".inner",internal::checkpoint_record::integer,rows,cols);
+    GISMO_ENSURE(rows == matrix.outerIndexPtr()[matrix.outerSize()] && cols == 1,
+                 "Checkpoint " + m_fileName + ": \"" + name + "\" is corrupted.\n");
+    matrix.resizeNonZeros(rows);
+    readData(reinterpret_cast<char *>(matrix.innerIndexPtr()),rows*sizeof(index_t));
+    readHeader(name + ".values",internal::checkpoint_record::real,rows,cols);
+    GISMO_ENSURE(rows == matrix.nonZeros() && cols == 1,"Checkpoint " + m_fileName + ": \"" + name + "\" is corrupted.\n");
+    readData(reinterpret_cast<char *>(matrix.valuePtr()),rows*sizeof(T));
+}
+
+template <class T>
+typename gsBasis<T>::uPtr gsCheckpointReader<T>::readBasis(std::string const & name)
+{
+    index_t rational, dim;
+    read(name + ".rational",rational);
+    read(name + ".dim",dim);
+    std::vector<gsKnotVector<T> > knots(dim);
+    for (index_t d = 0; d < dim; ++d)
+    {
+        index_t degree;
+        gsMatrix<T> knotValues;
+        read(name + ".degree[" + util::to_string(d) + "]",degree);
+        read(name + ".knots[" + util::to_string(d) + "]",knotValues);
+        knots[d] = gsKnotVector<T>(std::vector<T>(knotValues.data(),knotValues.data()+knotValues.size()),degree);
+    }
+    gsMatrix<T> weights;
+    if (rational)
+        read(name + ".weights",weights);
+
+    switch (dim)
+    {
+    case 1:
+    {
+        gsBSplineBasis<T> * bspline = new gsBSplineBasis<T>(knots[0]);
+        if (rational)
+            return typename gsBasis<T>::uPtr(new gsNurbsBasis<T>(bspline,weights));
+        return typename gsBasis<T>::uPtr(bspline);
+    }
+    case 2:
+    {
+        gsTensorBSplineBasis<2,T> * bspline = new gsTensorBSplineBasis<2,T>(knots[0],knots[1]);
+        if (rational)
+            return typename gsBasis<T>::uPtr(new gsTensorNurbsBasis<2,T>(bspline,weights));
+        return typename gsBasis<T>::uPtr(bspline);
+    }
+    case 3:
+    {
+        gsTensorBSplineBasis<3,T> * bspline = new gsTensorBSplineBasis<3,T>(knots[0],knots[1],knots[2]);
+        if (rational)
+            return typename gsBasis<T>::uPtr(new gsTensorNurbsBasis<3,T>(bspline,weights));
+        return typename gsBasis<T>::uPtr(bspline);
+    }
+    default:
+        GISMO_ERROR("Checkpoint " + m_fileName + ": \"" + name + "\" has unsupported dimension.\n");
+    }
+}
+
+template <class T>
+void gsCheckpointReader<T>::readTopology(std::string const & name, gsBoxTopology & topology)
+{
+    index_t dim;
+    gsMatrix<index_t> boundaries, interfaces;
+    read(name + ".dim",dim);
+    read(name + ".boundaries",boundaries);
+    read(name + ".interfaces",interfaces);
+    GISMO_ENSURE(interfaces.rows() == 4+2*dim,"Checkpoint " + m_fileName + ": \"" + name + "\" is corrupted.\n");
+
+    for (index_t i = 0; i < boundaries.cols(); ++i)
+        topology.addBoundary(patchSide(boundaries(0,i),boxSide(boundaries(1,i))));
+    gsVector<index_t> dirMap(dim);
+    gsVector<bool> dirOrientation(dim);
+    for (index_t i = 0; i < interfaces.cols(); ++i)
+    {
+        for (index_t d = 0; d < dim; ++d)
+        {
+            dirMap(d) = interfaces(4+d,i);
+            dirOrientation(d) = interfaces(4+dim+d,i) != 0;
+        }
+        topology.addInterface(boundaryInterface(patchSide(interfaces(0,i),boxSide(interfaces(1,i))),
+                                                patchSide(interfaces(2,i),boxSide(interfaces(3,i))),
+                                                dirMap,dirOrientation));
+    }
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, gsMultiPatch<T> & multiPatch)
+{
+    index_t numPatches;
+    read(name,numPatches);
+    multiPatch.clear();
+    for (index_t p = 0; p < numPatches; ++p)
+    {
+        const std::string patchName = name + "[" + util::to_string(p) + "]";
+        typename gsBasis<T>::uPtr basis = readBasis(patchName);
+        gsMatrix<T> coefs;
+        read(patchName + ".coefs",coefs);
+        multiPatch.addPatch(basis->makeGeometry(coefs));
+    }
+    readTopology(name,multiPatch);
+}
+
+template <class T>
+void gsCheckpointReader<T>::read(std::string const & name, gsMultiBasis<T> & multiBasis)
+{
+    index_t numBases;
+    read(name,numBases);
+    multiBasis.clear();
+    for (index_t p = 0; p < numBases; ++p)
+        multiBasis.addBasis(readBasis(name + "[" + util::to_string(p) + "]"));
+    readTopology(name,multiBasis.topology());
+}
+
+template <class T>
+void gsCheckpointReader<T>::readCoefs(std::string const & name, gsMultiPatch<T> & multiPatch)
+{
+    index_t numPatches;
+    read(name,numPatches);
+    GISMO_ENSURE(numPatches == index_t(multiPatch.nPatches()),"Checkpoint " + m_fileName + ": \"" + name + "\" has " +
+                 util::to_string(numPatches) + " patches. Must be: " + util::to_string(multiPatch.nPatches()) + ".\n");
+    for (index_t p = 0; p < numPatches; ++p)
+    {
+        const std::string patchName = name + "[" + util::to_string(p) + "]";
+        gsMatrix<T> & coefs = multiPatch.patch(p).coefs();
+        index_t rows, cols;
+        readHeader(patchName,internal::checkpoint_record::real,rows,cols);
+        GISMO_ENSURE(rows == coefs.rows() && cols == coefs.cols(),"Checkpoint " + m_fileName + ": \"" + patchName +
+                     "\" does not match the discretization.\n");
+        readData(reinterpret_cast<char *>(coefs.data()),coefs.size()*sizeof(T));
+    }
+}
+
+} // namespace ends
@@ -0,0 +1,10 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsCheckpoint.h>
+#include <gsElasticity/gsCheckpoint.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsCheckpointWriter<real_t>;
+    CLASS_TEMPLATE_INST gsCheckpointReader<real_t>;
+}
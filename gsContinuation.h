@@ -0,0 +1,111 @@
+/** @file gsContinuation.h
+
+    @brief A continuation driver for nonlinear problems with adaptive load stepping and arc-length control.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsIO/gsOptionList.h>
+#include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsIterative.h>
+
+namespace gismo
+{
+
+template <class T>
+class gsBaseAssembler;
+
+/** @brief Advances a nonlinear problem from zero to full load by a sequence of load steps.
+ * The load parameter lambda in [0,1] scales the ForceScaling option of the assembler
+ * and/or the Dirichlet values that the assembler holds at construction.
+ * The load increment is adapted to the number of Newton iterations of the previous step,
+ * and the initial guess for every step is extrapolated from the two last converged states (secant predictor).
+ * Load-controlled steps are solved with gsIterative (see solver() for its options).
+ * Optionally, the driver switches to arc-length control after the first step to pass limit points;
+ * the last step always lands on lambda = 1 with load control.
+ * Arc-length control is only available for force loading.
+*/
+template <class T>
+class gsContinuation
+{
+public:
+    gsContinuation(gsBaseAssembler<T> & assembler_);
+
+    /// default option list. used for initialization
+    static gsOptionList defaultOptions();
+
+    /// get options list to read or set parameters
+    gsOptionList & options() { return m_options; }
+
+    /// Newton's solver used for load-controlled steps; its stopping criteria
+    /// and linear solver are also used by the arc-length corrector
+    gsIterative<T> & solver() { return newton; }
+
+    /// continuation procedure from zero to full load; returns true if lambda = 1 is reached
+    bool solve();
+
+    /// returns the solution vector at the last converged load step
+    const gsMatrix<T> & solution() const { return solVector; }
+
+    /// returns the fixed degrees of freedom at the last converged load step
+    const std::vector<gsMatrix<T> > & allFixedDofs() const { return fixedDoFs; }
+
+    /// load parameter at the last converged load step
+    T loadParameter() const { return lambda; }
+
+    /// number of converged load steps
+    index_t numberSteps() const { return numSteps; }
+
+    /// total number of Newton iterations (= tangent assemblies), including rejected steps
+    index_t numberIterations() const { return numIterations; }
+
+protected:
+    /// load-controlled step to a given load parameter with a secant predictor
+    bool loadStep(T newLambda);
+
+    /// arc-length step with a secant predictor and a corrector on the normal plane (Riks);
+    /// a step converged at lambda >= 1 is not accepted and is reported by overshoot
+    bool arcLengthStep(T arcLength, bool & overshoot);
+
+    /// set the force scaling and the Dirichlet values corresponding to the load parameter
+    void setLoad(T loadParameter);
+
+    /// length of the last converged increment in the scaled (solution, load) space
+    T secantNorm() const;
+
+protected:
+    /// assembler object that generates the linear system
+    gsBaseAssembler<T> & assembler;
+    /// Newton's solver for load-controlled steps
+    gsIterative<T> newton;
+    /// full loading: force scaling and Dirichlet values at lambda = 1
+    T fullForceScaling;
+    std::vector<gsMatrix<T> > fullFixedDoFs;
+    /// converged states: current and previous
+    gsMatrix<T> solVector, solVecPrev;
+    std::vector<gsMatrix<T> > fixedDoFs;
+    T lambda, lambdaPrev;
+    /// load vector (derivative of the negative residual w.r.t. lambda) for arc-length control
+    gsMatrix<T> loadVector;
+    /// ---- status variables ----- ///
+    index_t numSteps; /// number of converged load steps
+    index_t numIterations; /// total number of Newton iterations
+    index_t stepIterations; /// number of Newton iterations of the last step
+    /// option list
+    gsOptionList m_options;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsContinuation.hpp)
+#endif
@@ -0,0 +1,287 @@
+/** @file gsContinuation.hpp
+
+    @brief Implementation of gsContinuation.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsContinuation.h>
+
+#include <gsElasticity/gsBaseAssembler.h>
+
+namespace gismo
+{
+
+template <class T>
+gsContinuation<T>::gsContinuation(gsBaseAssembler<T> & assembler_)
+    : assembler(assembler_),
+      newton(assembler_),
+      fullForceScaling(1.),
+      lambda(0.),
+      lambdaPrev(0.),
+      numSteps(0),
+      numIterations(0),
+      stepIterations(0),
+      m_options(defaultOptions())
+{}
+
+template <class T>
+gsOptionList gsContinuation<T>::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addInt("Load","Loading scaled by the load parameter: force, Dirichlet or both",continuation_load::both);
+    /// load stepping
+    opt.addReal("InitStep","Initial load increment",0.1);
+    opt.addReal("MinStep","Minimal load increment; relative to the initial arc length for arc-length control",1e-3);
+    opt.addReal("MaxStep","Maximal load increment",1.);
+    opt.addInt("TargetIters","Desired number of Newton iterations per load step",5);
+    opt.addInt("MaxSteps","Maximum number of load steps",100);
+    /// arc-length control
+    opt.addSwitch("ArcLength","Switch to arc-length control after the first load step (force loading only)",false);
+    opt.addReal("ArcScaling","Scaling of the load parameter in the arc length",1.);
+    /// additional setting
+    opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    return opt;
+}
+
+template <class T>
+bool gsContinuation<T>::solve()
+{
+    const bool useArcLength = m_options.getSwitch("ArcLength");
+    GISMO_ENSURE(!useArcLength || m_options.getInt("Load") == continuation_load::force,
+                 "Arc-length control is only available for force loading.");
+    const index_t verbosity = m_options.getInt("Verbosity");
+
+    // full loading as currently set in the assembler
+    fullForceScaling = assembler.options().askReal("ForceScaling",1.);
+    fullFixedDoFs = assembler.allFixedDofs();
+    // zero load
+    solVector.setZero(assembler.numDofs(),1);
+    solVecPrev = solVector;
+    fixedDoFs = fullFixedDoFs;
+    if (m_options.getInt("Load") != continuation_load::force)
+        for (size_t d = 0; d < fixedDoFs.size(); ++d)
+            fixedDoFs[d].setZero();
+    lambda = 0.;
+    lambdaPrev = 0.;
+    numSteps = 0;
+    numIterations = 0;
+    // Dirichlet values of every step are given to the solver directly; no increments are eliminated
+    assembler.homogenizeFixedDofs(-1);
+
+    T step = m_options.getReal("InitStep");
+    T arcLength = 0., initArcLength = 0.;
+    bool success = true;
+    while (lambda < 1.)
+    {
+        if (numSteps == m_options.getInt("MaxSteps"))
+        {
+            success = false;
+            break;
+        }
+        // arc-length control starts after the first load-controlled step
+        const bool arcPhase = useArcLength && numSteps > 0;
+        // the last step lands exactly on the full load with load control
+        const bool last = arcPhase ? lambda + arcLength*(lambda-lambdaPrev)/secantNorm() >= 1.
+                                   : lambda + step >= 1.;
+        const bool arc = arcPhase && !last;
+        bool overshoot = false;
+        bool converged = arc ? arcLengthStep(arcLength,overshoot) : loadStep(last ? 1. : lambda + step);
+        // the corrector may converge beyond the full load; then the full load is reached
+        // with load control from the last state below it
+        if (overshoot)
+        {
+            if (verbosity != solver_verbosity::none)
+                gsInfo << "Arc-length step passed the full load, switching to load control\n";
+            converged = loadStep(1.);
+        }
+
+        // adapt the increment to the number of Newton iterations
+        T factor = T(m_options.getInt("TargetIters"))/math::max(stepIterations,(index_t)1);
+        factor = math::min(math::max(factor,(T)0.5),(T)2.);
+        if (converged)
+        {
+            ++numSteps;
+            if (verbosity != solver_verbosity::none)
+                gsInfo << "Load step " << numSteps << ": lambda = " << lambda
+                       << ", Newton iterations: " << stepIterations << std::endl;
+            if (arc)
+                arcLength *= factor;
+            else
+            {
+                step = math::min(math::max(step*factor,m_options.getReal("MinStep")),m_options.getReal("MaxStep"));
+                if (useArcLength && lambda < 1.)
+                {
+                    // initial arc length from the load-controlled step
+                    arcLength = initArcLength = factor*secantNorm();
+                    // the negative residual is linear in the force scaling
+                    setLoad(1.);
+                    assembler.assembleResidual(solVector,fixedDoFs);
+                    loadVector = assembler.rhs();
+                    setLoad(0.);
+                    assembler.assembleResidual(solVector,fixedDoFs);
+                    loadVector -= assembler.rhs();
+                }
+            }
+        }
+        else
+        {
+            if (verbosity != solver_verbosity::none)
+                gsInfo << "Load step rejected at lambda = " << lambda << ", reducing the increment\n";
+            if (arcPhase)
+                arcLength *= 0.5;
+            else
+                step *= 0.5;
+            if ((arcPhase && arcLength < m_options.getReal("MinStep")*initArcLength) ||
+                (!arcPhase && step < m_options.getReal("MinStep")))
+            {
+                success = false;
+                break;
+            }
+        }
+    }
+
+    // only the load-controlled step lands exactly on the full load
+    success = success && lambda == 1.;
+    if (verbosity != solver_verbosity::none)
+    {
+        if (success)
+            gsInfo << "Continuation reached full load after ";
+        else
+            gsInfo << "Continuation stopped at lambda = " << lambda << " after ";
+        gsInfo << numSteps << " load step(s) and " << numIterations << " Newton iteration(s).\n";
+    }
+
+    // restore the full loading in the assembler
+    setLoad(1.);
+    assembler.setFixedDofs(fullFixedDoFs);
+    return success;
+}
+
+template <class T>
+bool gsContinuation<T>::loadStep(T newLambda)
+{
+    setLoad(newLambda);
+    std::vector<gsMatrix<T> > newFixedDoFs = fullFixedDoFs;
+    if (m_options.getInt("Load") != continuation_load::force)
+        for (size_t d = 0; d < newFixedDoFs.size(); ++d)
+            newFixedDoFs[d] *= newLambda;
+    // secant predictor
+    gsMatrix<T> guess = solVector;
+    if (numSteps > 0 && lambda > lambdaPrev)
+        guess += (newLambda-lambda)/(lambda-lambdaPrev)*(solVector-solVecPrev);
+
+    newton.reset();
+    newton.setSolutionVector(guess);
+    newton.setFixedDofs(newFixedDoFs);
+    newton.solve();
+    stepIterations = newton.numberIterations();
+    numIterations += stepIterations;
+    if (newton.solverStatus() != solver_status::converged)
+        return false;
+
+    solVecPrev = solVector;
+    lambdaPrev = lambda;
+    solVector = newton.solution();
+    fixedDoFs = newton.allFixedDofs();
+    lambda = newLambda;
+    return true;
+}
+
+template <class T>
+bool gsContinuation<T>::arcLengthStep(T arcLength, bool & overshoot)
+{
+    overshoot = false;
+    const gsOptionList & opt = newton.options();
+    const T psi2 = math::pow(m_options.getReal("ArcScaling"),2);
+    // secant predictor scaled to the arc length
+    const T scale = arcLength/secantNorm();
+    const gsMatrix<T> duPred = scale*(solVector-solVecPrev);
+    const T dlPred = scale*(lambda-lambdaPrev);
+    gsMatrix<T> u = solVector + duPred;
+    T l = lambda + dlPred;
+
+    gsVector<T> a, b, du;
+    T initResidualNorm = 1., initUpdateNorm = 1.;
+    for (stepIterations = 0; stepIterations < opt.getInt("MaxIters");)
+    {
+        setLoad(l);
+        ++stepIterations;
+        if (!assembler.assemble(u,fixedDoFs))
+            break;
+        // tangent solves for the negative residual and for the load vector
+        if (opt.getInt("Solver") == linear_solver::LDLT)
+        {
+            gsSparseSolver<>::SimplicialLDLT solver(assembler.matrix());
+            a = solver.solve(assembler.rhs());
+            b = solver.solve(loadVector);
+        }
+        else
+        {
+            gsSparseSolver<>::LU solver(assembler.matrix());
+            a = solver.solve(assembler.rhs());
+            b = solver.solve(loadVector);
+        }
+        // corrector on the plane orthogonal to the predictor (Riks)
+        T constraint = (u-solVector-duPred).col(0).dot(duPred.col(0)) + psi2*(l-lambda-dlPred)*dlPred;
+        T dl = -(constraint + duPred.col(0).dot(a))/(duPred.col(0).dot(b) + psi2*dlPred);
+        du = a + dl*b;
+        u += du;
+        l += dl;
+
+        T residualNorm = assembler.rhs().norm();
+        T updateNorm = du.norm();
+        if (stepIterations == 1)
+        {
+            initResidualNorm = residualNorm;
+            initUpdateNorm = updateNorm;
+        }
+        if (opt.getInt("Verbosity") == solver_verbosity::all)
+            gsInfo << "Arc-length it: " << stepIterations << ", lambda: " << l
+                   << ", updAbs: " << updateNorm << ", resAbs: " << residualNorm << std::endl;
+        if (residualNorm < opt.getReal("AbsTol") ||
+            updateNorm < opt.getReal("AbsTol") ||
+            residualNorm/initResidualNorm < opt.getReal("RelTol") ||
+            updateNorm/initUpdateNorm < opt.getReal("RelTol"))
+        {
+            numIterations += stepIterations;
+            if (l >= 1.)
+            {   // the converged state is discarded
+                overshoot = true;
+                return false;
+            }
+            solVecPrev = solVector;
+            lambdaPrev = lambda;
+            solVector = u;
+            lambda = l;
+            return true;
+        }
+    }
+    numIterations += stepIterations;
+    return false;
+}
+
+template <class T>
+void gsContinuation<T>::setLoad(T loadParameter)
+{
+    if (m_options.getInt("Load") != continuation_load::dirichlet)
+        assembler.options().setReal("ForceScaling",loadParameter*fullForceScaling);
+}
+
+template <class T>
+T gsContinuation<T>::secantNorm() const
+{
+    return math::sqrt((solVector-solVecPrev).squaredNorm() +
+                      math::pow(m_options.getReal("ArcScaling")*(lambda-lambdaPrev),2));
+}
+
+} // namespace ends
@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsContinuation.h>
+#include <gsElasticity/gsContinuation.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsContinuation<real_t>;
+}
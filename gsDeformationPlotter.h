@@ -0,0 +1,78 @@
+/** @file gsDeformationPlotter.h
+
+    @brief Streaming output of a deforming isogeometric domain to Paraview.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsPiecewiseFunction.h>
+#include <gsElasticity/gsBaseUtils.h>
+
+#include <fstream>
+
+namespace gismo
+{
+
+/** @brief Plots deformed configurations of a domain one displacement at a time.
+ *
+ * A streaming alternative to plotDeformation(initDomain,displacements,...): addStep() plots the initial domain
+ * deformed by the given displacement and the displacement can be discarded right afterwards,
+ * so the memory does not grow with the number of steps.
+ * Only the requested files are written: the deformed isoparametric mesh (fileName<step>_<patch>.vtp)
+ * and, if numSamplingPoints > 0, the Jacobian determinant of the deformed configuration (fileName<step>_<patch>.vts).
+ * The collections fileName_mesh.pvd and fileName_jac.pvd are appended after every step
+ * and are valid at any time, e.g. while the simulation is still running.
+*/
+template <class T>
+class gsDeformationPlotter
+{
+public:
+    gsDeformationPlotter(const gsMultiPatch<T> & initDomain, std::string const & fileName,
+                         index_t numSamplingPoints = 10000, vtk_format::format format = vtk_format::ascii);
+
+    /// plot the initial domain deformed by the displacement as the next step
+    void addStep(const gsMultiPatch<T> & displacement);
+
+    /// plot the undeformed initial domain as the next step
+    void addStep();
+
+    /// number of plotted steps
+    index_t numSteps() const { return m_step; }
+
+protected:
+    /// write the files for the current configuration and append them to the collections
+    void writeStep();
+
+    /// write the closing tags of a collection and move the write position back in front of them,
+    /// so that the next entries overwrite the closing tags
+    static void closeCollection(std::ofstream & file);
+
+protected:
+    std::string m_fileName;
+    index_t m_numSamples;
+    vtk_format::format m_format;
+    index_t m_step;
+    /// control points of the initial domain
+    std::vector<gsMatrix<T> > m_initCoefs;
+    /// current deformed configuration and its Jacobian determinant
+    gsMultiPatch<T> m_configuration;
+    gsPiecewiseFunction<T> m_dets;
+    std::ofstream m_collectionMesh;
+    std::ofstream m_collectionJac;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsDeformationPlotter.hpp)
+#endif
@@ -0,0 +1,118 @@
+/** @file gsDeformationPlotter.hpp
+
+    @brief Implementation of gsDeformationPlotter.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsDeformationPlotter.h>
+
+#include <gsElasticity/gsElasticityFunctions.h>
+#include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsCore/gsField.h>
+#include <gsUtils/gsMesh/gsMesh.h>
+
+namespace gismo
+{
+
+template <class T>
+gsDeformationPlotter<T>::gsDeformationPlotter(const gsMultiPatch<T> & initDomain, std::string const & fileName,
+                                              index_t numSamplingPoints, vtk_format::format format)
+    : m_fileName(fileName),
+      m_numSamples(numSamplingPoints),
+      m_format(format),
+      m_step(0)
+{
+    for (size_t p = 0; p < initDomain.nPatches(); ++p)
+    {
+        m_initCoefs.push_back(initDomain.patch(p).coefs());
+        m_configuration.addPatch(initDomain.patch(p).clone());
+        m_dets.addPiecePointer(new gsDetFunction<T>(m_configuration,p));
+    }
+
+    m_collectionMesh.open((m_fileName + "_mesh.pvd").c_str());
+    m_collectionMesh << "<?xml version=\"1.0\"?>\n"
+                     << "<VTKFile type=\"Collection\" version=\"0.1\">\n<Collection>\n";
+    closeCollection(m_collectionMesh);
+    if (m_numSamples > 0)
+    {
+        m_collectionJac.open((m_fileName + "_jac.pvd").c_str());
+        m_collectionJac << "<?xml version=\"1.0\"?>\n"
+                        << "<VTKFile type=\"Collection\" version=\"0.1\">\n<Collection>\n";
+        closeCollection(m_collectionJac);
+    }
+}
+
+template <class T>
+void gsDeformationPlotter<T>::addStep(const gsMultiPatch<T> & displacement)
+{
+    GISMO_ENSURE(m_configuration.nPatches() == displacement.nPatches(), "Wrong number of patches! Geometry has " +
+                 util::to_string(m_configuration.nPatches()) + " patches. Displacement has " +
+                 util::to_string(displacement.nPatches()) + " patches.");
+    // the configuration is recomputed from the initial domain, so no error accumulates over the steps
+    for (size_t p = 0; p < m_configuration.nPatches(); ++p)
+        m_configuration.patch(p).coefs() = m_initCoefs[p] + displacement.patch(p).coefs();
+    writeStep();
+}
+
+template <class T>
+void gsDeformationPlotter<T>::addStep()
+{
+    for (size_t p = 0; p < m_configuration.nPatches(); ++p)
+        m_configuration.patch(p).coefs() = m_initCoefs[p];
+    writeStep();
+}
+
+template <class T>
+void gsDeformationPlotter<T>::writeStep()
+{
+    const std::string fileNameOnly = m_fileName.substr(m_fileName.find_last_of("/\\")+1);
+    const std::string stepName = util::to_string(m_step) + "_";
+
+    gsField<T> detField(m_configuration,m_dets,true);
+    std::map<std::string,const gsField<T> *> fields;
+    fields["Jacobian"] = &detField;
+
+    for (size_t p = 0; p < m_configuration.nPatches(); ++p)
+    {
+        const std::string patchName = stepName + util::to_string(p);
+
+        gsMesh<T> mesh(m_configuration.basis(p),8);
+        m_configuration.patch(p).evaluateMesh(mesh);
+        gsWriteParaviewMesh(mesh,m_fileName + patchName,m_format);
+        m_collectionMesh << "<DataSet timestep=\"" << m_step << "\" part=\"" << p
+                         << "\" file=\"" << fileNameOnly << patchName << ".vtp\"/>\n";
+
+        if (m_numSamples > 0)
+        {
+            gsWriteParaviewMultiPhysicsSinglePatch(fields,p,m_fileName + patchName,m_numSamples,m_format);
+            m_collectionJac << "<DataSet timestep=\"" << m_step << "\" part=\"" << p
+                            << "\" file=\"" << fileNameOnly << patchName << ".vts\"/>\n";
+        }
+    }
+
+    closeCollection(m_collectionMesh);
+    if (m_numSamples > 0)
+        closeCollection(m_collectionJac);
+    ++m_step;
+}
+
+template <class T>
+void gsDeformationPlotter<T>::closeCollection(std::ofstream & file)
+{
+    const std::streampos end = file.tellp();
+    file << "</Collection>\n</VTKFile>\n";
+    file.flush();
+    file.seekp(end);
+}
+
+} // namespace ends
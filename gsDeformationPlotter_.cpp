@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsDeformationPlotter.h>
+#include <gsElasticity/gsDeformationPlotter.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsDeformationPlotter<real_t>;
+}
@@ -0,0 +1,72 @@
+/** @file gsDiscretizationCache.h
+
+    @brief Binary cache of refined geometries and bases for fast startup.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+/** @brief Stores a geometry and its refined bases in a binary file, so that the next runs
+ * do not have to parse the XML input and to repeat the refinement.
+ *
+ * The cache is identified by the contents of the source file and a key which must describe
+ * all refinement parameters, e.g. "r3_d1". A modified source file or another key lead to
+ * another cache file; outdated cache files are not deleted. Only tensor B-spline and NURBS bases are supported.
+ *
+ * Usage:
+ * \code
+ * gsDiscretizationCache<> cache(filename,"r" + util::to_string(numUniRef));
+ * if (!cache.load(geometry,basis))
+ * {
+ *     gsReadFile<>(filename,geometry);
+ *     basis = gsMultiBasis<>(geometry);
+ *     for (index_t i = 0; i < numUniRef; ++i)
+ *         basis.uniformRefine();
+ *     cache.save(geometry,basis);
+ * }
+ * \endcode
+*/
+template <class T>
+class gsDiscretizationCache
+{
+public:
+    gsDiscretizationCache(std::string const & sourceFile, std::string const & key,
+                          std::string const & cacheDir = ".");
+
+    /// read the geometry and the bases from the cache; returns false if there is no valid cache
+    bool load(gsMultiPatch<T> & geometry, std::vector<gsMultiBasis<T> *> const & bases) const;
+    bool load(gsMultiPatch<T> & geometry, gsMultiBasis<T> & basis) const
+    { return load(geometry,std::vector<gsMultiBasis<T> *>(1,&basis)); }
+
+    /// write the geometry and the bases to the cache
+    void save(const gsMultiPatch<T> & geometry, std::vector<const gsMultiBasis<T> *> const & bases) const;
+    void save(const gsMultiPatch<T> & geometry, const gsMultiBasis<T> & basis) const
+    { save(geometry,std::vector<const gsMultiBasis<T> *>(1,&basis)); }
+
+    /// name of the cache file
+    const std::string & fileName() const { return m_fileName; }
+
+protected:
+    std::string m_key;
+    std::string m_fileName;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsDiscretizationCache.hpp)
+#endif
@@ -0,0 +1,90 @@
+/** @file gsDiscretizationCache.hpp
+
+    @brief Implementation of gsDiscretizationCache.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsDiscretizationCache.h>
+
+#include <gsElasticity/gsCheckpoint.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace gismo
+{
+
+template <class T>
+gsDiscretizationCache<T>::gsDiscretizationCache(std::string const & sourceFile, std::string const & key,
+                                                std::string const & cacheDir)
+    : m_key(key)
+{
+    std::ifstream source(sourceFile.c_str(),std::ios::binary);
+    GISMO_ENSURE(source.good(),"Cannot open the source file " + sourceFile + ".\n");
+    std::ostringstream contents;
+    contents << source.rdbuf() << '\0' << key;
+
+    // 64-bit FNV-1a hash of the source file and the key
+    uint64_t hash = 14695981039346656037ULL;
+    const std::string & data = contents.str();
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    std::string stem = sourceFile.substr(sourceFile.find_last_of("/\\")+1);
+    stem = stem.substr(0,stem.find_last_of('.'));
+    std::ostringstream name;
+    name << cacheDir << "/" << stem << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".gsbin";
+    m_fileName = name.str();
+}
+
+template <class T>
+bool gsDiscretizationCache<T>::load(gsMultiPatch<T> & geometry, std::vector<gsMultiBasis<T> *> const & bases) const
+{
+    if (!std::ifstream(m_fileName.c_str()).good())
+        return false;
+    try
+    {
+        gsCheckpointReader<T> reader(m_fileName);
+        reader.section("gsDiscretizationCache " + m_key);
+        reader.read("geometry",geometry);
+        index_t numBases;
+        reader.read("numBases",numBases);
+        GISMO_ENSURE(numBases == index_t(bases.size()),"The cache contains " + util::to_string(numBases) + " bases.\n");
+        for (size_t i = 0; i < bases.size(); ++i)
+            reader.read("basis" + util::to_string(i),*bases[i]);
+    }
+    catch (std::exception & e)
+    {
+        gsWarn << "Ignoring the discretization cache " << m_fileName << ": " << e.what();
+        return false;
+    }
+    return true;
+}
+
+template <class T>
+void gsDiscretizationCache<T>::save(const gsMultiPatch<T> & geometry, std::vector<const gsMultiBasis<T> *> const & bases) const
+{
+    gsCheckpointWriter<T> writer(m_fileName);
+    writer.section("gsDiscretizationCache " + m_key);
+    writer.write("geometry",geometry);
+    writer.write("numBases",index_t(bases.size()));
+    for (size_t i = 0; i < bases.size(); ++i)
+        writer.write("basis" + util::to_string(i),*bases[i]);
+    writer.close();
+}
+
+} // namespace ends
@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsDiscretizationCache.h>
+#include <gsElasticity/gsDiscretizationCache.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsDiscretizationCache<real_t>;
+}
@@ -16,6 +16,8 @@
 
 #include <gsElasticity/gsBaseAssembler.h>
 #include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsSharedPatternMatrix.h>
+#include <gsSolver/gsSparseSolver.h>
 
 namespace gismo
 {
@@ -24,8 +26,18 @@ template <class T>
 class gsElasticityAssembler;
 template <class T>
 class gsMassAssembler;
+template <class T>
+class gsCheckpointWriter;
+template <class T>
+class gsCheckpointReader;
 
 /** @brief Time integation for equations of dynamic elasticity with implicit schemes
+ * or with the explicit central difference scheme (explicit_lumped uses a lumped mass matrix).
+ * Uses the Newmark scheme with parameters Beta and Gamma or, if the option SpectralRadius is set to
+ * a value in [0,1], the generalized-alpha scheme of Chung and Hulbert with controlled dissipation
+ * of high frequencies: M*a_n+1-alphaM = (1-alphaF)*R(u_n+1) + alphaF*R(u_n), where R = F_ext - F_int.
+ * A consistent mass matrix is factorized or, with the option MassCG, inverted by CG with the row-sum
+ * lumped mass matrix as a diagonal preconditioner.
 */
 template <class T>
 class gsElTimeIntegrator : public gsBaseAssembler<T>
@@ -66,6 +78,10 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
 
+    /// assemble only the residual of the time-discrete system; the matrix is not updated
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
     /// return the number of free degrees of freedom
     virtual int numDofs() const { return stiffAssembler.numDofs(); }
 
@@ -91,6 +107,13 @@ public:
     /// recover solver state from saved state
     void recoverState();
 
+    /// write the solver state to a checkpoint; the saved state is not written
+    void writeCheckpoint(gsCheckpointWriter<T> & writer);
+
+    /// restore the solver state from a checkpoint, including the state of the stiffness assembler
+    /// which is carried over between time steps; the mass matrix is reassembled
+    void readCheckpoint(gsCheckpointReader<T> & reader);
+
     /// number of iterations Newton's method required at the last time step
     index_t numberIterations() const { return numIters;}
 
@@ -104,17 +127,54 @@ public:
 protected:
     void initialize();
 
+    /// assemble the static residual F_ext - F_int (including the Dirichlet lifting) into the stiffness assembler
+    void staticResidual(const gsMatrix<T> & displacement);
+
+    /// assemble the mass matrix and factorize it if it is neither lumped nor solved iteratively
+    void assembleMass();
+
+    /// swap the current state with the back buffers
+    void swapBuffers();
+    /// move the saved state from the back buffers to the storage before it is overwritten
+    void keepSavedState();
+
     /// time integraton schemes
+    void explicitCentral();
     gsMatrix<T> implicitLinear();
     gsMatrix<T> implicitNonlinear();
 
+    /// mass matrix times a vector; a vector operation for a lumped mass matrix
+    gsMatrix<T> massTimes(const gsMatrix<T> & vector) const;
+    /// inverse mass matrix times a vector
+    gsMatrix<T> massSolve(const gsMatrix<T> & vector);
+    /// inverse consistent mass matrix times a vector by CG preconditioned with the row-sum lumped mass matrix
+    gsMatrix<T> massSolveCG(const gsMatrix<T> & vector) const;
+
+    /// generalized-alpha parameters; alphaM = alphaF = 0 for the Newmark scheme
+    bool genAlpha() const { return m_options.getReal("SpectralRadius") >= 0.; }
+    T alphaM() const
+    {
+        T rho = m_options.getReal("SpectralRadius");
+        return genAlpha() ? (2*rho-1)/(rho+1) : 0.;
+    }
+    T alphaF() const
+    {
+        T rho = m_options.getReal("SpectralRadius");
+        return genAlpha() ? rho/(rho+1) : 0.;
+    }
+    T beta() const { return genAlpha() ? pow(1-alphaM()+alphaF(),2)/4 : m_options.getReal("Beta"); }
+    T gamma() const { return genAlpha() ? 0.5-alphaM()+alphaF() : m_options.getReal("Gamma"); }
+
     /// time integration scheme coefficients
-    T alpha1() {return 1./m_options.getReal("Beta")/pow(tStep,2); }
-    T alpha2() {return 1./m_options.getReal("Beta")/tStep; }
-    T alpha3() {return (1-2*m_options.getReal("Beta"))/2/m_options.getReal("Beta"); }
-    T alpha4() {return m_options.getReal("Gamma")/m_options.getReal("Beta")/tStep; }
-    T alpha5() {return 1 - m_options.getReal("Gamma")/m_options.getReal("Beta"); }
-    T alpha6() {return (1-m_options.getReal("Gamma")/m_options.getReal("Beta")/2)*tStep; }
+    T alpha1() {return 1./beta()/pow(tStep,2); }
+    T alpha2() {return 1./beta()/tStep; }
+    T alpha3() {return (1-2*beta())/2/beta(); }
+    T alpha4() {return gamma()/beta()/tStep; }
+    T alpha5() {return 1 - gamma()/beta(); }
+    T alpha6() {return (1-gamma()/beta()/2)*tStep; }
+
+    /// part of the right-hand side that only depends on the previous time step
+    void historyRHS(gsMatrix<T> & rhs);
 
 protected:
     /// assembler object that generates the static system
@@ -131,17 +191,37 @@ protected:
     gsMatrix<T> velVector;
     /// vector of acceleration DoFs
     gsMatrix<T> accVector;
+    /// static residual F_ext - F_int at the previous time step (generalized-alpha)
+    gsMatrix<T> oldResVector;
+    /// factorized consistent mass matrix (initial acceleration and explicit scheme)
+    typename gsSparseSolver<T>::SimplicialLDLT massSolver;
+    /// diagonal of the lumped mass matrix; empty if the mass matrix is consistent
+    gsMatrix<T> massDiagonal;
+    /// row sums of the consistent mass matrix; diagonal preconditioner for MassCG
+    gsMatrix<T> massRowSums;
+    /// combine the stiffness and the mass matrices on a shared pattern;
+    /// one object per scheme so that switching schemes does not invalidate the cached pattern
+    gsSharedPatternMatrix<T> linearCombination;
+    gsSharedPatternMatrix<T> nonlinearCombination;
     using Base::m_system;
     using Base::m_options;
     using Base::m_ddof;
     /// number of iterations Newton's method took to converge at the last time step
     index_t numIters;
 
-    /// saved state
+    /// back buffers: the new state during a time step, the previous state after it
+    gsMatrix<T> dispVecBack;
+    gsMatrix<T> velVecBack;
+    gsMatrix<T> accVecBack;
+    gsMatrix<T> resVecBack;
+
+    /// saved state; the vectors are used only if more than one time step is made before recovering
     bool hasSavedState;
+    index_t stepsSinceSave;
     gsMatrix<T> dispVecSaved;
     gsMatrix<T> velVecSaved;
     gsMatrix<T> accVecSaved;
+    gsMatrix<T> oldResVecSaved;
     std::vector<gsMatrix<T> > ddofsSaved;
 };
 
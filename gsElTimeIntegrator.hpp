@@ -20,6 +20,7 @@
 #include <gsElasticity/gsElasticityAssembler.h>
 #include <gsElasticity/gsMassAssembler.h>
 #include <gsElasticity/gsIterative.h>
+#include <gsElasticity/gsCheckpoint.h>
 
 namespace gismo
 {
@@ -35,6 +36,7 @@ gsElTimeIntegrator<T>::gsElTimeIntegrator(gsElasticityAssembler<T> & stiffAssemb
     m_ddof = stiffAssembler.allFixedDofs();
     numIters = 0;
     hasSavedState = false;
+    stepsSinceSave = 0;
 }
 
 template <class T>
@@ -44,6 +46,11 @@ gsOptionList gsElTimeIntegrator<T>::defaultOptions()
     opt.addInt("Scheme","Time integration scheme",time_integration::implicit_linear);
     opt.addReal("Beta","Parameter beta for the time integration scheme, see Wriggers, Nonlinear FEM, p.213 ",0.25);
     opt.addReal("Gamma","Parameter gamma for the time integration scheme, see Wriggers, Nonlinear FEM, p.213 ",0.5);
+    opt.addReal("SpectralRadius","Spectral radius at infinite frequency for the generalized-alpha scheme: "
+                                 "0 - maximal damping, 1 - no damping; negative - Newmark with Beta and Gamma",-1.);
+    opt.addSwitch("MassCG","Solve with the consistent mass matrix by CG preconditioned with the row-sum lumped "
+                           "mass matrix instead of factorizing it",false);
+    opt.addReal("MassCGTol","Relative tolerance of MassCG",1e-10);
     opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
     return opt;
 }
@@ -55,47 +62,194 @@ void gsElTimeIntegrator<T>::initialize()
                  "No initial conditions provided!");
     GISMO_ENSURE(velVector.rows() == stiffAssembler.numDofs(),
                  "No initial conditions provided!");
-    stiffAssembler.assemble(dispVector,m_ddof);
-    massAssembler.assemble();
+    staticResidual(dispVector);
+    assembleMass();
 
-    gsSparseSolver<>::SimplicialLDLT solver(massAssembler.matrix());
-    accVector = solver.solve(stiffAssembler.rhs());
+    accVector = massSolve(stiffAssembler.rhs());
+    oldResVector = stiffAssembler.rhs();
 
     initialized = true;
 }
 
+template <class T>
+void gsElTimeIntegrator<T>::staticResidual(const gsMatrix<T> & displacement)
+{
+    // the lifting of the Dirichlet DoFs eliminated by the stiffness assembler comes with the matrix assembly,
+    // so the residual-only assembly is used only if there is nothing to lift
+    bool homogeneous = true;
+    for (size_t d = 0; d < stiffAssembler.allFixedDofs().size() && homogeneous; ++d)
+        homogeneous = stiffAssembler.fixedDofs(d).isZero(0.);
+    if (homogeneous)
+        stiffAssembler.assembleResidual(displacement,m_ddof);
+    else
+        stiffAssembler.assemble(displacement,m_ddof);
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::assembleMass()
+{
+    // explicit_lumped requires a lumped mass matrix; if the user chose a consistent one,
+    // the row-sum lumped diagonal is computed here and the mass assembler is left as it is
+    const bool rowSumLumping = m_options.getInt("Scheme") == time_integration::explicit_lumped &&
+                               !massAssembler.lumped();
+    massAssembler.assemble(rowSumLumping);
+    massDiagonal.resize(0,0);
+    massRowSums.resize(0,0);
+    if (massAssembler.lumped())
+        massDiagonal = massAssembler.lumpedMass();
+    else if (rowSumLumping)
+        massDiagonal = massAssembler.rowSums();
+    else if (m_options.getSwitch("MassCG"))
+        massRowSums = massAssembler.matrix()*gsMatrix<T>::Ones(massAssembler.numDofs(),1);
+    else
+        gsProfiledFactorize(massSolver,massAssembler.matrix());
+}
+
 template <class T>
 void gsElTimeIntegrator<T>::makeTimeStep(T timeStep)
 {
+    ELAST_PROFILE_REGION("elasticity time step");
     if (!initialized)
         initialize();
 
+    // the back buffers hold the saved state which is about to be overwritten; keep it
+    if (hasSavedState && stepsSinceSave == 1)
+        keepSavedState();
+
     tStep = timeStep;
-    gsMatrix<T> newDispVector;
-    if (m_options.getInt("Scheme") == time_integration::implicit_linear)
-        newDispVector = implicitLinear();
-    if (m_options.getInt("Scheme") == time_integration::implicit_nonlinear)
-        newDispVector = implicitNonlinear();
-    gsMatrix<T> tempVelVector = velVector;
-    velVector = alpha4()*(newDispVector - dispVector) + alpha5()*tempVelVector + alpha6()*accVector;
-    accVector = alpha1()*(newDispVector - dispVector) - alpha2()*tempVelVector - alpha3()*accVector;
-    dispVector = newDispVector;
+    // the new state is written to the back buffers and swapped with the current state at the end
+    if (m_options.getInt("Scheme") == time_integration::explicit_ ||
+        m_options.getInt("Scheme") == time_integration::explicit_lumped)
+        explicitCentral();
+    else
+    {
+        GISMO_ENSURE(m_options.getReal("SpectralRadius") <= 1.,
+                     "Spectral radius for the generalized-alpha scheme must not exceed 1");
+        if (m_options.getInt("Scheme") == time_integration::implicit_linear)
+            dispVecBack = implicitLinear();
+        if (m_options.getInt("Scheme") == time_integration::implicit_nonlinear)
+            dispVecBack = implicitNonlinear();
+        velVecBack = alpha4()*(dispVecBack - dispVector) + alpha5()*velVector + alpha6()*accVector;
+        accVecBack = alpha1()*(dispVecBack - dispVector) - alpha2()*velVector - alpha3()*accVector;
+        // the balance equation yields the new static residual without an extra assembly
+        if (genAlpha())
+            resVecBack = (massTimes((1-alphaM())*accVecBack + alphaM()*accVector) -
+                          alphaF()*oldResVector)/(1-alphaF());
+    }
+    swapBuffers();
+    ++stepsSinceSave;
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::swapBuffers()
+{
+    dispVector.swap(dispVecBack);
+    velVector.swap(velVecBack);
+    accVector.swap(accVecBack);
+    if (genAlpha())
+        oldResVector.swap(resVecBack);
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::keepSavedState()
+{
+    dispVecSaved.swap(dispVecBack);
+    velVecSaved.swap(velVecBack);
+    accVecSaved.swap(accVecBack);
+    if (genAlpha())
+        oldResVecSaved.swap(resVecBack);
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::historyRHS(gsMatrix<T> & rhs)
+{
+    rhs = massTimes((1-alphaM())*(alpha1()*dispVector + alpha2()*velVector + alpha3()*accVector) -
+                    alphaM()*accVector);
+    if (genAlpha())
+        rhs += alphaF()*oldResVector;
+}
+
+template <class T>
+gsMatrix<T> gsElTimeIntegrator<T>::massTimes(const gsMatrix<T> & vector) const
+{
+    if (massDiagonal.rows() > 0)
+        return massDiagonal.cwiseProduct(vector);
+    return massAssembler.matrix()*vector;
+}
+
+template <class T>
+gsMatrix<T> gsElTimeIntegrator<T>::massSolve(const gsMatrix<T> & vector)
+{
+    if (massDiagonal.rows() > 0)
+        return vector.cwiseQuotient(massDiagonal);
+    if (massRowSums.rows() > 0)
+        return massSolveCG(vector);
+    return gsProfiledSolve(massSolver,vector);
+}
+
+template <class T>
+gsMatrix<T> gsElTimeIntegrator<T>::massSolveCG(const gsMatrix<T> & vector) const
+{
+    ELAST_PROFILE_REGION("solve");
+    // the lumped mass matrix is spectrally equivalent to the consistent one,
+    // so the number of iterations does not grow with the mesh refinement
+    const gsSparseMatrix<T> & M = massAssembler.matrix();
+    gsMatrix<T> result(vector.rows(),vector.cols());
+    gsVector<T> x, r, z, p, Mp;
+    index_t iters = 0;
+    for (index_t c = 0; c < vector.cols(); ++c)
+    {
+        // the lumped solution is the initial guess
+        x = vector.col(c).cwiseQuotient(massRowSums.col(0));
+        r = vector.col(c) - M*x;
+        z = r.cwiseQuotient(massRowSums.col(0));
+        p = z;
+        T rz = r.dot(z);
+        const T tol = m_options.getReal("MassCGTol")*vector.col(c).norm();
+        for (index_t i = 0; i < M.rows() && r.norm() > tol; ++i, ++iters)
+        {
+            Mp = M*p;
+            const T alpha = rz/p.dot(Mp);
+            x += alpha*p;
+            r -= alpha*Mp;
+            z = r.cwiseQuotient(massRowSums.col(0));
+            const T rzNew = r.dot(z);
+            p = z + rzNew/rz*p;
+            rz = rzNew;
+        }
+        result.col(c) = x;
+    }
+    ELAST_PROFILE_COUNT("Krylov iterations",iters);
+    return result;
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::explicitCentral()
+{
+    // central difference scheme in the velocity Verlet form (Newmark with beta = 0, gamma = 1/2)
+    dispVecBack = dispVector + tStep*velVector + tStep*tStep/2*accVector;
+    staticResidual(dispVecBack);
+    accVecBack = massSolve(stiffAssembler.rhs());
+    velVecBack = velVector + tStep/2*(accVector + accVecBack);
+    numIters = 1;
 }
 
 template <class T>
 gsMatrix<T> gsElTimeIntegrator<T>::implicitLinear()
 {
-    m_system.matrix() = alpha1()*massAssembler.matrix() + stiffAssembler.matrix();
-    m_system.matrix().makeCompressed();
-    m_system.rhs() = massAssembler.matrix()*(alpha1()*dispVector + alpha2()*velVector + alpha3()*accVector) + stiffAssembler.rhs();
+    linearCombination.combine(1-alphaF(),stiffAssembler.matrix(),(1-alphaM())*alpha1(),massAssembler.matrix(),m_system.matrix());
+    historyRHS(m_system.rhs());
+    m_system.rhs() += (1-alphaF())*stiffAssembler.rhs();
+    numIters = 1;
 #ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(m_system.matrix());
-    return solver.solve(m_system.rhs());
+    gsSparseSolver<>::PardisoLDLT solver;
+    gsProfiledFactorize(solver,m_system.matrix());
+    return gsProfiledSolve(solver,m_system.rhs());
 #else
-    gsSparseSolver<>::SimplicialLDLT solver(m_system.matrix());
-    return solver.solve(m_system.rhs());
+    gsSparseSolver<>::SimplicialLDLT solver;
+    gsProfiledFactorize(solver,m_system.matrix());
+    return gsProfiledSolve(solver,m_system.rhs());
 #endif
-    numIters = 1;
 }
 
 template <class T>
@@ -113,11 +267,22 @@ template <class T>
 bool gsElTimeIntegrator<T>::assemble(const gsMatrix<T> & solutionVector,
                                      const std::vector<gsMatrix<T> > & fixedDoFs)
 {
-    stiffAssembler.assemble(solutionVector,fixedDoFs);
-    m_system.matrix() = alpha1()*massAssembler.matrix() + stiffAssembler.matrix();
-    m_system.matrix().makeCompressed();
-    m_system.rhs() = stiffAssembler.rhs() +
-                     massAssembler.matrix()*(alpha1()*(dispVector-solutionVector) + alpha2()*velVector + alpha3()*accVector);
+    if (!stiffAssembler.assemble(solutionVector,fixedDoFs))
+        return false;
+    nonlinearCombination.combine(1-alphaF(),stiffAssembler.matrix(),(1-alphaM())*alpha1(),massAssembler.matrix(),m_system.matrix());
+    historyRHS(m_system.rhs());
+    m_system.rhs() += (1-alphaF())*stiffAssembler.rhs() - (1-alphaM())*alpha1()*massTimes(solutionVector);
+    return true;
+}
+
+template <class T>
+bool gsElTimeIntegrator<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                             const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    if (!stiffAssembler.assembleResidual(solutionVector,fixedDoFs))
+        return false;
+    historyRHS(m_system.rhs());
+    m_system.rhs() += (1-alphaF())*stiffAssembler.rhs() - (1-alphaM())*alpha1()*massTimes(solutionVector);
     return true;
 }
 
@@ -132,9 +297,9 @@ void gsElTimeIntegrator<T>::saveState()
 {
     if (!initialized)
         initialize();
-    dispVecSaved = dispVector;
-    velVecSaved = velVector;
-    accVecSaved = accVector;
+    // nothing is copied: the saved state remains the current one until the next time step
+    // and then goes to the back buffers
+    stepsSinceSave = 0;
     ddofsSaved = m_ddof;
     hasSavedState = true;
 }
@@ -143,11 +308,79 @@ template <class T>
 void gsElTimeIntegrator<T>::recoverState()
 {
     GISMO_ENSURE(hasSavedState,"No state saved!");
-    dispVector = dispVecSaved;
-    velVector = velVecSaved;
-    accVector = accVecSaved;
+    // after one time step, the saved state is in the back buffers
+    if (stepsSinceSave == 1)
+        swapBuffers();
+    // after several time steps, it has been moved to the storage for the saved state
+    else if (stepsSinceSave > 1)
+    {
+        dispVector = dispVecSaved;
+        velVector = velVecSaved;
+        accVector = accVecSaved;
+        if (genAlpha())
+            oldResVector = oldResVecSaved;
+    }
+    stepsSinceSave = 0;
     m_ddof = ddofsSaved;
 }
 
+template <class T>
+void gsElTimeIntegrator<T>::writeCheckpoint(gsCheckpointWriter<T> & writer)
+{
+    if (!initialized)
+        initialize();
+    writer.section("gsElTimeIntegrator");
+    writer.write("Scheme",index_t(m_options.getInt("Scheme")));
+    writer.write("displacement",dispVector);
+    writer.write("velocity",velVector);
+    writer.write("acceleration",accVector);
+    writer.write("residual",oldResVector);
+    writer.write("fixedDofs",m_ddof);
+    writer.write("numIters",numIters);
+    // the stiffness assembler holds the Dirichlet DoFs of its lifting and, for the linear scheme,
+    // the system which is reused at every time step; both are stored instead of being reassembled
+    writer.write("assemblerFixedDofs",stiffAssembler.allFixedDofs());
+    if (m_options.getInt("Scheme") == time_integration::implicit_linear)
+    {
+        writer.write("stiffMatrix",stiffAssembler.matrix());
+        writer.write("stiffRhs",stiffAssembler.rhs());
+    }
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::readCheckpoint(gsCheckpointReader<T> & reader)
+{
+    index_t scheme;
+    reader.section("gsElTimeIntegrator");
+    reader.read("Scheme",scheme);
+    GISMO_ENSURE(scheme == m_options.getInt("Scheme"),"Checkpoint was written with a different time integration scheme.");
+    reader.read("displacement",dispVector);
+    reader.read("velocity",velVector);
+    reader.read("acceleration",accVector);
+    reader.read("residual",oldResVector);
+    reader.read("fixedDofs",m_ddof);
+    reader.read("numIters",numIters);
+    GISMO_ENSURE(dispVector.rows() == stiffAssembler.numDofs(),"Checkpoint does not match the discretization.");
+    std::vector<gsMatrix<T> > assemblerDdofs;
+    reader.read("assemblerFixedDofs",assemblerDdofs);
+    stiffAssembler.setFixedDofs(assemblerDdofs);
+    if (m_options.getInt("Scheme") == time_integration::implicit_linear)
+    {
+        gsSparseMatrix<T> stiffMatrix;
+        gsMatrix<T> stiffRhs;
+        reader.read("stiffMatrix",stiffMatrix);
+        reader.read("stiffRhs",stiffRhs);
+        stiffAssembler.setMatrix(stiffMatrix);
+        stiffAssembler.setRHS(stiffRhs);
+    }
+
+    // the mass matrix depends only on the reference configuration; reassembling it yields the same values
+    // as long as the assembly is deterministic (see gsPartitionedFSI::readCheckpoint)
+    assembleMass();
+    initialized = true;
+    hasSavedState = false;
+    stepsSinceSave = 0;
+}
+
 
 } // namespace ends
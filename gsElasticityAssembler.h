@@ -18,6 +18,7 @@
 #include <gsElasticity/gsBaseAssembler.h>
 #include <gsElasticity/gsElasticityFunctions.h>
 #include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -61,18 +62,32 @@ public:
     /// Assembles the tangential linear system for Newton's method given the current solution
     /// in the form of free and fixed/Dirichelt degrees of freedom.
     /// Checks if the current solution is valid (Newton's solver can exit safely if invalid).
+    /// The check is performed by the element visitors during assembly (see jacobianCheck()).
     virtual bool assemble(const gsMatrix<T> & solutionVector,
-                          const std::vector<gsMatrix<T> > & fixedDoFs);
+                          const std::vector<gsMatrix<T> > & fixedDoFs)
+    { return assembleIteration(solutionVector,fixedDoFs,true); }
+
+    /// Assembles only the residual given the current solution; the tangential matrix is left untouched.
+    /// Skips the computation of the elasticity tensor and the tangent at the quadrature points.
+    /// ATTENTION: rhs() returns a negative residual (-r) !!!
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs)
+    { return assembleIteration(solutionVector,fixedDoFs,false); }
 protected:
+    /// common part of the full and residual-only assembly for Newton's method
+    bool assembleIteration(const gsMatrix<T> & solutionVector,
+                           const std::vector<gsMatrix<T> > & fixedDoFs, bool assembleMatrix);
+
     /// @ brief Assembles the tangential matrix and the residual for a iteration of Newton's method for displacement formulation;
     /// set *assembleMatrix* to false to only assemble the residual;
     /// ATTENTION: rhs() returns a negative residual (-r) !!!
-    virtual void assemble(const gsMultiPatch<T> & displacement);
+    virtual void assemble(const gsMultiPatch<T> & displacement, bool assembleMatrix = true);
 
     /// @ brief Assembles the tangential matrix and the residual for a iteration of Newton's method for mixed formulation;
     /// set *assembleMatrix* to false to only assemble the residual;
     /// ATTENTION: rhs() returns a negative residual (-r) !!!
-    virtual void assemble(const gsMultiPatch<T> & displacement, const gsMultiPatch<T> & pressure);
+    virtual void assemble(const gsMultiPatch<T> & displacement, const gsMultiPatch<T> & pressure,
+                          bool assembleMatrix = true);
 
     //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
 
@@ -105,6 +120,14 @@ public:
                                  gsPiecewiseFunction<T> & result,
                                  stress_components::components component = stress_components::von_mises) const;
 
+    /// @brief Set an external load vector (for example, from gsFsiInterfaceLoad) which is added to the RHS
+    /// after the volume and surface integrals; the vector must be given for the free DoFs and is scaled by ForceScaling.
+    /// The assembler stores a pointer, so updating the vector updates the load. Pass nullptr to remove the load.
+    void setExternalLoad(const gsMatrix<T> * load) { externalLoad = load; }
+
+    /// @brief Result of the bijectivity check performed during the last nonlinear assembly
+    const gsJacobianCheck<T> & jacobianCheck() const { return jacCheck; }
+
 protected:
     /// a custom reserve function to allocate memory for the sparse matrix
     virtual void reserve();
@@ -113,6 +136,10 @@ protected:
     /// Dimension of the problem
     /// parametric dim = physical dim = deformation dim
     short_t m_dim;
+    /// external load vector for the free DoFs; not owned
+    const gsMatrix<T> * externalLoad;
+    /// shared record of the bijectivity check for the element visitors
+    gsJacobianCheck<T> jacCheck;
 
     using Base::m_pde_ptr;
     using Base::m_bases;
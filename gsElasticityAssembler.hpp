@@ -37,6 +37,7 @@ gsElasticityAssembler<T>::gsElasticityAssembler(const gsMultiPatch<T> & patches,
                                                 const gsMultiBasis<T> & basis,
                                                 const gsBoundaryConditions<T> & bconditions,
                                                 const gsFunction<T> & body_force)
+    : externalLoad(nullptr)
 {
     // Originally concieved as a meaningful class, now gsPde is just a container for
     // the domain, boundary conditions and the right-hand side;
@@ -62,6 +63,7 @@ gsElasticityAssembler<T>::gsElasticityAssembler(gsMultiPatch<T> const & patches,
                                                 gsMultiBasis<T> const & basisPres,
                                                 gsBoundaryConditions<T> const & bconditions,
                                                 const gsFunction<T> & body_force)
+    : externalLoad(nullptr)
 {
     // same as above
     gsPiecewiseFunction<T> rightHandSides;
@@ -86,7 +88,8 @@ gsOptionList gsElasticityAssembler<T>::defaultOptions()
     opt.addReal("ForceScaling","Force scaling parameter",1.);
     opt.addInt("MaterialLaw","Material law: 0 for St. Venant-Kirchhof, 1 for Neo-Hooke",material_law::hooke);
     opt.addReal("LocalStiff","Stiffening degree for the Jacobian-based local stiffening",0.);
-    opt.addSwitch("Check","Check bijectivity of the displacement field before matrix assebmly",false);
+    opt.addSwitch("Check","Check bijectivity of the displacement field during matrix assebmly",false);
+    opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all (the invalid point of the bijectivity check)",solver_verbosity::none);
     return opt;
 }
 
@@ -172,65 +175,99 @@ void gsElasticityAssembler<T>::assemble(bool saveEliminationMatrix)
 
     // Compute surface integrals and write to the global rhs vector
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
+    // add an assembled external load, e.g. fluid load on the FSI interface
+    if (externalLoad)
+        m_system.rhs().col(0) += m_options.getReal("ForceScaling") * (*externalLoad);
 
     m_system.matrix().makeCompressed();
 }
 
 template <class T>
-bool gsElasticityAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
-                                        const std::vector<gsMatrix<T> > & fixedDoFs)
+bool gsElasticityAssembler<T>::assembleIteration(const gsMatrix<T> & solutionVector,
+                                                 const std::vector<gsMatrix<T> > & fixedDoFs,
+                                                 bool assembleMatrix)
 {
     gsMultiPatch<T> displacement;
     constructSolution(solutionVector,fixedDoFs,displacement);
-    if (m_options.getSwitch("Check"))
-        if (checkDisplacement(m_pde_ptr->patches(),displacement) != -1)
-            return false;
+    // bijectivity is checked at the quadrature points during assembly
+    jacCheck.reset();
 
     if (m_bases.size() == unsigned(m_dim)) // displacement formulation 
-        assemble(displacement);
+        assemble(displacement,assembleMatrix);
     else // mixed formulation (displacement + pressure)
     {
         gsMultiPatch<T> pressure;
         constructPressure(solutionVector,fixedDoFs,pressure);
-        assemble(displacement,pressure);
+        assemble(displacement,pressure,assembleMatrix);
+    }
+
+    // an invalid trial solution is expected during line search and trust-region backtracking;
+    // callers which treat it as an error can query jacobianCheck()
+    if (jacCheck.invalid.load())
+    {
+        if (m_options.getInt("Verbosity") == solver_verbosity::all)
+            gsInfo << "Bad patch: " << jacCheck.patch << "\nBad point:\n" << jacCheck.point << "\nDet: " << jacCheck.det << std::endl;
+        return false;
     }
     return true;
 }
 
 template<class T>
-void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement)
+void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement, bool assembleMatrix)
 {
-
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        reserve();
+    }
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear system
-    gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement);
+    gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,
+                                            m_options.getSwitch("Check") ? &jacCheck : nullptr,
+                                            assembleMatrix);
     Base::template push<gsVisitorNonLinearElasticity<T> >(visitor);
+    if (jacCheck.invalid.load()) // the system is incomplete anyway
+        return;
     // Compute surface integrals and write to the global rhs vector
     // change to reuse rhs from linear system
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
+    // add an assembled external load, e.g. fluid load on the FSI interface
+    if (externalLoad)
+        m_system.rhs().col(0) += m_options.getReal("ForceScaling") * (*externalLoad);
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
 }
 
 template<class T>
 void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement,
-                                        const gsMultiPatch<T> & pressure)
+                                        const gsMultiPatch<T> & pressure,
+                                        bool assembleMatrix)
 {
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        reserve();
+    }
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear systemz
-    gsVisitorMixedNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,pressure);
+    gsVisitorMixedNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,pressure,
+                                                 m_options.getSwitch("Check") ? &jacCheck : nullptr,
+                                                 assembleMatrix);
     Base::template push<gsVisitorMixedNonLinearElasticity<T> >(visitor);
+    if (jacCheck.invalid.load()) // the system is incomplete anyway
+        return;
     // Compute surface integrals and write to the global rhs vector
     // change to reuse rhs from linear system
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
+    // add an assembled external load, e.g. fluid load on the FSI interface
+    if (externalLoad)
+        m_system.rhs().col(0) += m_options.getReal("ForceScaling") * (*externalLoad);
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
 }
 
 //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
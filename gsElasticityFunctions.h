@@ -22,6 +22,9 @@
 namespace gismo
 {
 
+template <class T>
+class gsGridEvaluator;
+
 /** @brief Compute Cauchy stresses for a previously computed/defined displacement field.
  *         Can be pushed into gsPiecewiseFunction to construct gsField for visualization in Paraview.
 */
@@ -70,20 +73,11 @@ public:
      *         or consist of one number in case of stress_type::von_mises,
      *         or form square matrices concatinated in the col-direction.
      */
-    virtual void eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const
-    {
-        switch (material_law::law(m_options.getInt("MaterialLaw")))
-        {
-        case material_law::hooke : linearElastic(u,result); return;
-        case material_law::saint_venant_kirchhoff : nonLinearElastic(u,result); return;
-        case material_law::neo_hooke_ln : nonLinearElastic(u,result); return;
-        case material_law::neo_hooke_quad : nonLinearElastic(u,result); return;
-        case material_law::mixed_hooke : mixedLinearElastic(u,result); return;
-        case material_law::mixed_neo_hooke_ln : mixedNonLinearElastic(u,result); return;
-        //case material_law::mixed_kelvin_voigt : mixedKelvinVoigt(u,result); return;
-        default: return;
-        }
-    }
+    virtual void eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const;
+
+    /// evaluate at the points of a tensor grid; the geometry, displacement and pressure are evaluated
+    /// by the fast grid evaluation if their bases are tensor-product, otherwise eval_into is used
+    void evalGrid_into(const gsGridEvaluator<T> & grid, gsMatrix<T> & result) const;
 
 protected:
 
@@ -104,11 +98,20 @@ protected:
     /// save components of the stress tensor to the output matrix according to the m_type
     void saveStress(const gsMatrix<T> & S, gsMatrix<T> & result, index_t q) const;
 
+    /// compute stresses from the jacobians of the geometry and the displacement (dim x dim*numPoints)
+    /// and the pressure values (1 x numPoints, only for mixed formulations) according to the material law
+    void computeStresses(const gsMatrix<T> & u, const gsMatrix<T> & geoJac, const gsMatrix<T> & dispJac,
+                         const gsMatrix<T> & presVals, gsMatrix<T> & result) const;
+
     /// computation routines for different material laws
-    void linearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const;
-    void nonLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const;
-    void mixedLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const;
-    void mixedNonLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const;
+    void linearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac, const gsMatrix<T> & dispJac,
+                       const gsMatrix<T> & presVals, gsMatrix<T> & result) const;
+    void nonLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac, const gsMatrix<T> & dispJac,
+                          const gsMatrix<T> & presVals, gsMatrix<T> & result) const;
+    void mixedLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac, const gsMatrix<T> & dispJac,
+                            const gsMatrix<T> & presVals, gsMatrix<T> & result) const;
+    void mixedNonLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac, const gsMatrix<T> & dispJac,
+                               const gsMatrix<T> & presVals, gsMatrix<T> & result) const;
 
 protected:
     const gsMultiPatch<T> * m_geometry;
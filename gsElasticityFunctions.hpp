@@ -16,6 +16,7 @@
 #pragma once
 
 #include <gsElasticity/gsElasticityFunctions.h>
+#include <gsElasticity/gsGridEvaluator.h>
 #include <gsCore/gsFuncData.h>
 #include <gsAssembler/gsAssembler.h>
 
@@ -23,19 +24,72 @@ namespace gismo
 {
 
 template <class T>
-void gsCauchyStressFunction<T>::linearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const
+void gsCauchyStressFunction<T>::eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const
 {
-    result.setZero(targetDim(),outputCols(u.cols()));
     // evaluating the fields
-    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
+    gsMapData<T> mdGeo(NEED_DERIV);
     mdGeo.points = u;
     m_geometry->patch(m_patch).computeMap(mdGeo);
     gsMapData<T> mdDisp(NEED_DERIV);
     mdDisp.points = u;
     m_displacement->patch(m_patch).computeMap(mdDisp);
+    gsMatrix<T> geoJac(m_dim,m_dim*u.cols()), dispJac(m_dim,m_dim*u.cols()), presVals;
+    for (index_t q = 0; q < u.cols(); ++q)
+    {
+        geoJac.middleCols(q*m_dim,m_dim) = mdGeo.jacobian(q);
+        dispJac.middleCols(q*m_dim,m_dim) = mdDisp.jacobian(q);
+    }
+    if (m_pressure != nullptr)
+        m_pressure->patch(m_patch).eval_into(u,presVals);
+    computeStresses(u,geoJac,dispJac,presVals,result);
+}
+
+template <class T>
+void gsCauchyStressFunction<T>::evalGrid_into(const gsGridEvaluator<T> & grid, gsMatrix<T> & result) const
+{
+    if (!gsGridEvaluator<T>::applicable(m_geometry->patch(m_patch).basis()) ||
+        !gsGridEvaluator<T>::applicable(m_displacement->patch(m_patch).basis()) ||
+        (m_pressure != nullptr && !gsGridEvaluator<T>::applicable(m_pressure->patch(m_patch).basis())))
+    {
+        eval_into(grid.points(),result);
+        return;
+    }
+
+    gsMatrix<T> geoJac, dispJac, presVals;
+    grid.jacobian_into(m_geometry->patch(m_patch),geoJac);
+    grid.jacobian_into(m_displacement->patch(m_patch),dispJac);
+    if (m_pressure != nullptr)
+        grid.eval_into(m_pressure->patch(m_patch),presVals);
+    computeStresses(grid.points(),geoJac,dispJac,presVals,result);
+}
+
+template <class T>
+void gsCauchyStressFunction<T>::computeStresses(const gsMatrix<T> & u, const gsMatrix<T> & geoJac,
+                                                const gsMatrix<T> & dispJac, const gsMatrix<T> & presVals,
+                                                gsMatrix<T> & result) const
+{
+    switch (material_law::law(m_options.getInt("MaterialLaw")))
+    {
+    case material_law::hooke : linearElastic(u,geoJac,dispJac,presVals,result); return;
+    case material_law::saint_venant_kirchhoff : nonLinearElastic(u,geoJac,dispJac,presVals,result); return;
+    case material_law::neo_hooke_ln : nonLinearElastic(u,geoJac,dispJac,presVals,result); return;
+    case material_law::neo_hooke_quad : nonLinearElastic(u,geoJac,dispJac,presVals,result); return;
+    case material_law::mixed_hooke : mixedLinearElastic(u,geoJac,dispJac,presVals,result); return;
+    case material_law::mixed_neo_hooke_ln : mixedNonLinearElastic(u,geoJac,dispJac,presVals,result); return;
+    //case material_law::mixed_kelvin_voigt : mixedKelvinVoigt(u,result); return;
+    default: return;
+    }
+}
+
+template <class T>
+void gsCauchyStressFunction<T>::linearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac,
+                                              const gsMatrix<T> & dispJac, const gsMatrix<T> & presVals,
+                                              gsMatrix<T> & result) const
+{
+    result.setZero(targetDim(),outputCols(u.cols()));
     // define temporary matrices here for efficieny
     gsMatrix<T> I = gsMatrix<T>::Identity(m_dim,m_dim);
-    gsMatrix<T> sigma,eps,dispGrad;
+    gsMatrix<T> sigma,eps,dispGrad,jacGeo,jacDisp;
     // material parameters
     T YM = m_options.getReal("YoungsModulus");
     T PR = m_options.getReal("PoissonsRatio");
@@ -44,12 +98,14 @@ void gsCauchyStressFunction<T>::linearElastic(const gsMatrix<T> & u, gsMatrix<T>
 
     for (index_t q = 0; q < u.cols(); ++q)
     {
+        jacGeo = geoJac.middleCols(q*m_dim,m_dim);
+        jacDisp = dispJac.middleCols(q*m_dim,m_dim);
         // linear strain tensor eps = (gradU+gradU^T)/2
-        if (mdGeo.jacobian(q).determinant() <= 0)
-            gsInfo << "Invalid domain parametrization: J = " << mdGeo.jacobian(q).determinant() <<
+        if (jacGeo.determinant() <= 0)
+            gsInfo << "Invalid domain parametrization: J = " << jacGeo.determinant() <<
                       " at point (" << u.col(q).transpose() << ") of patch " << m_patch << std::endl;
-        if (abs(mdGeo.jacobian(q).determinant()) > 1e-20)
-           dispGrad = mdDisp.jacobian(q)*(mdGeo.jacobian(q).cramerInverse());
+        if (abs(jacGeo.determinant()) > 1e-20)
+           dispGrad = jacDisp*(jacGeo.cramerInverse());
         else
             dispGrad = gsMatrix<T>::Zero(m_dim,m_dim);
         eps = (dispGrad + dispGrad.transpose())/2;
@@ -60,19 +116,14 @@ void gsCauchyStressFunction<T>::linearElastic(const gsMatrix<T> & u, gsMatrix<T>
 }
 
 template <class T>
-void gsCauchyStressFunction<T>::nonLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const
+void gsCauchyStressFunction<T>::nonLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac,
+                                                 const gsMatrix<T> & dispJac, const gsMatrix<T> & presVals,
+                                                 gsMatrix<T> & result) const
 {
     result.setZero(targetDim(),outputCols(u.cols()));
-    // evaluating the fields
-    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
-    mdGeo.points = u;
-    m_geometry->patch(m_patch).computeMap(mdGeo);
-    gsMapData<T> mdDisp(NEED_DERIV);
-    mdDisp.points = u;
-    m_displacement->patch(m_patch).computeMap(mdDisp);
     // define temporary matrices here for efficieny
     gsMatrix<T> I = gsMatrix<T>::Identity(m_dim,m_dim);
-    gsMatrix<T> S,sigma,F,C,E;
+    gsMatrix<T> S,sigma,F,C,E,jacGeo,jacDisp;
     // material parameters
     T YM = m_options.getReal("YoungsModulus");
     T PR = m_options.getReal("PoissonsRatio");
@@ -81,12 +132,14 @@ void gsCauchyStressFunction<T>::nonLinearElastic(const gsMatrix<T> & u, gsMatrix
 
     for (index_t q = 0; q < u.cols(); ++q)
     {
+        jacGeo = geoJac.middleCols(q*m_dim,m_dim);
+        jacDisp = dispJac.middleCols(q*m_dim,m_dim);
         // deformation gradient F = I + gradU*gradGeo^-1
-        if (mdGeo.jacobian(q).determinant() <= 0)
-            gsInfo << "Invalid domain parametrization: J = " << mdGeo.jacobian(q).determinant() <<
+        if (jacGeo.determinant() <= 0)
+            gsInfo << "Invalid domain parametrization: J = " << jacGeo.determinant() <<
                       " at point (" << u.col(q).transpose() << ") of patch " << m_patch << std::endl;
-        if (abs(mdGeo.jacobian(q).determinant()) > 1e-20)
-            F = I + mdDisp.jacobian(q)*(mdGeo.jacobian(q).cramerInverse());
+        if (abs(jacGeo.determinant()) > 1e-20)
+            F = I + jacDisp*(jacGeo.cramerInverse());
         else
             F = I;
         T J = F.determinant();
@@ -119,21 +172,14 @@ void gsCauchyStressFunction<T>::nonLinearElastic(const gsMatrix<T> & u, gsMatrix
 }
 
 template <class T>
-void gsCauchyStressFunction<T>::mixedLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const
+void gsCauchyStressFunction<T>::mixedLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac,
+                                                   const gsMatrix<T> & dispJac, const gsMatrix<T> & presVals,
+                                                   gsMatrix<T> & result) const
 {
     result.setZero(targetDim(),outputCols(u.cols()));
-    // evaluating the fields
-    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
-    mdGeo.points = u;
-    m_geometry->patch(m_patch).computeMap(mdGeo);
-    gsMapData<T> mdDisp(NEED_DERIV);
-    mdDisp.points = u;
-    m_displacement->patch(m_patch).computeMap(mdDisp);
-    gsMatrix<T> presVals;
-    m_pressure->patch(m_patch).eval_into(u,presVals);
     // define temporary matrices here for efficieny
     gsMatrix<T> I = gsMatrix<T>::Identity(m_dim,m_dim);
-    gsMatrix<T> sigma,eps,dispGrad;
+    gsMatrix<T> sigma,eps,dispGrad,jacGeo,jacDisp;
     // material parameters
     T YM = m_options.getReal("YoungsModulus");
     T PR = m_options.getReal("PoissonsRatio");
@@ -141,12 +187,14 @@ void gsCauchyStressFunction<T>::mixedLinearElastic(const gsMatrix<T> & u, gsMatr
 
     for (index_t q = 0; q < u.cols(); ++q)
     {
+        jacGeo = geoJac.middleCols(q*m_dim,m_dim);
+        jacDisp = dispJac.middleCols(q*m_dim,m_dim);
         // linear strain tensor eps = (gradU+gradU^T)/2
-        if (mdGeo.jacobian(q).determinant() <= 0)
-            gsInfo << "Invalid domain parametrization: J = " << mdGeo.jacobian(q).determinant() <<
+        if (jacGeo.determinant() <= 0)
+            gsInfo << "Invalid domain parametrization: J = " << jacGeo.determinant() <<
                       " at point (" << u.col(q).transpose() << ") of patch " << m_patch << std::endl;
-        if (abs(mdGeo.jacobian(q).determinant()) > 1e-20)
-           dispGrad = mdDisp.jacobian(q)*(mdGeo.jacobian(q).cramerInverse());
+        if (abs(jacGeo.determinant()) > 1e-20)
+           dispGrad = jacDisp*(jacGeo.cramerInverse());
         else
             dispGrad = gsMatrix<T>::Zero(m_dim,m_dim);
         eps = (dispGrad + dispGrad.transpose())/2;
@@ -157,21 +205,14 @@ void gsCauchyStressFunction<T>::mixedLinearElastic(const gsMatrix<T> & u, gsMatr
 }
 
 template <class T>
-void gsCauchyStressFunction<T>::mixedNonLinearElastic(const gsMatrix<T> & u, gsMatrix<T> & result) const
+void gsCauchyStressFunction<T>::mixedNonLinearElastic(const gsMatrix<T> & u, const gsMatrix<T> & geoJac,
+                                                      const gsMatrix<T> & dispJac, const gsMatrix<T> & presVals,
+                                                      gsMatrix<T> & result) const
 {
     result.setZero(targetDim(),outputCols(u.cols()));
-    // evaluating the fields
-    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
-    mdGeo.points = u;
-    m_geometry->patch(m_patch).computeMap(mdGeo);
-    gsMapData<T> mdDisp(NEED_DERIV);
-    mdDisp.points = u;
-    m_displacement->patch(m_patch).computeMap(mdDisp);
-    gsMatrix<T> presVals;
-    m_pressure->patch(m_patch).eval_into(u,presVals);
     // define temporary matrices here for efficieny
     gsMatrix<T> I = gsMatrix<T>::Identity(m_dim,m_dim);
-    gsMatrix<T> S,sigma,F,C,E;
+    gsMatrix<T> S,sigma,F,C,E,jacGeo,jacDisp;
     // material parameters
     T YM = m_options.getReal("YoungsModulus");
     T PR = m_options.getReal("PoissonsRatio");
@@ -179,12 +220,14 @@ void gsCauchyStressFunction<T>::mixedNonLinearElastic(const gsMatrix<T> & u, gsM
 
     for (index_t q = 0; q < u.cols(); ++q)
     {
-        if (mdGeo.jacobian(q).determinant() <= 0)
-            gsInfo << "Invalid domain parametrization: J = " << mdGeo.jacobian(q).determinant() <<
+        jacGeo = geoJac.middleCols(q*m_dim,m_dim);
+        jacDisp = dispJac.middleCols(q*m_dim,m_dim);
+        if (jacGeo.determinant() <= 0)
+            gsInfo << "Invalid domain parametrization: J = " << jacGeo.determinant() <<
                       " at point (" << u.col(q).transpose() << ") of patch " << m_patch << std::endl;
         // deformation gradient F = I + gradU*gradGeo^-1
-        if (abs(mdGeo.jacobian(q).determinant()) > 1e-20)
-            F = I + mdDisp.jacobian(q)*(mdGeo.jacobian(q).cramerInverse());
+        if (abs(jacGeo.determinant()) > 1e-20)
+            F = I + jacDisp*(jacGeo.cramerInverse());
         else
             F = I;
         T J = F.determinant();
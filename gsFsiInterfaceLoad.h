@@ -0,0 +1,101 @@
+/** @file gsFsiInterfaceLoad.h
+
+    @brief Assembles the fluid load acting on the structure directly into a load vector
+    using a precomputed sparse transfer operator.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+
+namespace gismo
+{
+
+template <class T>
+class gsBaseAssembler;
+
+/** @brief Transfers the fluid action to the solid as an assembled load vector.
+ * An alternative to gsFsiLoad which is evaluated as a gsFunction for every element of the solid boundary.
+ * Here, the fluid traction is evaluated once per coupling iteration at the quadrature points
+ * of the fluid side of the interface and is mapped to the free DoFs of the solid by a sparse transfer matrix.
+ * The transfer matrix integrates solid basis functions over the fluid quadrature, so the fluid and solid
+ * discretizations of the interface do not have to match.
+ * Different parametrizations can be used for the geometry+ALE and velocity+pressure (as in gsFsiLoad).
+*/
+template <class T>
+class gsFsiInterfaceLoad
+{
+public:
+
+    gsFsiInterfaceLoad(const gsBaseAssembler<T> & solidAssembler,
+                       const gsMultiPatch<T> & geoRef, const gsMultiPatch<T> & ALEdisplacement,
+                       const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
+                       T viscosity, T density);
+
+    /// add a part of the FSI interface: a side of the solid patch, the corresponding side of the ALE patch
+    /// and the flow patch that shares its parametrization with the ALE patch
+    void addInterfaceSide(index_t patchSolid, boxSide sideSolid,
+                          index_t patchALE, boxSide sideALE, index_t patchFlow);
+
+    /// precompute quadrature, geometric data and the transfer matrix;
+    /// called automatically by the first assemble() if not called before
+    void initialize();
+
+    /// evaluate the fluid traction at the interface quadrature points
+    /// and transfer it to the solid load vector (one sparse matrix-vector product)
+    void assemble();
+
+    /// load vector for the free DoFs of the solid
+    const gsMatrix<T> & vector() const { return m_load; }
+
+    /// sparse transfer matrix: numFreeSolidDofs x (dim * numQuadPoints)
+    const gsSparseMatrix<T> & transferMatrix() const { return m_transfer; }
+
+protected:
+    /// evaluate the fluid traction (scaled by the local measure) on one side of the interface
+    void evalTraction(index_t s, gsMatrix<T> & traction) const;
+
+protected:
+    /// solid assembler, used for the DoF numbering of the load vector
+    const gsBaseAssembler<T> & m_assembler;
+    /// reference geometry and ALE displacement of the flow domain
+    const gsMultiPatch<T> & m_geo;
+    const gsMultiPatch<T> & m_ale;
+    /// flow solution
+    const gsMultiPatch<T> & m_vel;
+    const gsMultiPatch<T> & m_pres;
+    T m_viscosity;
+    T m_density;
+    /// interface description: solid patch, ALE patch/side, flow patch
+    std::vector<index_t> m_patchSolid;
+    std::vector<boxSide> m_sideSolid;
+    std::vector<index_t> m_patchALE;
+    std::vector<boxSide> m_sideALE;
+    std::vector<index_t> m_patchFlow;
+    /// precomputed data for each interface side
+    std::vector<gsMatrix<T> > m_params;  // quadrature points in the ALE parametric domain
+    std::vector<gsMatrix<T> > m_invJac;  // inverse Jacobians of the reference geometry, dim x dim*numPoints
+    std::vector<gsMatrix<T> > m_normals; // outer normals of the ALE side, length equals the local measure
+    std::vector<index_t> m_offsets;      // position of the first quadrature point of the side in the global numbering
+    index_t m_numPoints;
+    short_t m_dim;
+    bool m_initialized;
+    /// transfer matrix and the resulting load vector
+    gsSparseMatrix<T> m_transfer;
+    gsMatrix<T> m_load;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsFsiInterfaceLoad.hpp)
+#endif
@@ -0,0 +1,211 @@
+/** @file gsFsiInterfaceLoad.hpp
+
+    @brief Implementation of gsFsiInterfaceLoad.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsFsiInterfaceLoad.h>
+
+#include <gsElasticity/gsBaseAssembler.h>
+#include <gsAssembler/gsGaussRule.h>
+#include <gsCore/gsFuncData.h>
+
+namespace gismo
+{
+
+template <class T>
+gsFsiInterfaceLoad<T>::gsFsiInterfaceLoad(const gsBaseAssembler<T> & solidAssembler,
+                                          const gsMultiPatch<T> & geoRef, const gsMultiPatch<T> & ALEdisplacement,
+                                          const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
+                                          T viscosity, T density)
+    : m_assembler(solidAssembler),
+      m_geo(geoRef),
+      m_ale(ALEdisplacement),
+      m_vel(velocity),
+      m_pres(pressure),
+      m_viscosity(viscosity),
+      m_density(density),
+      m_numPoints(0),
+      m_dim(geoRef.parDim()),
+      m_initialized(false)
+{
+    // zero load until the first assembly
+    m_load.setZero(m_assembler.numDofs(),1);
+}
+
+template <class T>
+void gsFsiInterfaceLoad<T>::addInterfaceSide(index_t patchSolid, boxSide sideSolid,
+                                             index_t patchALE, boxSide sideALE, index_t patchFlow)
+{
+    m_patchSolid.push_back(patchSolid);
+    m_sideSolid.push_back(sideSolid);
+    m_patchALE.push_back(patchALE);
+    m_sideALE.push_back(sideALE);
+    m_patchFlow.push_back(patchFlow);
+    m_initialized = false;
+}
+
+template <class T>
+void gsFsiInterfaceLoad<T>::initialize()
+{
+    m_params.clear();
+    m_invJac.clear();
+    m_normals.clear();
+    m_offsets.clear();
+    m_numPoints = 0;
+
+    const gsSparseSystem<T> & system = m_assembler.system();
+    gsSparseEntries<T> entries;
+    // all temporary data structures
+    gsMatrix<T> quNodes, physPoints, solidParams, basisValues;
+    gsMatrix<index_t> activeFunctions;
+    gsVector<T> quWeights, normal;
+    // NEED_VALUE to map the quadrature points to the solid parametric domain
+    // NEED_GRAD_TRANSFORM for velocity gradients transformation from parametric to reference domain
+    gsMapData<T> mdGeo(NEED_VALUE | NEED_GRAD_TRANSFORM);
+
+    for (size_t s = 0; s < m_patchALE.size(); ++s)
+    {
+        const gsBasis<T> & basis = m_geo.basis(m_patchALE[s]);
+        const boxSide side = m_sideALE[s];
+        // collect quadrature points and weights of the side; the rule is defined by the ALE basis
+        std::vector<gsMatrix<T> > nodes;
+        std::vector<gsVector<T> > weights;
+        index_t numPoints = 0;
+        gsGaussRule<T> bdQuRule(basis,1.0,1,side.direction());
+        typename gsBasis<T>::domainIter elem = basis.makeDomainIterator(side);
+        for (; elem->good(); elem->next())
+        {
+            bdQuRule.mapTo(elem->lowerCorner(),elem->upperCorner(),quNodes,quWeights);
+            nodes.push_back(quNodes);
+            weights.push_back(quWeights);
+            numPoints += quNodes.cols();
+        }
+        m_params.push_back(gsMatrix<T>(m_dim,numPoints));
+        gsVector<T> sideWeights(numPoints);
+        numPoints = 0;
+        for (size_t e = 0; e < nodes.size(); ++e)
+        {
+            m_params.back().middleCols(numPoints,nodes[e].cols()) = nodes[e];
+            sideWeights.segment(numPoints,nodes[e].cols()) = weights[e];
+            numPoints += nodes[e].cols();
+        }
+
+        // evaluate the reference geometry once: its Jacobians and normals do not change during the simulation
+        mdGeo.points = m_params.back();
+        m_geo.patch(m_patchALE[s]).computeMap(mdGeo);
+        m_invJac.push_back(gsMatrix<T>(m_dim,m_dim*numPoints));
+        m_normals.push_back(gsMatrix<T>(m_dim,numPoints));
+        for (index_t q = 0; q < numPoints; ++q)
+        {
+            m_invJac.back().middleCols(q*m_dim,m_dim) = mdGeo.jacobian(q).cramerInverse();
+            // normal length is the local measure
+            outerNormal(mdGeo,q,side,normal);
+            m_normals.back().col(q) = normal;
+        }
+
+        // map the quadrature points to the parametric domain of the solid; the interface can be nonmatching
+        physPoints = mdGeo.values[0];
+        m_assembler.patches().patch(m_patchSolid[s]).invertPoints(physPoints,solidParams);
+        // project back onto the solid side to remove the inversion error in the normal direction
+        gsMatrix<T> support = m_assembler.multiBasis(0).basis(m_patchSolid[s]).support();
+        solidParams.row(m_sideSolid[s].direction()).setConstant(support(m_sideSolid[s].direction(),
+                                                                        m_sideSolid[s].parameter()));
+
+        // transfer matrix entries: quadrature weight times the solid basis function
+        const gsBasis<T> & basisSolid = m_assembler.multiBasis(0).basis(m_patchSolid[s]);
+        index_t idx;
+        for (index_t q = 0; q < numPoints; ++q)
+        {
+            basisSolid.active_into(solidParams.col(q),activeFunctions);
+            basisSolid.eval_into(solidParams.col(q),basisValues);
+            for (index_t i = 0; i < activeFunctions.rows(); ++i)
+            {
+                if (basisValues.at(i) == 0.)
+                    continue;
+                for (short_t d = 0; d < m_dim; ++d)
+                    if (system.colMapper(d).is_free(activeFunctions.at(i),m_patchSolid[s]))
+                    {
+                        system.mapToGlobalColIndex(activeFunctions.at(i),m_patchSolid[s],idx,d);
+                        entries.add(idx,(m_numPoints+q)*m_dim+d,sideWeights.at(q)*basisValues.at(i));
+                    }
+            }
+        }
+
+        m_offsets.push_back(m_numPoints);
+        m_numPoints += numPoints;
+    }
+
+    m_transfer.resize(m_assembler.numDofs(),m_dim*m_numPoints);
+    m_transfer.setFrom(entries);
+    m_transfer.makeCompressed();
+    m_initialized = true;
+}
+
+template <class T>
+void gsFsiInterfaceLoad<T>::assemble()
+{
+    if (!m_initialized)
+        initialize();
+
+    // tractions at all interface points stored as a dim x numPoints matrix
+    gsMatrix<T> traction(m_dim,m_numPoints);
+    gsMatrix<T> sideTraction;
+    for (size_t s = 0; s < m_patchALE.size(); ++s)
+    {
+        evalTraction(s,sideTraction);
+        traction.middleCols(m_offsets[s],sideTraction.cols()) = sideTraction;
+    }
+    // column-wise storage of the traction matrix matches the column numbering of the transfer matrix
+    m_load = m_transfer * gsAsConstVector<T>(traction.data(),traction.size());
+}
+
+template <class T>
+void gsFsiInterfaceLoad<T>::evalTraction(index_t s, gsMatrix<T> & traction) const
+{
+    const gsMatrix<T> & params = m_params[s];
+    traction.setZero(m_dim,params.cols());
+    // evaluate velocity at the param points
+    // NEED_DERIV for velocity gradients
+    gsMapData<T> mdVel(NEED_DERIV);
+    mdVel.points = params;
+    m_vel.patch(m_patchFlow[s]).computeMap(mdVel);
+    // evaluate pressure at the param points
+    gsMatrix<T> pressureValues;
+    m_pres.patch(m_patchFlow[s]).eval_into(params,pressureValues);
+    // evaluate ALE dispacement at the param points
+    // NEED_DERIV for gradients
+    gsMapData<T> mdALE(NEED_DERIV);
+    mdALE.points = params;
+    m_ale.patch(m_patchALE[s]).computeMap(mdALE);
+
+    gsMatrix<T> I = gsMatrix<T>::Identity(m_dim,m_dim);
+    gsMatrix<T> physGradVel, physJacALE, invJacALE, sigma;
+    for (index_t q = 0; q < params.cols(); ++q)
+    {
+        const gsMatrix<T> invJacGeo = m_invJac[s].middleCols(q*m_dim,m_dim);
+        // transform velocity gradients from parametric to reference
+        physGradVel = mdVel.jacobian(q)*invJacGeo;
+        // ALE jacobian (identity + physical displacement gradient)
+        physJacALE = I + mdALE.jacobian(q)*invJacGeo;
+        // inverse ALE jacobian
+        invJacALE = physJacALE.cramerInverse();
+        // ALE stress tensor
+        sigma = pressureValues.at(q)*I - m_density*m_viscosity*(physGradVel*invJacALE +
+                                                                invJacALE.transpose()*physGradVel.transpose());
+        // stress tensor pull back; the normal is not normalized since its length is the local measure
+        traction.col(q) = physJacALE.determinant()*sigma*(invJacALE.transpose())*m_normals[s].col(q);
+    }
+}
+
+} // namespace ends
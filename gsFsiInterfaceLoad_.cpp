@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsFsiInterfaceLoad.h>
+#include <gsElasticity/gsFsiInterfaceLoad.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsFsiInterfaceLoad<real_t>;
+}
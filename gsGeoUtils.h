@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsCore/gsMultiPatch.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
 {
@@ -36,26 +37,46 @@ void plotGeometry(const gsMultiPatch<T> & domain, std::string const & fileName,
 
 /// use all saved displacement fields to plot the all intermediate deformed configurations of the computational domain;
 /// always plots the deformed isoparametric mesh; plots the Jacobian determinant of the deformed configuration if *numSamplingPoints* > 0
+/// (see gsDeformationPlotter to plot the displacements one at a time without storing them)
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMultiPatch<T> > & displacements,
-                     std::string fileName, index_t numSamplingPoints = 10000);
+                     std::string fileName, index_t numSamplingPoints = 10000,
+                     vtk_format::format format = vtk_format::ascii);
 
 /// plot a deformed isogeometric mesh and add it to a Paraview collection
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const gsMultiPatch<T> & displacement,
-                     std::string const & fileName, gsParaviewCollection & collection, index_t step);
+                     std::string const & fileName, gsParaviewCollection & collection, index_t step,
+                     vtk_format::format format = vtk_format::ascii);
 
 /// @brief Checks whether configuration is bijective, i.e. det(Jac(geo)) > 0;
 /// returns -1 if yes or the number of the first invalid patch;
 /// samples the Jacobian elementwise at the quadrature points and the corners
+/// or uses the Bezier coefficients of the Jacobian determinant (see checkJacobianBezier)
 template <class T>
-index_t checkGeometry(gsMultiPatch<T> const & domain);
+index_t checkGeometry(gsMultiPatch<T> const & domain,
+                      bijectivity_check::method method = bijectivity_check::sampling);
 
 /// @brief Checks whether the deformed configuration is bijective, i.e. det(Jac(geo+disp)) > 0;
 /// returns -1 if yes or the number of the first invalid patch;
 /// samples the Jacobian elementwise at the quadrature points and the corners
+/// or uses the Bezier coefficients of the Jacobian determinant (see checkJacobianBezier)
 template <class T>
-index_t checkDisplacement(gsMultiPatch<T> const & domain, gsMultiPatch<T> const & displacement);
+index_t checkDisplacement(gsMultiPatch<T> const & domain, gsMultiPatch<T> const & displacement,
+                          bijectivity_check::method method = bijectivity_check::sampling);
+
+/// @brief Certified bijectivity check of the configuration geo (or geo+disp if <displacement> is given);
+/// returns -1 if det(Jac) > 0 everywhere or the number of the first invalid patch.
+/// On each element, the Jacobian determinant (times W^(dim+1) for NURBS) is a polynomial; its Bezier coefficients
+/// are obtained by interpolation. An element is valid if all coefficients are positive and invalid if the determinant
+/// is non-positive at an interpolation node; otherwise the element is subdivided up to <maxDepth> times.
+/// If an element is still inconclusive and no invalid element is found, the result of the sampling check is returned.
+/// The geometry basis must be nested in the displacement basis, which is verified by comparing the breakpoints
+/// of tensor B-spline and NURBS bases; for NURBS, both must also share the weight function.
+/// Otherwise, and for other bases if a displacement is given, the function falls back to sampling.
+template <class T>
+index_t checkJacobianBezier(gsMultiPatch<T> const & domain, gsMultiPatch<T> const * displacement = nullptr,
+                            index_t maxDepth = 6);
 
 /// @ Compute norm of the isogeometric solution
 template <class T>
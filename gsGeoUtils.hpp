@@ -16,6 +16,8 @@
 
 #include <gsElasticity/gsGeoUtils.h>
 
+#include <atomic>
+
 #include <gsCore/gsField.h>
 #include <gsCore/gsFuncData.h>
 #include <gsCore/gsFunctionExpr.h>
@@ -28,6 +30,7 @@
 #include <gsElasticity/gsElasticityAssembler.h>
 #include <gsElasticity/gsElasticityFunctions.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsDeformationPlotter.h>
 #include <gsUtils/gsMesh/gsMesh.h>
 #include <gsIO/gsWriteParaview.h>
 
@@ -91,87 +94,27 @@ void plotGeometry(const gsMultiPatch<T> & domain, std::string const & fileName,
 
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMultiPatch<T> > & displacements,
-                                             std::string fileName, index_t numSamplingPoints)
+                                             std::string fileName, index_t numSamplingPoints,
+                                             vtk_format::format format)
 {
     gsInfo << "Plotting deformed configurations...\n";
 
-    std::string fileNameOnly = fileName.substr(fileName.find_last_of("/\\")+1);
-    gsParaviewCollection collectionMesh(fileName + "_mesh");
-    gsParaviewCollection collectionJac(fileName + "_jac");
-    index_t res;
-
-    gsMultiPatch<T> configuration;
-    for (size_t p = 0; p < initDomain.nPatches(); ++p)
-        configuration.addPatch(initDomain.patch(p).clone());
-
-    gsPiecewiseFunction<T> dets;
-    for (size_t p = 0; p < configuration.nPatches(); ++p)
-        dets.addPiecePointer(new gsDetFunction<T>(configuration,p));
-
-    bool plotJac = true;
-    if (numSamplingPoints == 0)
-        plotJac = false;
-
+    gsDeformationPlotter<T> plotter(initDomain,fileName,numSamplingPoints,format);
     gsInfo << "Step: 0/" << displacements.size() << std::endl;
-
-    gsField<T> detField(configuration,dets,true);
-    std::map<std::string,const gsField<T> *> fields;
-    fields["Jacobian"] = &detField;
-    gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(0),numSamplingPoints == 0 ? 1 : numSamplingPoints,true);
-
-    for (size_t p = 0; p < configuration.nPatches(); ++p)
-    {
-        collectionMesh.addTimestep(fileNameOnly + std::to_string(0),p,0,"_mesh.vtp");
-        if (plotJac)
-            collectionJac.addTimestep(fileNameOnly + std::to_string(0),p,0,".vts");
-        else
-        {
-            res = system(("rm " + fileName + std::to_string(0) + std::to_string(p) + ".vts").c_str());
-            GISMO_ENSURE(res == 0, "Problems with deleting files\n");
-        }
-    }
-    res = system(("rm " + fileName + std::to_string(0) + ".pvd").c_str());
-    GISMO_ENSURE(res == 0, "Problems with deleting files\n");
+    plotter.addStep();
 
     for (size_t s = 0; s < displacements.size(); ++s)
     {
         gsInfo << "Step: " << s+1 << "/" << displacements.size() << std::endl;
-
-        for (size_t p = 0; p < configuration.nPatches(); ++p)
-        {
-            configuration.patch(p).coefs() += displacements[s].patch(p).coefs();
-            if (s > 0)
-               configuration.patch(p).coefs() -= displacements[s-1].patch(p).coefs();
-        }
-
-        gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(s+1),numSamplingPoints == 0 ? 1 : numSamplingPoints,true);
-        for (size_t p = 0; p < configuration.nPatches(); ++p)
-        {
-            collectionMesh.addTimestep(fileNameOnly + std::to_string(s+1),p,s+1,"_mesh.vtp");
-
-            if (plotJac)
-                collectionJac.addTimestep(fileNameOnly + std::to_string(s+1),p,s+1,".vts");
-            else
-            {
-                res = system(("rm " + fileName + std::to_string(s+1) + std::to_string(p) + ".vts").c_str());
-                GISMO_ENSURE(res == 0, "Problems with deleting files\n");
-            }
-        }
-        res = system(("rm " + fileName + std::to_string(s+1) + ".pvd").c_str());
-        GISMO_ENSURE(res == 0, "Problems with deleting files\n");
+        plotter.addStep(displacements[s]);
     }
-
-    collectionMesh.save();
-    if (plotJac)
-        collectionJac.save();
-
-    (void)res;
 }
 
 
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const gsMultiPatch<T> & displacement,
-                     std::string const & fileName, gsParaviewCollection & collection, index_t step)
+                     std::string const & fileName, gsParaviewCollection & collection, index_t step,
+                     vtk_format::format format)
 {
     GISMO_ENSURE(initDomain.nPatches() == displacement.nPatches(), "Wrong number of patches! Geometry has " +
                  util::to_string(initDomain.nPatches()) + " patches. Displacement has " + util::to_string(displacement.nPatches()) + " patches.");
@@ -187,14 +130,17 @@ void plotDeformation(const gsMultiPatch<T> & initDomain, const gsMultiPatch<T> &
     {
         gsMesh<T> mesh(configuration.basis(p),8);
         configuration.patch(p).evaluateMesh(mesh);
-        gsWriteParaview(mesh,fileName + util::to_string(step) + "_" + util::to_string(p),false);
+        gsWriteParaviewMesh(mesh,fileName + util::to_string(step) + "_" + util::to_string(p),format);
         collection.addTimestep(fileName + util::to_string(step) + "_",p,step,".vtp");
     }
 }
 
 template <class T>
-index_t checkGeometry(gsMultiPatch<T> const & domain)
+index_t checkGeometry(gsMultiPatch<T> const & domain, bijectivity_check::method method)
 {
+    if (method == bijectivity_check::bezier)
+        return checkJacobianBezier<T>(domain);
+
     index_t corruptedPatch = -1;
     bool continueIt = true;
     for (size_t p = 0; p < domain.nPatches() && continueIt; ++p)
@@ -237,8 +183,12 @@ index_t checkGeometry(gsMultiPatch<T> const & domain)
 
 
 template <class T>
-index_t checkDisplacement(gsMultiPatch<T> const & domain, gsMultiPatch<T> const & displacement)
+index_t checkDisplacement(gsMultiPatch<T> const & domain, gsMultiPatch<T> const & displacement,
+                          bijectivity_check::method method)
 {
+    if (method == bijectivity_check::bezier)
+        return checkJacobianBezier<T>(domain,&displacement);
+
     index_t corruptedPatch = -1;
     bool continueIt = true;
     for (size_t p = 0; p < domain.nPatches() && continueIt; ++p)
@@ -286,6 +236,262 @@ index_t checkDisplacement(gsMultiPatch<T> const & domain, gsMultiPatch<T> const
     return corruptedPatch;
 }
 
+/// collocation matrix of the Bernstein polynomials of degree <deg> at uniformly distributed nodes in [0,1]
+template <class T>
+gsMatrix<T> bernsteinCollocation(index_t deg)
+{
+    gsMatrix<T> mat(deg+1,deg+1);
+    for (index_t i = 0; i <= deg; ++i)
+    {
+        const T t = deg > 0 ? T(i)/deg : 0.;
+        T binom = 1.;
+        for (index_t k = 0; k <= deg; ++k)
+        {
+            mat(i,k) = binom * pow(t,k) * pow(1-t,deg-k);
+            binom = binom*(deg-k)/(k+1);
+        }
+    }
+    return mat;
+}
+
+/// generates a tensor grid of uniformly distributed nodes on a given element; the first direction runs fastest
+template <class T>
+void genBezierPoints(const gsVector<T> & lower, const gsVector<T> & upper,
+                     const gsVector<index_t> & numNodes, gsMatrix<T> & points)
+{
+    const short_t dim = lower.rows();
+    points.resize(dim,numNodes.prod());
+    for (index_t q = 0; q < points.cols(); ++q)
+    {
+        index_t idx = q;
+        for (short_t d = 0; d < dim; ++d)
+        {
+            const index_t i = idx % numNodes.at(d);
+            idx /= numNodes.at(d);
+            points(d,q) = numNodes.at(d) > 1 ? combine(lower.at(d),upper.at(d),T(i)/(numNodes.at(d)-1)) : lower.at(d);
+        }
+    }
+}
+
+/// transforms values at the nodes of genBezierPoints into tensor Bernstein coefficients (in place)
+/// by applying the inverse collocation matrix in each direction
+template <class T>
+void bernsteinCoefs(gsMatrix<T> & values, const gsVector<index_t> & numNodes,
+                    const std::vector<gsMatrix<T> > & invCollocation)
+{
+    gsVector<T> fiber;
+    index_t stride = 1;
+    for (short_t d = 0; d < numNodes.rows(); ++d)
+    {
+        const index_t n = numNodes.at(d);
+        const index_t block = stride*n;
+        fiber.resize(n);
+        for (index_t outer = 0; outer < values.cols(); outer += block)
+            for (index_t inner = 0; inner < stride; ++inner)
+            {
+                for (index_t i = 0; i < n; ++i)
+                    fiber.at(i) = values(0,outer+i*stride+inner);
+                fiber = invCollocation[d] * fiber;
+                for (index_t i = 0; i < n; ++i)
+                    values(0,outer+i*stride+inner) = fiber.at(i);
+            }
+        stride = block;
+    }
+}
+
+/// breakpoints of a tensor B-spline or NURBS basis in the given direction; returns false for other bases
+template <class T>
+bool bezierBreakpoints(const gsBasis<T> & basis, short_t dir, std::vector<T> & result)
+{
+    const gsBasis<T> & source = basis.isRational() ? basis.source() : basis;
+    const gsKnotVector<T> * knots = nullptr;
+    if (const gsBSplineBasis<T> * bspline = dynamic_cast<const gsBSplineBasis<T> *>(&source))
+        knots = &(bspline->knots());
+    else if (const gsTensorBSplineBasis<2,T> * bspline = dynamic_cast<const gsTensorBSplineBasis<2,T> *>(&source))
+        knots = &(bspline->knots(dir));
+    else if (const gsTensorBSplineBasis<3,T> * bspline = dynamic_cast<const gsTensorBSplineBasis<3,T> *>(&source))
+        knots = &(bspline->knots(dir));
+    if (knots == nullptr)
+        return false;
+    result = knots->unique();
+    return true;
+}
+
+/// checks whether every element of the fine basis lies inside an element of the coarse basis,
+/// i.e. whether the breakpoints of the coarse basis are breakpoints of the fine basis in each direction
+template <class T>
+bool bezierNested(const gsBasis<T> & coarse, const gsBasis<T> & fine)
+{
+    std::vector<T> coarseBreaks, fineBreaks;
+    for (short_t d = 0; d < coarse.dim(); ++d)
+    {
+        if (!bezierBreakpoints(coarse,d,coarseBreaks) || !bezierBreakpoints(fine,d,fineBreaks))
+            return false;
+        const T tol = 1e-12*(fineBreaks.back()-fineBreaks.front());
+        for (size_t i = 0; i < coarseBreaks.size(); ++i)
+        {
+            typename std::vector<T>::const_iterator it =
+                std::lower_bound(fineBreaks.begin(),fineBreaks.end(),coarseBreaks[i]-tol);
+            if (it == fineBreaks.end() || *it > coarseBreaks[i]+tol)
+                return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+index_t checkJacobianBezier(gsMultiPatch<T> const & domain, gsMultiPatch<T> const * displacement, index_t maxDepth)
+{
+    const short_t dim = domain.dim();
+    // the flags are read by all threads; the results are written under a critical section
+    index_t corruptedPatch = -1;
+    std::atomic<bool> continueIt(true);
+    bool supported = true;
+    bool inconclusive = false;
+    for (size_t p = 0; p < domain.nPatches() && continueIt; ++p)
+    {
+        // elements are defined by the displacement basis which is a refinement of the geometry basis
+        const gsBasis<T> & basis = displacement ? displacement->basis(p) : domain.basis(p);
+        // for NURBS, sign(det(Jac)) = sign(W^(dim+1)*det(Jac)) and the latter is a polynomial on each element
+        const bool rational = domain.basis(p).isRational();
+        // otherwise, the geometry is not a polynomial on the elements of the displacement basis
+        if (displacement && (basis.isRational() != rational || !bezierNested(domain.basis(p),basis)))
+        {
+            supported = false;
+            break;
+        }
+        typename gsGeometry<T>::uPtr weightGeo, weightDisp;
+        if (rational)
+        {
+            weightGeo = domain.basis(p).source().makeGeometry(domain.basis(p).weights());
+            if (displacement)
+                weightDisp = basis.source().makeGeometry(basis.weights());
+        }
+        // degree of the Jacobian determinant in each direction and the corresponding interpolation data
+        gsVector<index_t> numNodes(dim);
+        std::vector<gsMatrix<T> > invCollocation(dim);
+        for (short_t d = 0; d < dim; ++d)
+        {
+            index_t deg = displacement ? std::max(domain.basis(p).degree(d),basis.degree(d)) : basis.degree(d);
+            deg = (rational ? dim+1 : dim)*deg - 1;
+            numNodes.at(d) = deg+1;
+            invCollocation[d] = bernsteinCollocation<T>(deg).inverse();
+        }
+
+#pragma omp parallel
+        {
+            gsMapData<T> mdG, mdU;
+            mdG.flags = NEED_DERIV;
+            mdU.flags = NEED_DERIV;
+            gsMatrix<T> points, values, weights, weightsDisp, jac;
+            // elements to process: lower corner, upper corner and the subdivision depth
+            std::vector<std::pair<std::pair<gsVector<T>,gsVector<T> >,index_t> > stack;
+
+            typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator(boundary::none);
+#ifdef _OPENMP
+            const int tid = omp_get_thread_num();
+            const int nt  = omp_get_num_threads();
+            for ( domIt->next(tid); domIt->good() && continueIt; domIt->next(nt) )
+#else
+            for (; domIt->good() && continueIt; domIt->next() )
+#endif
+            {
+                stack.clear();
+                stack.push_back(std::make_pair(std::make_pair(domIt->lowerCorner(),domIt->upperCorner()),0));
+                while (!stack.empty() && continueIt)
+                {
+                    const gsVector<T> lower = stack.back().first.first;
+                    const gsVector<T> upper = stack.back().first.second;
+                    const index_t depth = stack.back().second;
+                    stack.pop_back();
+
+                    genBezierPoints(lower,upper,numNodes,points);
+                    mdG.points = points;
+                    domain.patch(p).computeMap(mdG);
+                    if (displacement)
+                    {
+                        mdU.points = points;
+                        displacement->patch(p).computeMap(mdU);
+                    }
+                    if (rational)
+                    {
+                        weightGeo->eval_into(points,weights);
+                        if (displacement)
+                        {
+                            weightDisp->eval_into(points,weightsDisp);
+                            if ((weights-weightsDisp).cwiseAbs().maxCoeff() > 1e-10*weights.cwiseAbs().maxCoeff())
+                            {   // geo and disp have different denominators; det(Jac) is not a polynomial
+#pragma omp critical (checkJacobianBezier)
+                                supported = false;
+                                continueIt = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    values.resize(1,points.cols());
+                    for (index_t q = 0; q < points.cols() && continueIt; ++q)
+                    {
+                        jac = mdG.jacobian(q);
+                        if (displacement)
+                            jac += mdU.jacobian(q);
+                        values(0,q) = jac.determinant();
+                        if (values(0,q) <= 0)
+                        {
+#pragma omp critical (checkJacobianBezier)
+                            {
+                                gsInfo << "Bad patch: " << p << "\nBad point:\n" << points.col(q) << "\nDet: " << values(0,q) << std::endl;
+                                corruptedPatch = p;
+                            }
+                            continueIt = false;
+                        }
+                        if (rational)
+                            values(0,q) *= pow(weights(0,q),dim+1);
+                    }
+                    if (!continueIt)
+                        break;
+
+                    // all Bezier coefficients are positive => det(Jac) > 0 on the element
+                    bernsteinCoefs(values,numNodes,invCollocation);
+                    if (values.minCoeff() > 0)
+                        continue;
+
+                    if (depth < maxDepth) // inconclusive: subdivide the element
+                    {
+                        const gsVector<T> middle = (lower+upper)/2;
+                        for (index_t c = 0; c < (1 << dim); ++c)
+                        {
+                            gsVector<T> lowerChild = lower, upperChild = upper;
+                            for (short_t d = 0; d < dim; ++d)
+                                if (c & (1 << d))
+                                    lowerChild.at(d) = middle.at(d);
+                                else
+                                    upperChild.at(d) = middle.at(d);
+                            stack.push_back(std::make_pair(std::make_pair(lowerChild,upperChild),depth+1));
+                        }
+                    }
+                    else // still inconclusive: the element is left to the sampling check
+                    {
+#pragma omp critical (checkJacobianBezier)
+                        inconclusive = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!supported || (inconclusive && corruptedPatch == -1))
+    {
+        if (!supported)
+            gsWarn << "Bezier bijectivity check is not applicable to the given configuration. Sampling is used instead.\n";
+        else
+            gsWarn << "Bezier bijectivity check is inconclusive after " << maxDepth << " subdivisions. Sampling is used instead.\n";
+        return displacement ? checkDisplacement(domain,*displacement,bijectivity_check::sampling)
+                            : checkGeometry(domain,bijectivity_check::sampling);
+    }
+    return corruptedPatch;
+}
+
 template <class T>
 T normL2(gsMultiPatch<T> const & domain, gsMultiPatch<T> const & solution)
 {
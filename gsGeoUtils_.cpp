@@ -16,14 +16,19 @@ TEMPLATE_INST void plotGeometry(const gsMultiPatch<real_t> & domain,std::string
                                 gsParaviewCollection & collection, index_t step);
 
 TEMPLATE_INST void plotDeformation(const gsMultiPatch<real_t> & initDomain, const std::vector<gsMultiPatch<real_t> > & displacements,
-                     std::string fileName, index_t numSamplingPoints);
+                     std::string fileName, index_t numSamplingPoints, vtk_format::format format);
 
 TEMPLATE_INST void plotDeformation(const gsMultiPatch<real_t> & initDomain, const gsMultiPatch<real_t> & displacement,
-                                   std::string const & fileName, gsParaviewCollection & collection, index_t step);
+                                   std::string const & fileName, gsParaviewCollection & collection, index_t step,
+                                   vtk_format::format format);
 
-TEMPLATE_INST index_t checkGeometry(gsMultiPatch<real_t> const & domain);
+TEMPLATE_INST index_t checkGeometry(gsMultiPatch<real_t> const & domain, bijectivity_check::method method);
 
-TEMPLATE_INST index_t checkDisplacement(gsMultiPatch<real_t> const & domain, gsMultiPatch<real_t> const & displacement);
+TEMPLATE_INST index_t checkDisplacement(gsMultiPatch<real_t> const & domain, gsMultiPatch<real_t> const & displacement,
+                                        bijectivity_check::method method);
+
+TEMPLATE_INST index_t checkJacobianBezier(gsMultiPatch<real_t> const & domain, gsMultiPatch<real_t> const * displacement,
+                                          index_t maxDepth);
 
 TEMPLATE_INST real_t normL2(gsMultiPatch<real_t> const & domain, gsMultiPatch<real_t> const & solution);
 
@@ -0,0 +1,85 @@
+/** @file gsGridEvaluator.h
+
+    @brief Fast evaluation of tensor-product splines on a tensor grid of points.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsCore/gsForwardDeclarations.h>
+
+namespace gismo
+{
+
+/** @brief Evaluates geometries and isogeometric functions with tensor-product bases
+ * (B-splines and NURBS) on a tensor grid of points, e.g. the output of gsPointGrid.
+ *
+ * Since the basis functions factorize per direction, the 1D bases are evaluated once per
+ * direction at the grid coordinates, stored as sparse tables (numPoints_i x numBasis_i),
+ * and contracted with the coefficients direction by direction (sum factorization).
+ * For a degree p basis in d dimensions this replaces (p+1)^d basis evaluations per point
+ * by roughly d*(p+1) multiply-adds per point and coefficient component.
+ *
+ * Bases which are not tensor-product (e.g. THB) are detected by applicable();
+ * the caller should fall back to generic evaluation for them.
+*/
+template <class T>
+class gsGridEvaluator
+{
+public:
+    /// @param points grid points as returned by gsPointGrid, i.e. the first coordinate varies fastest
+    /// @param np number of points in each direction
+    gsGridEvaluator(const gsMatrix<T> & points, const gsVector<unsigned> & np);
+
+    /// checks whether the basis is a tensor-product basis which can be evaluated on the grid
+    static bool applicable(const gsBasis<T> & basis);
+
+    /// values of the function at the grid points: targetDim x numPoints
+    void eval_into(const gsGeometry<T> & func, gsMatrix<T> & result) const;
+
+    /// jacobians of the function at the grid points: targetDim x (parDim*numPoints),
+    /// the jacobian at the q-th point is the block result.middleCols(q*parDim,parDim)
+    void jacobian_into(const gsGeometry<T> & func, gsMatrix<T> & result) const;
+
+    /// grid points
+    const gsMatrix<T> & points() const { return m_points; }
+
+    /// number of grid points
+    index_t numPoints() const { return m_points.cols(); }
+
+protected:
+    /// collect 1D bases of a tensor-product basis; returns false if the basis is not tensor-product
+    static bool components(const gsBasis<T> & basis, std::vector<const gsBasis<T> *> & result);
+
+    /// sparse tables of values and first derivatives of the 1D bases at the grid coordinates
+    void tables(const gsBasis<T> & basis, std::vector<gsSparseMatrix<T> > & values,
+                std::vector<gsSparseMatrix<T> > & derivs) const;
+
+    /// contract coefficients (one row per tensor-product basis function) with one table per direction;
+    /// the result has one row per grid point
+    static void contract(const std::vector<const gsSparseMatrix<T> *> & tables,
+                         const gsMatrix<T> & coefs, gsMatrix<T> & result);
+
+    /// coefficients in homogeneous form for rational bases: [w*coefs, w]
+    static void homogeneous(const gsGeometry<T> & func, gsMatrix<T> & result);
+
+protected:
+    gsMatrix<T> m_points;
+    /// coordinates of the grid in each direction
+    std::vector<gsVector<T> > m_coords;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsGridEvaluator.hpp)
+#endif
@@ -0,0 +1,232 @@
+/** @file gsGridEvaluator.hpp
+
+    @brief Implementation of gsGridEvaluator.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsGridEvaluator.h>
+
+#include <gsCore/gsGeometry.h>
+#include <gsTensor/gsTensorBasis.h>
+
+namespace gismo
+{
+
+template <class T>
+gsGridEvaluator<T>::gsGridEvaluator(const gsMatrix<T> & points, const gsVector<unsigned> & np)
+    : m_points(points)
+{
+    // the first coordinate varies fastest, so the k-th coordinates of the grid
+    // are found with the stride equal to the number of points in the previous directions
+    index_t stride = 1;
+    m_coords.resize(np.size());
+    for (index_t k = 0; k < np.size(); ++k)
+    {
+        m_coords[k].resize(np(k));
+        for (index_t j = 0; j < index_t(np(k)); ++j)
+            m_coords[k](j) = points(k,j*stride);
+        stride *= np(k);
+    }
+    GISMO_ASSERT(stride == points.cols(),"Points do not form a tensor grid.\n");
+}
+
+template <class T>
+bool gsGridEvaluator<T>::components(const gsBasis<T> & basis, std::vector<const gsBasis<T> *> & result)
+{
+    // for NURBS, the tensor structure is in the underlying B-spline basis
+    const gsBasis<T> & source = basis.isRational() ? basis.source() : basis;
+    result.clear();
+    switch (source.dim())
+    {
+    case 1: // every univariate basis is its own tensor-product component
+        result.push_back(&source);
+        return true;
+    case 2:
+    {
+        const gsTensorBasis<2,T> * tensorBasis = dynamic_cast<const gsTensorBasis<2,T> *>(&source);
+        if (tensorBasis == nullptr)
+            return false;
+        for (short_t k = 0; k < 2; ++k)
+            result.push_back(&(tensorBasis->component(k)));
+        return true;
+    }
+    case 3:
+    {
+        const gsTensorBasis<3,T> * tensorBasis = dynamic_cast<const gsTensorBasis<3,T> *>(&source);
+        if (tensorBasis == nullptr)
+            return false;
+        for (short_t k = 0; k < 3; ++k)
+            result.push_back(&(tensorBasis->component(k)));
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+template <class T>
+bool gsGridEvaluator<T>::applicable(const gsBasis<T> & basis)
+{
+    std::vector<const gsBasis<T> *> comps;
+    return components(basis,comps);
+}
+
+template <class T>
+void gsGridEvaluator<T>::tables(const gsBasis<T> & basis, std::vector<gsSparseMatrix<T> > & values,
+                                std::vector<gsSparseMatrix<T> > & derivs) const
+{
+    std::vector<const gsBasis<T> *> comps;
+    GISMO_ENSURE(components(basis,comps),"Not a tensor-product basis.\n");
+    GISMO_ENSURE(comps.size() == m_coords.size(),"Dimensions of the basis and the grid do not match.\n");
+
+    values.resize(comps.size());
+    derivs.resize(comps.size());
+    gsMatrix<index_t> actives;
+    std::vector<gsMatrix<T> > evals;
+    for (size_t k = 0; k < comps.size(); ++k)
+    {
+        const gsMatrix<T> u = m_coords[k].transpose();
+        comps[k]->active_into(u,actives);
+        comps[k]->evalAllDers_into(u,1,evals);
+
+        gsSparseEntries<T> entriesVal, entriesDer;
+        for (index_t j = 0; j < actives.cols(); ++j)
+            for (index_t i = 0; i < actives.rows(); ++i)
+            {
+                entriesVal.add(j,actives(i,j),evals[0](i,j));
+                entriesDer.add(j,actives(i,j),evals[1](i,j));
+            }
+        values[k].resize(u.cols(),comps[k]->size());
+        values[k].setFrom(entriesVal);
+        values[k].makeCompressed();
+        derivs[k].resize(u.cols(),comps[k]->size());
+        derivs[k].setFrom(entriesDer);
+        derivs[k].makeCompressed();
+    }
+}
+
+template <class T>
+void gsGridEvaluator<T>::contract(const std::vector<const gsSparseMatrix<T> *> & tables,
+                                  const gsMatrix<T> & coefs, gsMatrix<T> & result)
+{
+    // coefs is a tensor of the size numBasis_0 x ... x numBasis_d-1 with the first index varying fastest;
+    // each step replaces the k-th index by a grid index
+    std::vector<index_t> dims(tables.size());
+    for (size_t k = 0; k < tables.size(); ++k)
+        dims[k] = tables[k]->cols();
+
+    gsMatrix<T> current = coefs;
+    gsMatrix<T> next;
+    for (size_t k = 0; k < tables.size(); ++k)
+    {
+        const gsSparseMatrix<T> & table = *tables[k];
+        index_t stride = 1, outer = 1;
+        for (size_t l = 0; l < k; ++l)
+            stride *= dims[l];
+        for (size_t l = k+1; l < dims.size(); ++l)
+            outer *= dims[l];
+        GISMO_ASSERT(stride*dims[k]*outer == current.rows(),"Coefficients do not match the basis.\n");
+
+        next.setZero(stride*table.rows()*outer,current.cols());
+        for (index_t c = 0; c < current.cols(); ++c)
+            for (index_t i = 0; i < table.outerSize(); ++i)
+                for (typename gsSparseMatrix<T>::InnerIterator it(table,i); it; ++it)
+                    for (index_t o = 0; o < outer; ++o)
+                    {
+                        const index_t from = stride*(it.col() + dims[k]*o);
+                        const index_t to = stride*(it.row() + table.rows()*o);
+                        for (index_t s = 0; s < stride; ++s)
+                            next(to+s,c) += it.value()*current(from+s,c);
+                    }
+        dims[k] = table.rows();
+        current.swap(next);
+    }
+    result.swap(current);
+}
+
+template <class T>
+void gsGridEvaluator<T>::homogeneous(const gsGeometry<T> & func, gsMatrix<T> & result)
+{
+    const gsMatrix<T> & coefs = func.coefs();
+    const gsMatrix<T> & weights = func.basis().weights();
+    result.resize(coefs.rows(),coefs.cols()+1);
+    result.leftCols(coefs.cols()) = coefs.array().colwise() * weights.col(0).array();
+    result.col(coefs.cols()) = weights.col(0);
+}
+
+template <class T>
+void gsGridEvaluator<T>::eval_into(const gsGeometry<T> & func, gsMatrix<T> & result) const
+{
+    std::vector<gsSparseMatrix<T> > values, derivs;
+    tables(func.basis(),values,derivs);
+    std::vector<const gsSparseMatrix<T> *> tab(values.size());
+    for (size_t k = 0; k < values.size(); ++k)
+        tab[k] = &values[k];
+
+    gsMatrix<T> flat;
+    if (!func.basis().isRational())
+    {
+        contract(tab,func.coefs(),flat);
+        result = flat.transpose();
+        return;
+    }
+
+    gsMatrix<T> coefs;
+    homogeneous(func,coefs);
+    contract(tab,coefs,flat);
+    const index_t numComp = func.coefs().cols();
+    result = (flat.leftCols(numComp).array().colwise() / flat.col(numComp).array()).matrix().transpose();
+}
+
+template <class T>
+void gsGridEvaluator<T>::jacobian_into(const gsGeometry<T> & func, gsMatrix<T> & result) const
+{
+    std::vector<gsSparseMatrix<T> > values, derivs;
+    tables(func.basis(),values,derivs);
+    const short_t parDim = values.size();
+    const index_t numComp = func.coefs().cols();
+    const bool rational = func.basis().isRational();
+    std::vector<const gsSparseMatrix<T> *> tab(parDim);
+
+    gsMatrix<T> coefs, flat, flatValues;
+    if (rational)
+    {
+        // quotient rule needs the values of the numerator and the denominator
+        homogeneous(func,coefs);
+        for (short_t k = 0; k < parDim; ++k)
+            tab[k] = &values[k];
+        contract(tab,coefs,flatValues);
+    }
+    const gsMatrix<T> & c = rational ? coefs : func.coefs();
+
+    result.resize(numComp,parDim*numPoints());
+    for (short_t k = 0; k < parDim; ++k)
+    {
+        // derivative in the k-th direction: derivative table for k, value tables for the others
+        for (short_t l = 0; l < parDim; ++l)
+            tab[l] = l == k ? &derivs[l] : &values[l];
+        contract(tab,c,flat);
+        if (rational)
+            for (index_t q = 0; q < numPoints(); ++q)
+            {
+                const T w = flatValues(q,numComp);
+                result.col(q*parDim+k) = (flat.row(q).head(numComp) -
+                                          flatValues.row(q).head(numComp)*flat(q,numComp)/w).transpose()/w;
+            }
+        else
+            for (index_t q = 0; q < numPoints(); ++q)
+                result.col(q*parDim+k) = flat.row(q).transpose();
+    }
+}
+
+} // namespace ends
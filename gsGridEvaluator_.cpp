@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsGridEvaluator.h>
+#include <gsElasticity/gsGridEvaluator.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsGridEvaluator<real_t>;
+}
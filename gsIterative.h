@@ -16,6 +16,7 @@
 #pragma once
 
 #include <gsIO/gsOptionList.h>
+#include <gsSolver/gsSparseSolver.h>
 #include <gsElasticity/gsBaseUtils.h>
 #include <functional>
 
@@ -74,6 +75,9 @@ public:
     /// computes update or the next solution
     bool compute();
 
+    /// computes the residual norm at the current solution using the residual-only assembly
+    bool computeResidual();
+
     /// returns the solution vector
     const gsMatrix<T> & solution() const { return solVector; }
 
@@ -83,6 +87,9 @@ public:
     /// return solver status as a string
     std::string status();
 
+    /// return solver status
+    solver_status solverStatus() const { return m_status; }
+
     /// reset the solver state
     void reset();
 
@@ -92,6 +99,12 @@ public:
     /// number of iteration that Newton's method took
     index_t numberIterations() const {return numIterations;}
 
+    /// total number of iterations of the iterative linear solver since the last reset
+    index_t numberKrylovIterations() const {return numKrylovIterations;}
+
+    /// total number of factorizations of the tangential matrix since the last reset
+    index_t numberFactorizations() const {return numFactorizations;}
+
     /// set initial guess
     void setSolutionVector(const gsMatrix<T> & solutionVector) { solVector = solutionVector; }
 
@@ -101,6 +114,35 @@ public:
     /// recover solver state from saved state
     void recoverState();
 
+protected:
+    /// quasi-Newton iteration: the tangential matrix is factorized only at refreshes,
+    /// updates in between use the residual-only assembly and low-rank corrections
+    bool computeQuasiNewton();
+
+    /// Anderson acceleration of the fixed-point iteration (next mode);
+    /// replaces the next solution with a combination of the previous ones
+    void andersonMix(gsVector<T> & nextSolution);
+
+    /// applies the quasi-Newton approximation of the inverse tangential matrix to a vector
+    void applyInverse(const gsMatrix<T> & vector, gsVector<T> & result);
+
+    /// tolerance of the iterative linear solver according to the Eisenstat-Walker rule (choice 2)
+    T forcingTerm();
+
+    /// backtracking line search along the Newton update; scales the update to the accepted step length
+    bool lineSearch(gsVector<T> & update);
+
+    /// dogleg trust-region step; replaces the Newton update with the accepted step
+    bool trustRegion(gsVector<T> & update);
+
+    /// residual norm at the trial solution solVector+update;
+    /// returns false if the trial solution is invalid. Does not change the solver state.
+    bool trialResidual(const gsVector<T> & update, T & norm);
+
+    /// residual norm at the current solution that the trial residual norms are compared to;
+    /// at the first iteration, it is evaluated with the new Dirichlet DoFs like the trial ones
+    T referenceResidual();
+
 protected:
     /// assembler object that generates the linear system
     gsBaseAssembler<T> & assembler;
@@ -115,6 +157,23 @@ protected:
     T initResidualNorm; /// norm of the residual vector at the beginning of the loop
     T updateNorm; /// norm of the update vector
     T initUpdateNorm; /// norm of the update vector at the beginning of the loop
+    T trRadius; /// current trust region radius
+    T eta; /// current forcing term of the inexact Newton's method
+    T prevResidualNorm; /// norm of the residual vector at the previous iteration
+    index_t numKrylovIterations; /// number of iterations of the iterative linear solver
+    gsVector<T> prevUpdate; /// previous update, an initial guess for the iterative linear solver
+    index_t numFactorizations; /// number of factorizations of the tangential matrix
+    /// ---- quasi-Newton data ----- ///
+    typename gsSparseSolver<T>::LU qnLU; /// factorization of the tangential matrix at the last refresh
+    typename gsSparseSolver<T>::SimplicialLDLT qnLDLT;
+    bool qnRefresh; /// assemble and factorize the tangential matrix at the next iteration
+    gsMatrix<T> qnRhs; /// negative residual at the current solution
+    std::vector<gsVector<T> > qnS, qnY; /// stored updates and residual differences (L-BFGS)
+    std::vector<gsVector<T> > qnP; /// stored rank-one correction vectors (Broyden)
+    std::vector<T> qnRho; /// inverse curvatures 1/(s^T y) (L-BFGS)
+    /// ---- Anderson acceleration data ----- ///
+    std::vector<gsVector<T> > aaDF, aaDG; /// differences of fixed-point residuals and fixed-point map values
+    gsVector<T> aaF, aaG; /// fixed-point residual and map value at the previous iteration
     /// option list
     gsOptionList m_options;
 
@@ -69,6 +69,15 @@ void gsIterative<T>::reset()
     initResidualNorm = 1.;
     updateNorm = 0.;
     initUpdateNorm = 1.;
+    trRadius = 0.;
+    eta = 0.;
+    prevResidualNorm = 0.;
+    numKrylovIterations = 0;
+    prevUpdate.resize(0);
+    numFactorizations = 0;
+    qnRefresh = true;
+    aaDF.clear();
+    aaDG.clear();
 }
 
 template <class T>
@@ -84,12 +93,31 @@ gsOptionList gsIterative<T>::defaultOptions()
     /// additional setting
     opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
     opt.addInt("IterType","Type of iteration: update or next/full",iteration_type::update);
+    opt.addSwitch("ResidualCheck","Confirm convergence with the residual at the final solution (update mode only)",false);
+    /// globalization (update mode only)
+    opt.addInt("Globalization","Globalization of Newton's method: none, line search, trust region",newton_globalization::none);
+    opt.addInt("LSMaxIters","Maximum number of step reductions per iteration",10);
+    opt.addReal("LSFactor","Step length reduction factor for the line search",0.5);
+    opt.addReal("LSArmijo","Sufficient decrease parameter for the line search",1e-4);
+    opt.addReal("TRRadius","Initial trust region radius; the first Newton update length is used if not positive",0.);
+    /// inexact Newton's method (update mode and iterative linear solvers only)
+    opt.addSwitch("Inexact","Choose the tolerance of the iterative linear solver by the Eisenstat-Walker rule",false);
+    opt.addReal("EtaMax","Maximum forcing term of the inexact Newton's method",0.9);
+    opt.addReal("EtaGamma","Parameter gamma of the Eisenstat-Walker rule",0.9);
+    opt.addReal("EtaAlpha","Parameter alpha of the Eisenstat-Walker rule",2.);
+    /// quasi-Newton (update mode and direct linear solvers only)
+    opt.addInt("QuasiNewton","Quasi-Newton mode: none, L-BFGS (symmetric tangent), Broyden",quasi_newton::none);
+    opt.addInt("QNMemory","Maximum number of stored quasi-Newton updates",10);
+    opt.addReal("QNStall","Refresh the tangential matrix if the residual norm decreases by less than this factor",0.5);
+    /// Anderson acceleration (next mode only)
+    opt.addInt("AndersonDepth","Number of previous iterations used by Anderson acceleration; 0 - no acceleration",0);
     return opt;
 }
 
 template <class T>
 void gsIterative<T>::solve()
 {
+    ELAST_PROFILE_REGION("Newton");
     while (m_status == solver_status::working)
     {
         if (!compute())
@@ -103,7 +131,26 @@ void gsIterative<T>::solve()
             updateNorm < m_options.getReal("AbsTol") ||
             residualNorm/initResidualNorm < m_options.getReal("RelTol") ||
             updateNorm/initUpdateNorm < m_options.getReal("RelTol"))
-            m_status = solver_status::converged;
+        {
+            // in the update mode, the residual norm refers to the solution before the last update;
+            // the residual at the final solution is checked without assembling the matrix
+            if (m_options.getSwitch("ResidualCheck") &&
+                m_options.getInt("IterType") == iteration_type::update)
+            {
+                if (!computeResidual())
+                {
+                    m_status = solver_status::bad_solution;
+                    goto abort;
+                }
+                if (residualNorm < m_options.getReal("AbsTol") ||
+                    residualNorm/initResidualNorm < m_options.getReal("RelTol"))
+                    m_status = solver_status::converged;
+                else if (numIterations == m_options.getInt("MaxIters"))
+                    m_status = solver_status::interrupted;
+            }
+            else
+                m_status = solver_status::converged;
+        }
         else if (numIterations == m_options.getInt("MaxIters"))
             m_status = solver_status::interrupted;
     }
@@ -120,6 +167,10 @@ bool gsIterative<T>::compute()
     if (numIterations == 1 && m_options.getInt("IterType") == iteration_type::update)
         assembler.homogenizeFixedDofs(-1);
 
+    if (m_options.getInt("QuasiNewton") != quasi_newton::none &&
+        m_options.getInt("IterType") == iteration_type::update)
+        return computeQuasiNewton();
+
     if (!assembler.assemble(solVector,fixedDoFs))
         return false;
 
@@ -127,39 +178,81 @@ bool gsIterative<T>::compute()
     if (m_options.getInt("Solver") == linear_solver::LU)
     {
 #ifdef GISMO_WITH_PARDISO
-        gsSparseSolver<>::PardisoLU solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        gsSparseSolver<>::PardisoLU solver;
+        gsProfiledFactorize(solver,assembler.matrix());
+        solutionVector = gsProfiledSolve(solver,assembler.rhs());
 #else
-        gsSparseSolver<>::LU solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        gsSparseSolver<>::LU solver;
+        gsProfiledFactorize(solver,assembler.matrix());
+        solutionVector = gsProfiledSolve(solver,assembler.rhs());
 #endif
+        ++numFactorizations;
     }
     if (m_options.getInt("Solver") == linear_solver::LDLT)
     {
 #ifdef GISMO_WITH_PARDISO
-        gsSparseSolver<>::PardisoLDLT solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        gsSparseSolver<>::PardisoLDLT solver;
+        gsProfiledFactorize(solver,assembler.matrix());
+        solutionVector = gsProfiledSolve(solver,assembler.rhs());
 #else
-        gsSparseSolver<>::SimplicialLDLT solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        gsSparseSolver<>::SimplicialLDLT solver;
+        gsProfiledFactorize(solver,assembler.matrix());
+        solutionVector = gsProfiledSolve(solver,assembler.rhs());
 #endif
+        ++numFactorizations;
     }
+    // inexact Newton: loose tolerance far from the solution, warm start from the previous update
+    const bool inexact = m_options.getSwitch("Inexact") &&
+                         m_options.getInt("IterType") == iteration_type::update;
+    if (inexact && prevUpdate.rows() != assembler.numDofs())
+        prevUpdate.setZero(assembler.numDofs());
     if (m_options.getInt("Solver") == linear_solver::BiCGSTABDiagonal)
     {
+        ELAST_PROFILE_REGION("solve");
         gsSparseSolver<>::BiCGSTABDiagonal solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        if (inexact)
+        {
+            solver.setTolerance(forcingTerm());
+            solutionVector = solver.solveWithGuess(assembler.rhs(),prevUpdate);
+        }
+        else
+            solutionVector = solver.solve(assembler.rhs());
+        numKrylovIterations += solver.iterations();
+        ELAST_PROFILE_COUNT("Krylov iterations",solver.iterations());
     }
     if (m_options.getInt("Solver") == linear_solver::CGDiagonal)
     {
+        ELAST_PROFILE_REGION("solve");
         gsSparseSolver<>::CGDiagonal solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        if (inexact)
+        {
+            solver.setTolerance(forcingTerm());
+            solutionVector = solver.solveWithGuess(assembler.rhs(),prevUpdate);
+        }
+        else
+            solutionVector = solver.solve(assembler.rhs());
+        numKrylovIterations += solver.iterations();
+        ELAST_PROFILE_COUNT("Krylov iterations",solver.iterations());
     }
 
     if (m_options.getInt("IterType") == iteration_type::update)
     {
-        updateNorm = solutionVector.norm();
         residualNorm = assembler.rhs().norm();
+        // rejected trial steps are evaluated with the residual-only assembly and never change the solver state
+        if (m_options.getInt("Globalization") == newton_globalization::line_search)
+        {
+            if (!lineSearch(solutionVector))
+                return false;
+        }
+        else if (m_options.getInt("Globalization") == newton_globalization::trust_region)
+        {
+            if (!trustRegion(solutionVector))
+                return false;
+        }
+        updateNorm = solutionVector.norm();
         solVector += solutionVector;
+        if (inexact)
+            prevUpdate = solutionVector;
         // update fixed degrees fo freedom at the first iteration only (they are zero afterwards)
         if (numIterations == 0)
             for (index_t d = 0; d < (index_t)(fixedDoFs.size()); ++d)
@@ -169,6 +262,8 @@ bool gsIterative<T>::compute()
     {
         updateNorm = (solutionVector-solVector).norm();
         residualNorm = 1.; // residual is not defined
+        if (m_options.getInt("AndersonDepth") > 0)
+            andersonMix(solutionVector);
         solVector = solutionVector;
         // copy the fixed degrees of freedom
         if (numIterations == 0)
@@ -181,7 +276,315 @@ bool gsIterative<T>::compute()
         initResidualNorm = residualNorm;
     }
     numIterations++;
+    ELAST_PROFILE_COUNT("iterations",1);
+
+    return true;
+}
+
+template <class T>
+void gsIterative<T>::andersonMix(gsVector<T> & nextSolution)
+{
+    // fixed-point residual f = G(x) - x
+    gsVector<T> f = nextSolution - solVector.col(0);
+    if (numIterations > 0)
+    {
+        aaDF.push_back(f - aaF);
+        aaDG.push_back(nextSolution - aaG);
+        if ((index_t)aaDF.size() > m_options.getInt("AndersonDepth"))
+        {
+            aaDF.erase(aaDF.begin());
+            aaDG.erase(aaDG.begin());
+        }
+    }
+    aaF = f;
+    aaG = nextSolution;
+    if (aaDF.empty())
+        return;
+
+    // least-squares problem min |f - dF*gamma|
+    const index_t m = aaDF.size();
+    gsMatrix<T> dF(f.rows(),m), dG(f.rows(),m);
+    for (index_t i = 0; i < m; ++i)
+    {
+        dF.col(i) = aaDF[i];
+        dG.col(i) = aaDG[i];
+    }
+    gsVector<T> gamma = dF.colPivHouseholderQr().solve(f);
+    nextSolution -= dG*gamma;
+}
+
+template <class T>
+bool gsIterative<T>::computeQuasiNewton()
+{
+    GISMO_ENSURE(m_options.getInt("Solver") == linear_solver::LU ||
+                 m_options.getInt("Solver") == linear_solver::LDLT,
+                 "Quasi-Newton modes require a direct linear solver (LU or LDLT)");
+    const index_t method = m_options.getInt("QuasiNewton");
+
+    // full Newton refresh: assemble and factorize the tangential matrix, clear the history
+    if (qnRefresh || numIterations == 0)
+    {
+        if (!assembler.assemble(solVector,fixedDoFs))
+            return false;
+        if (m_options.getInt("Solver") == linear_solver::LDLT)
+            gsProfiledFactorize(qnLDLT,assembler.matrix());
+        else
+            gsProfiledFactorize(qnLU,assembler.matrix());
+        ++numFactorizations;
+        qnRhs = assembler.rhs();
+        qnS.clear();
+        qnY.clear();
+        qnP.clear();
+        qnRho.clear();
+        qnRefresh = false;
+    }
+
+    gsVector<T> update;
+    {
+        ELAST_PROFILE_REGION("solve");
+        applyInverse(qnRhs,update);
+    }
+    updateNorm = update.norm();
+    residualNorm = qnRhs.norm();
+    solVector += update;
+    // update fixed degrees fo freedom at the first iteration only (they are zero afterwards)
+    if (numIterations == 0)
+        for (index_t d = 0; d < (index_t)(fixedDoFs.size()); ++d)
+            fixedDoFs[d] += assembler.fixedDofs(d);
+
+    // residual at the new solution: used for the secant pair and for the next update
+    if (!assembler.assembleResidual(solVector,fixedDoFs))
+        return false;
+    const gsMatrix<T> & rhsNew = assembler.rhs();
+    if (rhsNew.norm() > m_options.getReal("QNStall")*residualNorm)
+        qnRefresh = true;
+    // at the first iteration, the rhs contains the Dirichlet increment and does not yield a secant pair
+    else if (numIterations > 0)
+    {
+        // difference of residuals r = -rhs
+        gsVector<T> y = qnRhs - rhsNew;
+        if (method == quasi_newton::lbfgs)
+        {
+            const T sy = update.dot(y);
+            if (sy > 0) // curvature condition
+            {
+                qnS.push_back(update);
+                qnY.push_back(y);
+                qnRho.push_back(1./sy);
+                if ((index_t)qnS.size() > m_options.getInt("QNMemory"))
+                {
+                    qnS.erase(qnS.begin());
+                    qnY.erase(qnY.begin());
+                    qnRho.erase(qnRho.begin());
+                }
+            }
+        }
+        else if (method == quasi_newton::broyden)
+        {
+            // second Broyden update of the inverse: H += (s - H*y) y^T / (y^T y)
+            ELAST_PROFILE_REGION("Broyden update");
+            gsVector<T> Hy;
+            applyInverse(y,Hy);
+            qnP.push_back((update - Hy)/y.squaredNorm());
+            qnY.push_back(y);
+            if ((index_t)qnP.size() >= m_options.getInt("QNMemory"))
+                qnRefresh = true;
+        }
+    }
+    qnRhs = rhsNew;
+
+    if (numIterations == 0)
+    {
+        initUpdateNorm = updateNorm;
+        initResidualNorm = residualNorm;
+    }
+    numIterations++;
+    ELAST_PROFILE_COUNT("iterations",1);
+
+    return true;
+}
 
+template <class T>
+void gsIterative<T>::applyInverse(const gsMatrix<T> & vector, gsVector<T> & result)
+{
+    if (m_options.getInt("QuasiNewton") == quasi_newton::lbfgs)
+    {
+        // two-loop recursion with the factorized tangential matrix as the initial inverse Hessian
+        const index_t k = qnS.size();
+        std::vector<T> alpha(k);
+        gsVector<T> q = vector.col(0);
+        for (index_t i = k-1; i >= 0; --i)
+        {
+            alpha[i] = qnRho[i]*qnS[i].dot(q);
+            q -= alpha[i]*qnY[i];
+        }
+        if (m_options.getInt("Solver") == linear_solver::LDLT)
+            result = qnLDLT.solve(q);
+        else
+            result = qnLU.solve(q);
+        for (index_t i = 0; i < k; ++i)
+        {
+            T beta = qnRho[i]*qnY[i].dot(result);
+            result += (alpha[i]-beta)*qnS[i];
+        }
+    }
+    else
+    {
+        if (m_options.getInt("Solver") == linear_solver::LDLT)
+            result = qnLDLT.solve(vector);
+        else
+            result = qnLU.solve(vector);
+        // rank-one corrections of the Broyden updates
+        for (size_t i = 0; i < qnP.size(); ++i)
+            result += qnY[i].dot(vector.col(0))*qnP[i];
+    }
+}
+
+template <class T>
+T gsIterative<T>::forcingTerm()
+{
+    const T etaMax = m_options.getReal("EtaMax");
+    const T gamma = m_options.getReal("EtaGamma");
+    const T alpha = m_options.getReal("EtaAlpha");
+    // residual of the current iteration; residualNorm still refers to the previous one
+    const T curResidualNorm = assembler.rhs().norm();
+    if (numIterations == 0)
+        eta = etaMax;
+    else
+    {
+        T etaNew = gamma*math::pow(curResidualNorm/prevResidualNorm,alpha);
+        // safeguard against a too rapid decrease of the forcing term
+        T etaSafe = gamma*math::pow(eta,alpha);
+        if (etaSafe > 0.1)
+            etaNew = math::max(etaNew,etaSafe);
+        // do not solve more accurately than needed for the absolute stopping criterion
+        if (curResidualNorm > 0)
+            etaNew = math::max(etaNew,0.5*m_options.getReal("AbsTol")/curResidualNorm);
+        eta = math::min(etaNew,etaMax);
+    }
+    prevResidualNorm = curResidualNorm;
+    return eta;
+}
+
+template <class T>
+bool gsIterative<T>::trialResidual(const gsVector<T> & update, T & norm)
+{
+    std::vector<gsMatrix<T> > trialFixedDoFs = fixedDoFs;
+    // at the first iteration, the update includes the Dirichlet increment
+    if (numIterations == 0)
+        for (index_t d = 0; d < (index_t)(trialFixedDoFs.size()); ++d)
+            trialFixedDoFs[d] += assembler.fixedDofs(d);
+    gsMatrix<T> trialVector = solVector + update;
+    if (!assembler.assembleResidual(trialVector,trialFixedDoFs))
+        return false;
+    norm = assembler.rhs().norm();
+    return true;
+}
+
+template <class T>
+T gsIterative<T>::referenceResidual()
+{
+    // residualNorm contains the lifting of the Dirichlet increment at the first iteration
+    // and is therefore not comparable to the residual norms at the trial solutions
+    if (numIterations > 0)
+        return residualNorm;
+    T norm;
+    if (!trialResidual(gsVector<T>::Zero(solVector.rows()),norm))
+        return residualNorm;
+    return norm;
+}
+
+template <class T>
+bool gsIterative<T>::lineSearch(gsVector<T> & update)
+{
+    const T factor = m_options.getReal("LSFactor");
+    const T armijo = m_options.getReal("LSArmijo");
+    const T refNorm = referenceResidual();
+    T alpha = 1.;
+    T trialNorm;
+    bool valid = false;
+    for (index_t i = 0; i <= m_options.getInt("LSMaxIters"); ++i)
+    {
+        valid = trialResidual(alpha*update,trialNorm);
+        // sufficient decrease of the residual norm along the Newton direction
+        if (valid && trialNorm <= (1.-armijo*alpha)*refNorm)
+            break;
+        if (i < m_options.getInt("LSMaxIters"))
+            alpha *= factor;
+    }
+    // the shortest step is taken if it is valid but does not decrease the residual sufficiently
+    if (!valid)
+        return false;
+    if (m_options.getInt("Verbosity") == solver_verbosity::all && alpha < 1.)
+        gsInfo << "Line search: step length " << alpha << std::endl;
+    update *= alpha;
+    return true;
+}
+
+template <class T>
+bool gsIterative<T>::trustRegion(gsVector<T> & update)
+{
+    const T newtonNorm = update.norm();
+    if (numIterations == 0)
+        trRadius = m_options.getReal("TRRadius") > 0 ? m_options.getReal("TRRadius") : newtonNorm;
+    if (newtonNorm == 0.)
+        return true;
+    // copies: trial assemblies overwrite both, including the matrix if the assembler has no residual-only assembly
+    const gsSparseMatrix<T> J = assembler.matrix();
+    const gsMatrix<T> rhs = assembler.rhs(); // rhs = -r
+    const T refNorm = referenceResidual();
+    // steepest descent direction for 0.5*|r|^2 and the Cauchy step
+    gsVector<T> grad = J.transpose()*rhs;
+    gsVector<T> Jgrad = J*grad;
+    gsVector<T> cauchy = grad.squaredNorm()/Jgrad.squaredNorm()*grad;
+    const T cauchyNorm = cauchy.norm();
+
+    gsVector<T> step;
+    T trialNorm;
+    for (index_t i = 0; i <= m_options.getInt("LSMaxIters"); ++i)
+    {
+        // dogleg step
+        if (newtonNorm <= trRadius)
+            step = update;
+        else if (cauchyNorm >= trRadius)
+            step = trRadius/cauchyNorm*cauchy;
+        else
+        {
+            gsVector<T> diff = update - cauchy;
+            T a = diff.squaredNorm();
+            T b = 2*cauchy.dot(diff);
+            T c = cauchyNorm*cauchyNorm - trRadius*trRadius;
+            step = cauchy + (-b + math::sqrt(b*b-4*a*c))/(2*a)*diff;
+        }
+        const T stepNorm = step.norm();
+        // ratio of the actual to the predicted reduction of 0.5*|r|^2
+        T rho = -1.;
+        if (trialResidual(step,trialNorm))
+        {
+            T predicted = rhs.squaredNorm() - (rhs - J*step).squaredNorm();
+            rho = (refNorm*refNorm - trialNorm*trialNorm)/predicted;
+        }
+        if (rho < 0.25)
+            trRadius = 0.25*stepNorm;
+        else if (rho > 0.75 && stepNorm > 0.99*trRadius)
+            trRadius *= 2;
+        if (rho > 1e-4)
+        {
+            if (m_options.getInt("Verbosity") == solver_verbosity::all && stepNorm < newtonNorm)
+                gsInfo << "Trust region: step length " << stepNorm/newtonNorm << " of the Newton update" << std::endl;
+            update = step;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class T>
+bool gsIterative<T>::computeResidual()
+{
+    if (!assembler.assembleResidual(solVector,fixedDoFs))
+        return false;
+    residualNorm = assembler.rhs().norm();
     return true;
 }
 
@@ -204,6 +607,12 @@ std::string gsIterative<T>::status()
                  ", updRel: " + util::to_string(updateNorm/initUpdateNorm) +
                  ", resAbs: " + util::to_string(residualNorm) +
                  ", resRel: " + util::to_string(residualNorm/initResidualNorm);
+    if (m_status != solver_status::working && numKrylovIterations > 0)
+        statusString += " Linear solver iterations: " + util::to_string(numKrylovIterations) + ".";
+    if (m_status != solver_status::working && m_options.getInt("QuasiNewton") != quasi_newton::none)
+        statusString += " Factorizations: " + util::to_string(numFactorizations) + ".";
+    else if (m_status == solver_status::working && m_options.getSwitch("Inexact") && eta > 0)
+        statusString += ", eta: " + util::to_string(eta);
     return statusString;
 }
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
 {
@@ -49,10 +50,27 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDDoFs) {assemble();}
 
+    /// @brief Whether the mass matrix is lumped, i.e. diagonal
+    bool lumped() const { return m_options.getInt("Lumping") != mass_lumping::consistent; }
+
+    /// @brief Returns the diagonal of the lumped mass matrix as a vector;
+    /// products with the mass matrix and its inverse become O(n) vector operations
+    const gsMatrix<T> & lumpedMass() const
+    {
+        GISMO_ENSURE(lumped(),"The mass matrix is not lumped! Set the option Lumping.");
+        return m_lumped;
+    }
+
+    /// @brief Returns the row sums of the consistent mass matrix including the columns of the fixed DoFs,
+    /// i.e. the diagonal of the row-sum lumped mass matrix; requires assemble(true)
+    gsMatrix<T> rowSums() const;
+
 protected:
     /// Dimension of the problem
     /// parametric dim = physical dim = deformation dim
     short_t m_dim;
+    /// diagonal of the lumped mass matrix
+    gsMatrix<T> m_lumped;
 
     using Base::m_pde_ptr;
     using Base::m_bases;
@@ -52,6 +52,7 @@ gsOptionList gsMassAssembler<T>::defaultOptions()
 {
     gsOptionList opt = Base::defaultOptions();
     opt.addReal("Density","Density of the material",1.);
+    opt.addInt("Lumping","Type of the mass matrix: 0 - consistent, 1 - row-sum lumped, 2 - HRZ lumped",mass_lumping::consistent);
     return opt;
 }
 
@@ -94,6 +95,8 @@ void gsMassAssembler<T>::assemble(bool saveEliminationMatrix)
     Base::template push<gsVisitorMass<T> >(visitor);
 
     m_system.matrix().makeCompressed();
+    if (lumped())
+        m_lumped = m_system.matrix().diagonal();
 
     if (saveEliminationMatrix)
     {
@@ -102,5 +105,16 @@ void gsMassAssembler<T>::assemble(bool saveEliminationMatrix)
     }
 }
 
+template<class T>
+gsMatrix<T> gsMassAssembler<T>::rowSums() const
+{
+    GISMO_ENSURE(eliminationMatrix.rows() == Base::numDofs(),
+                 "The elimination matrix is not saved! Call assemble(true).");
+    gsMatrix<T> sums = m_system.matrix()*gsMatrix<T>::Ones(Base::numDofs(),1);
+    if (eliminationMatrix.cols() > 0)
+        sums += eliminationMatrix*gsMatrix<T>::Ones(eliminationMatrix.cols(),1);
+    return sums;
+}
+
 
 }// namespace gismo ends
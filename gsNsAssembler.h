@@ -53,9 +53,17 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
 
+    /// Assembles only the residual of the Navier-Stokes system given the current solution,
+    /// independent of the chosen linearization; the matrix is not updated.
+    /// ATTENTION: rhs() returns a negative residual (-r) !!!
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
     /// Assembles the tangential linear system for Newton's method given the current solution
     /// in the form of free and fixed/Dirichelt degrees of freedom.
-    virtual void assemble(const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure);
+    /// set *assembleMatrix* to false to only assemble the residual;
+    virtual void assemble(const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
+                          bool assembleMatrix = true);
 
     //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
 
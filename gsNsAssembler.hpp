@@ -120,18 +120,34 @@ bool gsNsAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
     return true;
 }
 
+template <class T>
+bool gsNsAssembler<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                        const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    gsMultiPatch<T> velocity, pressure;
+    constructSolution(solutionVector,fixedDoFs,velocity,pressure);
+    assemble(velocity,pressure,false);
+
+    return true;
+}
+
 template <class T>
 void gsNsAssembler<T>::assemble(const gsMultiPatch<T> & velocity,
-                                const gsMultiPatch<T> & pressure)
+                                const gsMultiPatch<T> & pressure,
+                                bool assembleMatrix)
 {
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        reserve();
+    }
     m_system.rhs().setZero();
 
-    gsVisitorNavierStokes<T> visitor(*m_pde_ptr,velocity,pressure);
+    gsVisitorNavierStokes<T> visitor(*m_pde_ptr,velocity,pressure,assembleMatrix);
     Base::template push<gsVisitorNavierStokes<T> >(visitor);
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
 }
 
 //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
@@ -0,0 +1,97 @@
+/** @file gsNsPseudoTransient.h
+
+    @brief Pseudo-transient continuation for steady incompressible Navier-Stokes equations.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsSharedPatternMatrix.h>
+
+namespace gismo
+{
+
+template <class T>
+class gsNsAssembler;
+template <class T>
+class gsMassAssembler;
+
+/** @brief Pseudo-transient continuation (Psi-tc) for steady incompressible Navier-Stokes equations.
+ * Each iteration is a Newton's step regularized by the velocity mass matrix:
+ * (M/dt_k + J(u_k)) du = -F(u_k).
+ * The pseudo time step grows as the residual decreases according to the switched evolution relaxation (SER):
+ * dt_k = dt_{k-1}*|F(u_{k-1})|/|F(u_k)|, so the iteration turns into Newton's method close to the steady state.
+ * To be used with gsIterative in the update mode; every iteration requires one tangential assembly and one linear solve.
+*/
+template <class T>
+class gsNsPseudoTransient : public gsBaseAssembler<T>
+{
+public:
+    typedef gsBaseAssembler<T> Base;
+    /// constructor method. requires a gsNsAssembler for the tangential system
+    /// and a gsMassAssembler for the velocity mass matrix
+    gsNsPseudoTransient(gsNsAssembler<T> & stiffAssembler_,
+                        gsMassAssembler<T> & massAssembler_);
+
+    /// @brief Returns the list of default options for assembly
+    static gsOptionList defaultOptions();
+
+    /// assemble the regularized tangential system and update the pseudo time step
+    virtual bool assemble(const gsMatrix<T> & solutionVector,
+                          const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    /// assemble only the steady residual
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    /// returns number of degrees of freedom
+    virtual int numDofs() const;
+
+    /// current pseudo time step
+    T pseudoTimeStep() const { return pseudoStep; }
+
+    /// restart the pseudo time stepping from the initial step
+    void reset() { numIters = 0; }
+
+    /// construct the solution using the stiffness matrix assembler
+    void constructSolution(const gsMatrix<T> & solVector,
+                           const std::vector<gsMatrix<T> > & fixedDoFs,
+                           gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const;
+
+    /// assemblers' accessors
+    gsBaseAssembler<T> & mAssembler();
+    gsBaseAssembler<T> & assembler();
+
+protected:
+    /// assembler object that generates the static system
+    gsNsAssembler<T> & stiffAssembler;
+    /// assembler object that generates the velocity mass matrix
+    gsMassAssembler<T> & massAssembler;
+    /// current pseudo time step
+    T pseudoStep;
+    /// residual norm at the previous iteration
+    T prevResidualNorm;
+    /// number of assembled iterations
+    index_t numIters;
+    /// combines the Jacobian and the mass matrix on a shared pattern
+    gsSharedPatternMatrix<T> combination;
+    using Base::m_system;
+    using Base::m_options;
+    using Base::m_ddof;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsNsPseudoTransient.hpp)
+#endif
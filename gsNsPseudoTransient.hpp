@@ -0,0 +1,121 @@
+/** @file gsNsPseudoTransient.hpp
+
+    @brief Implementation of gsNsPseudoTransient.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsNsPseudoTransient.h>
+
+#include <gsElasticity/gsNsAssembler.h>
+#include <gsElasticity/gsMassAssembler.h>
+
+namespace gismo
+{
+
+template <class T>
+gsNsPseudoTransient<T>::gsNsPseudoTransient(gsNsAssembler<T> & stiffAssembler_,
+                                            gsMassAssembler<T> & massAssembler_)
+    : stiffAssembler(stiffAssembler_),
+      massAssembler(massAssembler_),
+      pseudoStep(0.),
+      prevResidualNorm(0.),
+      numIters(0)
+{
+    m_options = defaultOptions();
+    m_ddof = stiffAssembler.allFixedDofs();
+}
+
+template <class T>
+gsOptionList gsNsPseudoTransient<T>::defaultOptions()
+{
+    gsOptionList opt = Base::defaultOptions();
+    opt.addReal("InitStep","Initial pseudo time step",1e-2);
+    opt.addReal("MaxStep","Maximal pseudo time step",1e12);
+    opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    return opt;
+}
+
+template <class T>
+int gsNsPseudoTransient<T>::numDofs() const { return stiffAssembler.numDofs(); }
+
+template <class T>
+bool gsNsPseudoTransient<T>::assemble(const gsMatrix<T> & solutionVector,
+                                      const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    const bool firstIter = numIters == 0;
+    // at the first iteration, the update contains the Dirichlet increment m_ddof;
+    // its mass term M_FD*du_D/dt is eliminated in the same way as in the stiffness assembler
+    if (firstIter)
+    {
+        massAssembler.setFixedDofs(m_ddof);
+        massAssembler.assemble();
+    }
+
+    // the stiffness assembler has to eliminate the same Dirichlet increments as the iterative solver,
+    // i.e. zero after the first iteration. Its options are restored afterwards
+    std::vector<gsMatrix<T> > ddofs = stiffAssembler.allFixedDofs();
+    const index_t assemblyType = stiffAssembler.options().getInt("Assembly");
+    stiffAssembler.setFixedDofs(m_ddof);
+    stiffAssembler.options().setInt("Assembly",ns_assembly::newton_update);
+    bool valid = stiffAssembler.assemble(solutionVector,fixedDoFs);
+    stiffAssembler.options().setInt("Assembly",assemblyType);
+    stiffAssembler.setFixedDofs(ddofs);
+    if (!valid)
+        return false;
+
+    // switched evolution relaxation
+    T residualNorm = stiffAssembler.rhs().norm();
+    if (numIters == 0)
+        pseudoStep = m_options.getReal("InitStep");
+    else if (residualNorm > 0)
+        pseudoStep = math::min(pseudoStep*prevResidualNorm/residualNorm,m_options.getReal("MaxStep"));
+    prevResidualNorm = residualNorm;
+    ++numIters;
+    if (m_options.getInt("Verbosity") == solver_verbosity::all)
+        gsInfo << "Pseudo time step: " << pseudoStep << std::endl;
+
+    // matrix = M/dt + J
+    combination.combine(1.,stiffAssembler.matrix(),1./pseudoStep,massAssembler.matrix(),m_system.matrix());
+
+    m_system.rhs() = stiffAssembler.rhs();
+    // rhs: -M_FD*du_D/dt
+    if (firstIter)
+        m_system.rhs().middleRows(0,massAssembler.numDofs()) += massAssembler.rhs()/pseudoStep;
+    return true;
+}
+
+template <class T>
+bool gsNsPseudoTransient<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                              const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    if (!stiffAssembler.assembleResidual(solutionVector,fixedDoFs))
+        return false;
+    m_system.rhs() = stiffAssembler.rhs();
+    return true;
+}
+
+template <class T>
+void gsNsPseudoTransient<T>::constructSolution(const gsMatrix<T> & solVector,
+                                               const std::vector<gsMatrix<T> > & fixedDoFs,
+                                               gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const
+{
+    stiffAssembler.constructSolution(solVector,fixedDoFs,velocity,pressure);
+}
+
+template <class T>
+gsBaseAssembler<T> & gsNsPseudoTransient<T>::mAssembler() { return massAssembler; }
+
+template <class T>
+gsBaseAssembler<T> & gsNsPseudoTransient<T>::assembler() { return stiffAssembler; }
+
+} // namespace ends
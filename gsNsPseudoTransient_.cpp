@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsNsPseudoTransient.h>
+#include <gsElasticity/gsNsPseudoTransient.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsNsPseudoTransient<real_t>;
+}
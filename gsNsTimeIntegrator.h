@@ -16,6 +16,8 @@
 
 #include <gsElasticity/gsBaseAssembler.h>
 #include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsSharedPatternMatrix.h>
+#include <gsSolver/gsSparseSolver.h>
 
 namespace gismo
 {
@@ -24,6 +26,10 @@ template <class T>
 class gsNsAssembler;
 template <class T>
 class gsMassAssembler;
+template <class T>
+class gsCheckpointWriter;
+template <class T>
+class gsCheckpointReader;
 
 /** @brief Time integation for incompressible Navier-Stokes equations.
 */
@@ -81,6 +87,13 @@ public:
     /// recover solver state from the previously saved state
     void recoverState();
 
+    /// write the solver state to a checkpoint; the saved state is not written
+    void writeCheckpoint(gsCheckpointWriter<T> & writer);
+
+    /// restore the solver state from a checkpoint; the mass matrix is reassembled,
+    /// so the flow domain must be in the same configuration as when the checkpoint was written
+    void readCheckpoint(gsCheckpointReader<T> & reader);
+
     /// number of iterations Newton's method required at the last time step; always 1 for IMEX
     index_t numberIterations() const { return numIters;}
 
@@ -100,6 +113,17 @@ protected:
     /// time integraton schemes
     void implicitLinear();
     void implicitNonlinear();
+    void bdf2Nonlinear();
+    void bdf2Imex();
+
+    /// compute the explicit part of the theta-scheme from the last assembled system
+    void updateExplicitPart();
+
+    /// variable step BDF2 coefficients: a0*u_n+1 + a1*u_n + a2*u_n-1; implicit Euler at the first step
+    void bdf2Coefs(T & a0, T & a1, T & a2) const;
+
+    /// BDF2 history terms of the right-hand side and the new Dirichlet DoFs of the mass matrix
+    void bdf2MassRHS(gsMatrix<T> & rhs, T a0, T a1, T a2);
 
 protected:
     /// assembler object that generates the static system
@@ -120,9 +144,26 @@ protected:
     T oldTimeStep;
     gsMatrix<T> oldSolVector;
 
+    /// explicit part of the theta-scheme from the previous time step: F_n - A(u_n)*u_n
+    gsMatrix<T> explicitPart;
+
     /// Newton stuff
     gsMatrix<T> constRHS;
     index_t numIters;
+    /// coefficients of the mass and the stiffness matrix in the nonlinear system (theta-scheme or BDF2)
+    T massCoef, stiffCoef;
+    /// combine the stiffness (or the Stokes) and the mass matrices on a shared pattern;
+    /// one object per matrix pair so that the cached patterns are not invalidated in turn
+    gsSharedPatternMatrix<T> combination;
+    gsSharedPatternMatrix<T> stokesCombination;
+
+    /// BDF2 stuff
+    index_t numSteps;
+    gsMatrix<T> oldMassRhs;
+    /// IMEX BDF2: Stokes matrix and the factorized constant matrix with the parameters it was computed for
+    gsSparseMatrix<T> stokesMatrix;
+    typename gsSparseSolver<T>::LU imexSolver;
+    T imexStep, imexCoef;
 
     /// ALE velocity
     gsMultiPatch<T> * velocityALE;
@@ -134,8 +175,11 @@ protected:
     gsMatrix<T> velVecSaved;
     gsMatrix<T> oldVecSaved;
     gsMatrix<T> massRhsSaved;
-    gsMatrix<T> stiffRhsSaved;
-    gsSparseMatrix<T> stiffMatrixSaved;
+    gsMatrix<T> oldMassRhsSaved;
+    T oldTimeStepSaved;
+    index_t numStepsSaved;
+    gsMatrix<T> explicitPartSaved;
+    bool stateChanged;
     std::vector<gsMatrix<T> > ddofsSaved;
 };
 
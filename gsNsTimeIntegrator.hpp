@@ -20,6 +20,7 @@
 #include <gsElasticity/gsNsAssembler.h>
 #include <gsElasticity/gsMassAssembler.h>
 #include <gsElasticity/gsIterative.h>
+#include <gsElasticity/gsCheckpoint.h>
 
 namespace gismo
 {
@@ -38,7 +39,13 @@ gsNsTimeIntegrator<T>::gsNsTimeIntegrator(gsNsAssembler<T> & stiffAssembler_,
     m_options = defaultOptions();
     m_ddof = stiffAssembler.allFixedDofs();
     numIters = 0;
+    massCoef = 1.;
+    stiffCoef = 1.;
+    numSteps = 0;
+    imexStep = 0.;
+    imexCoef = 0.;
     hasSavedState = false;
+    stateChanged = false;
 }
 
 template <class T>
@@ -64,6 +71,12 @@ void gsNsTimeIntegrator<T>::initialize()
     // IMEX stuff
     oldSolVector = solVector;
     oldTimeStep = 1.;
+    // BDF2 stuff
+    oldMassRhs = massAssembler.rhs();
+    numSteps = 0;
+    stokesMatrix.resize(0,0);
+    imexStep = 0.;
+    updateExplicitPart();
 
     initialized = true;
 }
@@ -71,6 +84,7 @@ void gsNsTimeIntegrator<T>::initialize()
 template <class T>
 void gsNsTimeIntegrator<T>::makeTimeStep(T timeStep)
 {
+    ELAST_PROFILE_REGION("flow time step");
     if (!initialized)
         initialize();
 
@@ -79,6 +93,23 @@ void gsNsTimeIntegrator<T>::makeTimeStep(T timeStep)
         implicitNonlinear();
     if (m_options.getInt("Scheme") == time_integration::implicit_linear)
         implicitLinear();
+    if (m_options.getInt("Scheme") == time_integration::bdf2)
+        bdf2Nonlinear();
+    if (m_options.getInt("Scheme") == time_integration::imex_bdf2)
+        bdf2Imex();
+    ++numSteps;
+    updateExplicitPart();
+    stateChanged = true;
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::updateExplicitPart()
+{
+    index_t numDofsVel = massAssembler.numDofs();
+    // F_n - A(u_n)*u_n; only the velocity block is multiplied since the pressure is treated implicitly
+    explicitPart = stiffAssembler.rhs();
+    explicitPart.middleRows(0,numDofsVel).noalias() -= stiffAssembler.matrix().block(0,0,numDofsVel,numDofsVel) *
+                                                       solVector.middleRows(0,numDofsVel);
 }
 
 template <class T>
@@ -89,11 +120,8 @@ void gsNsTimeIntegrator<T>::implicitLinear()
     stiffAssembler.options().setInt("Assembly",ns_assembly::ossen);
 
     // rhs = M*u_n - dt*(1-theta)*A(u_n)*u_n + dt*(1-theta)*F_n + dt*theta*F_n+1
-    // rhs: dt*(1-theta)*F_n
-    m_system.rhs() = tStep*(1-theta)*stiffAssembler.rhs();
-    // rhs: -dt*(1-theta)*A(u_n)*u_n
-    m_system.rhs().middleRows(0,numDofsVel) -= tStep*(1-theta)*stiffAssembler.matrix().block(0,0,numDofsVel,numDofsVel) *
-                                                               solVector.middleRows(0,numDofsVel);
+    // rhs: dt*(1-theta)*(F_n - A(u_n)*u_n)
+    m_system.rhs() = tStep*(1-theta)*explicitPart;
     // rhs: M*u_n
     m_system.rhs().middleRows(0,numDofsVel) += massAssembler.matrix() *
                                                solVector.middleRows(0,numDofsVel);
@@ -119,17 +147,8 @@ void gsNsTimeIntegrator<T>::implicitLinear()
     m_system.rhs() += tStep*theta*stiffAssembler.rhs();
     // rhs: -M_FD*u_DDOFS_n+1
     m_system.rhs().middleRows(0,numDofsVel) += massAssembler.rhs();
-    // matrix = M + dt*theta*A(u_exp)
-    m_system.matrix() = tStep*stiffAssembler.matrix();
-    // we need to modify the (0,0,numDofsVel,numDofsVel) block of the matrix.
-    // unfortunately, eigen provides only a read-only block interfaces.
-    // the following is an ugly way to overcome this
-    gsSparseMatrix<T> tempVelocityBlock = m_system.matrix().block(0,0,numDofsVel,numDofsVel);
-    tempVelocityBlock *= (theta-1);
-    tempVelocityBlock += massAssembler.matrix();
-    tempVelocityBlock.conservativeResize(stiffAssembler.numDofs(),numDofsVel);
-    m_system.matrix().leftCols(numDofsVel) += tempVelocityBlock;
-    m_system.matrix().makeCompressed();
+    // matrix = M + dt*theta*A(u_exp); only the velocity block is scaled by theta
+    combination.combine(tStep,tStep*theta,stiffAssembler.matrix(),1.,massAssembler.matrix(),m_system.matrix());
 
     oldSolVector = solVector;
     oldTimeStep = tStep;
@@ -137,11 +156,13 @@ void gsNsTimeIntegrator<T>::implicitLinear()
     numIters = 1;
 
 #ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLU solver(m_system.matrix());
-    solVector = solver.solve(m_system.rhs());
+    gsSparseSolver<>::PardisoLU solver;
+    gsProfiledFactorize(solver,m_system.matrix());
+    solVector = gsProfiledSolve(solver,m_system.rhs());
 #else
-    gsSparseSolver<>::LU solver(m_system.matrix());
-    solVector = solver.solve(m_system.rhs());
+    gsSparseSolver<>::LU solver;
+    gsProfiledFactorize(solver,m_system.matrix());
+    solVector = gsProfiledSolve(solver,m_system.rhs());
 #endif
 }
 
@@ -152,8 +173,7 @@ void gsNsTimeIntegrator<T>::implicitNonlinear()
     T theta = m_options.getReal("Theta");
     index_t numDofsVel = massAssembler.numDofs();
 
-    constRHS = tStep*(1-theta)*stiffAssembler.rhs();
-    constRHS.middleRows(0,numDofsVel).noalias() -= tStep*(1-theta)*stiffAssembler.matrix().block(0,0,numDofsVel,numDofsVel)*solVector.middleRows(0,numDofsVel);
+    constRHS = tStep*(1-theta)*explicitPart;
     constRHS.middleRows(0,numDofsVel).noalias() += massAssembler.matrix()*solVector.middleRows(0,numDofsVel);
     constRHS.middleRows(0,numDofsVel).noalias() -= massAssembler.rhs();
     massAssembler.setFixedDofs(stiffAssembler.allFixedDofs());
@@ -162,6 +182,8 @@ void gsNsTimeIntegrator<T>::implicitNonlinear()
     else
         massAssembler.eliminateFixedDofs();
     constRHS.middleRows(0,numDofsVel).noalias() += massAssembler.rhs();
+    massCoef = 1.;
+    stiffCoef = theta;
 
     gsIterative<T> solver(*this,solVector,m_ddof);
     solver.options().setInt("Verbosity",m_options.getInt("Verbosity"));
@@ -176,12 +198,116 @@ void gsNsTimeIntegrator<T>::implicitNonlinear()
     numIters = solver.numberIterations();
 }
 
+template <class T>
+void gsNsTimeIntegrator<T>::bdf2Coefs(T & a0, T & a1, T & a2) const
+{
+    if (numSteps == 0)
+    {
+        a0 = 1.;
+        a1 = -1.;
+        a2 = 0.;
+    }
+    else
+    {
+        T omega = tStep/oldTimeStep;
+        a0 = (1+2*omega)/(1+omega);
+        a1 = -(1+omega);
+        a2 = omega*omega/(1+omega);
+    }
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::bdf2MassRHS(gsMatrix<T> & rhs, T a0, T a1, T a2)
+{
+    index_t numDofsVel = massAssembler.numDofs();
+    // rhs = -a1*M*u_n - a2*M*u_n-1 - a0*M_FD*u_DDOFS_n+1 (mass rhs stores -M_FD*u_DDOFS)
+    rhs.setZero(stiffAssembler.numDofs(),1);
+    rhs.middleRows(0,numDofsVel).noalias() -= a1*(massAssembler.matrix()*solVector.middleRows(0,numDofsVel) - massAssembler.rhs());
+    if (a2 != 0.)
+        rhs.middleRows(0,numDofsVel).noalias() -= a2*(massAssembler.matrix()*oldSolVector.middleRows(0,numDofsVel) - oldMassRhs);
+    oldMassRhs = massAssembler.rhs();
+    massAssembler.setFixedDofs(stiffAssembler.allFixedDofs());
+    if (m_options.getSwitch("ALE"))
+        massAssembler.assemble();
+    else
+        massAssembler.eliminateFixedDofs();
+    rhs.middleRows(0,numDofsVel).noalias() += a0*massAssembler.rhs();
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::bdf2Nonlinear()
+{
+    stiffAssembler.options().setInt("Assembly",ns_assembly::newton_next);
+    T a0, a1, a2;
+    bdf2Coefs(a0,a1,a2);
+    bdf2MassRHS(constRHS,a0,a1,a2);
+    massCoef = a0;
+    stiffCoef = 1.;
+
+    gsIterative<T> solver(*this,solVector,m_ddof);
+    solver.options().setInt("Verbosity",m_options.getInt("Verbosity"));
+    solver.options().setInt("Solver",linear_solver::LU);
+    solver.options().setInt("IterType",iteration_type::next);
+    solver.options().setReal("AbsTol",m_options.getReal("AbsTol"));
+    solver.options().setReal("RelTol",m_options.getReal("RelTol"));
+    solver.solve();
+
+    oldSolVector = solVector;
+    oldTimeStep = tStep;
+    solVector = solver.solution();
+    m_ddof = stiffAssembler.allFixedDofs();
+    numIters = solver.numberIterations();
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::bdf2Imex()
+{
+    T a0, a1, a2;
+    bdf2Coefs(a0,a1,a2);
+    bdf2MassRHS(m_system.rhs(),a0,a1,a2);
+
+    // Stokes matrix; constant unless the flow domain deforms
+    if (m_options.getSwitch("ALE") || stokesMatrix.rows() == 0)
+    {
+        stiffAssembler.assemble();
+        stokesMatrix = stiffAssembler.matrix();
+    }
+
+    // second-order extrapolation of the solution for the explicit convection
+    gsMatrix<T> extrapolated = solVector;
+    if (numSteps > 0)
+        extrapolated += tStep/oldTimeStep*(solVector-oldSolVector);
+    gsMultiPatch<T> velocity, pressure;
+    stiffAssembler.constructSolution(extrapolated,stiffAssembler.allFixedDofs(),velocity,pressure);
+    if (m_options.getSwitch("ALE"))
+        for (index_t p = 0; p < interface->patches.size(); ++p)
+            velocity.patch(interface->patches[p].second).coefs() -=
+                    velocityALE->patch(interface->patches[p].first).coefs();
+    stiffAssembler.options().setInt("Assembly",ns_assembly::ossen);
+    stiffAssembler.assemble(velocity,pressure);
+    // rhs: dt*(F_n+1 - A_FD*u_DDOFS_n+1 - C(u_ext)*u_ext) with the convection matrix C = A_Oseen - A_Stokes
+    m_system.rhs() += tStep*(stiffAssembler.rhs() - (stiffAssembler.matrix() - stokesMatrix)*extrapolated);
+
+    // matrix = a0*M + dt*A_Stokes; factorized only if the time step or the domain change
+    if (m_options.getSwitch("ALE") || tStep != imexStep || a0 != imexCoef)
+    {
+        stokesCombination.combine(tStep,stokesMatrix,a0,massAssembler.matrix(),m_system.matrix());
+        gsProfiledFactorize(imexSolver,m_system.matrix());
+        imexStep = tStep;
+        imexCoef = a0;
+    }
+
+    oldSolVector = solVector;
+    oldTimeStep = tStep;
+    m_ddof = stiffAssembler.allFixedDofs();
+    numIters = 1;
+    solVector = gsProfiledSolve(imexSolver,m_system.rhs());
+}
+
 template <class T>
 bool gsNsTimeIntegrator<T>::assemble(const gsMatrix<T> & solutionVector,
                                      const std::vector<gsMatrix<T> > & fixedDoFs)
 {
-    T theta = m_options.getReal("Theta");
-
     gsMultiPatch<T> velocity, pressure;
     stiffAssembler.constructSolution(solutionVector,fixedDoFs,velocity,pressure);
     if (m_options.getSwitch("ALE"))
@@ -190,16 +316,9 @@ bool gsNsTimeIntegrator<T>::assemble(const gsMatrix<T> & solutionVector,
                     velocityALE->patch(interface->patches[p].first).coefs();
     stiffAssembler.assemble(velocity,pressure);
 
-    m_system.matrix() = tStep*stiffAssembler.matrix();
-    index_t numDofsVel = massAssembler.numDofs();
-    gsSparseMatrix<T> tempVelocityBlock = m_system.matrix().block(0,0,numDofsVel,numDofsVel);
-    tempVelocityBlock *= (theta-1);
-    tempVelocityBlock += massAssembler.matrix();
-    tempVelocityBlock.conservativeResize(stiffAssembler.numDofs(),numDofsVel);
-    m_system.matrix().leftCols(numDofsVel) += tempVelocityBlock;
-    m_system.matrix().makeCompressed();
-
-    m_system.rhs() = tStep*theta*stiffAssembler.rhs() + constRHS;
+    combination.combine(tStep,tStep*stiffCoef,stiffAssembler.matrix(),massCoef,massAssembler.matrix(),m_system.matrix());
+
+    m_system.rhs() = tStep*stiffCoef*stiffAssembler.rhs() + constRHS;
     return true;
 }
 
@@ -221,25 +340,92 @@ void gsNsTimeIntegrator<T>::saveState()
     if (!initialized)
         initialize();
 
+    // the stiffness matrix is not saved: the next time step needs only the explicit part
+    // of the previous one which is stored as a vector; assignment reuses the allocated memory
     velVecSaved = solVector;
     oldVecSaved = oldSolVector;
     massRhsSaved = massAssembler.rhs();
-    stiffRhsSaved = stiffAssembler.rhs();
-    stiffMatrixSaved = stiffAssembler.matrix();
+    oldMassRhsSaved = oldMassRhs;
+    explicitPartSaved = explicitPart;
+    oldTimeStepSaved = oldTimeStep;
+    numStepsSaved = numSteps;
     ddofsSaved = m_ddof;
     hasSavedState = true;
+    stateChanged = false;
 }
 
 template <class T>
 void gsNsTimeIntegrator<T>::recoverState()
 {
     GISMO_ENSURE(hasSavedState,"No state saved!");
+    // nothing to recover if no time step has been made since the state was saved or recovered
+    if (!stateChanged)
+        return;
     solVector = velVecSaved;
     oldSolVector = oldVecSaved;
     massAssembler.setRHS(massRhsSaved);
-    stiffAssembler.setMatrix(stiffMatrixSaved);
-    stiffAssembler.setRHS(stiffRhsSaved);
+    oldMassRhs = oldMassRhsSaved;
+    explicitPart = explicitPartSaved;
+    oldTimeStep = oldTimeStepSaved;
+    numSteps = numStepsSaved;
     m_ddof = ddofsSaved;
+    stateChanged = false;
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::writeCheckpoint(gsCheckpointWriter<T> & writer)
+{
+    if (!initialized)
+        initialize();
+    writer.section("gsNsTimeIntegrator");
+    writer.write("Scheme",index_t(m_options.getInt("Scheme")));
+    writer.write("solution",solVector);
+    writer.write("oldSolution",oldSolVector);
+    writer.write("explicitPart",explicitPart);
+    writer.write("massRhs",massAssembler.rhs());
+    writer.write("oldMassRhs",oldMassRhs);
+    writer.write("oldTimeStep",oldTimeStep);
+    writer.write("numSteps",numSteps);
+    writer.write("fixedDofs",m_ddof);
+    // Dirichlet DoFs of the assembler may have been changed after the last time step
+    writer.write("assemblerFixedDofs",stiffAssembler.allFixedDofs());
+    writer.write("numIters",numIters);
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::readCheckpoint(gsCheckpointReader<T> & reader)
+{
+    index_t scheme;
+    gsMatrix<T> massRhs;
+    std::vector<gsMatrix<T> > assemblerDdofs;
+    reader.section("gsNsTimeIntegrator");
+    reader.read("Scheme",scheme);
+    GISMO_ENSURE(scheme == m_options.getInt("Scheme"),"Checkpoint was written with a different time integration scheme.");
+    reader.read("solution",solVector);
+    reader.read("oldSolution",oldSolVector);
+    reader.read("explicitPart",explicitPart);
+    reader.read("massRhs",massRhs);
+    reader.read("oldMassRhs",oldMassRhs);
+    reader.read("oldTimeStep",oldTimeStep);
+    reader.read("numSteps",numSteps);
+    reader.read("fixedDofs",m_ddof);
+    reader.read("assemblerFixedDofs",assemblerDdofs);
+    reader.read("numIters",numIters);
+    GISMO_ENSURE(solVector.rows() == stiffAssembler.numDofs(),"Checkpoint does not match the discretization.");
+
+    // the mass matrix of the last time step is recomputed in the current configuration of the flow domain;
+    // the stiffness matrix is not needed since the explicit part is restored
+    stiffAssembler.setFixedDofs(assemblerDdofs);
+    massAssembler.setFixedDofs(m_ddof);
+    massAssembler.assemble(true);
+    massAssembler.setRHS(massRhs);
+    // IMEX BDF2 matrix is refactorized at the next time step
+    stokesMatrix.resize(0,0);
+    imexStep = 0.;
+    imexCoef = 0.;
+    initialized = true;
+    hasSavedState = false;
+    stateChanged = false;
 }
 
 } // namespace ends
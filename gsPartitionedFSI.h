@@ -27,6 +27,12 @@ template <class T>
 class gsALE;
 template <class T>
 class gsMultiPatch;
+template <class T>
+class gsFsiInterfaceLoad;
+template <class T>
+class gsCheckpointWriter;
+template <class T>
+class gsCheckpointReader;
 
 template <class T>
 class gsPartitionedFSI
@@ -46,9 +52,24 @@ public:
     /// get options list to read or set parameters
     gsOptionList & options() { return m_options; }
 
+    /// set an assembled interface load which is updated at the beginning of each coupling iteration;
+    /// the load vector must be passed to the elasticity assembler via setExternalLoad
+    void setInterfaceLoad(gsFsiInterfaceLoad<T> * interfaceLoad) { m_interfaceLoad = interfaceLoad; }
+
     /// make the next time step
     bool makeTimeStep(T timeStep);
 
+    /// write the state of the coupled problem to a checkpoint between time steps:
+    /// the deformed flow domain, the solution fields and the states of the component solvers
+    void writeCheckpoint(gsCheckpointWriter<T> & writer);
+
+    /// restore the state of the coupled problem from a checkpoint; the subsequent time steps
+    /// continue the simulation that wrote the checkpoint. With a deterministic assembly (OMP_NUM_THREADS=1)
+    /// they reproduce an uninterrupted run bit for bit, see flappingBeam_FSI2_restartCheck2D.
+    /// With several threads, the assembly sums element contributions in varying order,
+    /// so a restarted run agrees with an uninterrupted one only up to round-off
+    void readCheckpoint(gsCheckpointReader<T> & reader);
+
     /// form a residual vector
     void formVector(const gsMultiPatch<T> & disp, gsMatrix<T> & vector);
 
@@ -79,6 +100,8 @@ protected:
     gsALE<T> & m_aleSolver;
     gsMultiPatch<T> & m_ALEdisplacment;
     gsMultiPatch<T> & m_ALEvelocity;
+    /// optional assembled fluid load on the FSI interface
+    gsFsiInterfaceLoad<T> * m_interfaceLoad;
     /// option list
     gsOptionList m_options;
     /// status variables
@@ -19,8 +19,10 @@
 #include <gsElasticity/gsNsTimeIntegrator.h>
 #include <gsElasticity/gsElTimeIntegrator.h>
 #include <gsElasticity/gsALE.h>
-#include <gsUtils/gsStopwatch.h>
+#include <gsElasticity/gsFsiInterfaceLoad.h>
+#include <gsElasticity/gsProfiler.h>
 #include <gsElasticity/gsGeoUtils.h>
+#include <gsElasticity/gsCheckpoint.h>
 
 namespace gismo
 {
@@ -40,6 +42,7 @@ gsPartitionedFSI<T>::gsPartitionedFSI(gsNsTimeIntegrator<T> & nsSolver,
     m_aleSolver(aleSolver),
     m_ALEdisplacment(aleDisplacement),
     m_ALEvelocity(aleVelocity),
+    m_interfaceLoad(nullptr),
     m_options(defaultOptions())
 {
 
@@ -59,6 +62,7 @@ gsOptionList gsPartitionedFSI<T>::defaultOptions()
 template <class T>
 bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
 {
+    ELAST_PROFILE_REGION("FSI time step");
     // save states of the component solvers at the beginning of the time step
     m_nsSolver.saveState();
     m_elSolver.saveState();
@@ -70,7 +74,6 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
     omega = 1.;
 
     // reset time profiling info
-    gsStopwatch clock;
     nsTime = elTime = aleTime = 0.;
 
     gsMultiPatch<> dispOldOld, dispOld, dispOldGuess;
@@ -78,9 +81,12 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
     while (numIter < m_options.getInt("MaxIter") && !converged)
     {
         // ================== Structure section ================ //
-        clock.restart();
+        gsProfileScope structureProfile("FSI structure");
         if (numIter > 0) // recover the solver state from the time step beginning
             m_elSolver.recoverState();
+        // integrate the current fluid traction into the interface load vector
+        if (m_interfaceLoad)
+            m_interfaceLoad->assemble();
 
         m_elSolver.makeTimeStep(timeStep);
 
@@ -109,12 +115,12 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
             gsInfo << numIter << ": absRes " << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
 
 
-        elTime += clock.stop();
+        elTime += structureProfile.stop();
         // =================================================================== //
 
 
         // ============= Flow mesh/ALE section ===================== //
-        clock.restart();
+        gsProfileScope aleProfile("FSI ALE");
         // recover ALE at the start of timestep
         if (numIter > 0)
             m_aleSolver.recoverState();
@@ -147,12 +153,12 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
             m_nsSolver.mAssembler().patches().patch(pFlow).coefs() += m_ALEdisplacment.patch(pALE).coefs();
         }
 
-        aleTime += clock.stop();
+        aleTime += aleProfile.stop();
         // =================================================================== //
 
 
         // ======================= Flow section ============================== //
-        clock.restart();
+        gsProfileScope flowProfile("FSI flow");
         if (numIter > 0) // recover the solver state from the time step beginning
             m_nsSolver.recoverState();
 
@@ -170,11 +176,12 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
         m_nsSolver.makeTimeStep(timeStep);
         m_nsSolver.constructSolution(m_velocity,m_pressure);
 
-        nsTime += clock.stop();
+        nsTime += flowProfile.stop();
         // =================================================================== //
 
 
         ++numIter;
+        ELAST_PROFILE_COUNT("coupling iterations",1);
     }
 
     if (m_options.getInt("Verbosity") != solver_verbosity::none && numIter > 1)
@@ -246,4 +253,38 @@ void gsPartitionedFSI<T>::aitken(gsMultiPatch<T> & dispOO, gsMultiPatch<T> & dis
         converged = true;
 }
 
+template <class T>
+void gsPartitionedFSI<T>::writeCheckpoint(gsCheckpointWriter<T> & writer)
+{
+    writer.section("gsPartitionedFSI");
+    // the flow domain is deformed incrementally, so its control points are stored rather than recomputed
+    writer.writeCoefs("flowGeometry",m_nsSolver.assembler().patches());
+    writer.writeCoefs("flowMassGeometry",m_nsSolver.mAssembler().patches());
+    writer.writeCoefs("velocity",m_velocity);
+    writer.writeCoefs("pressure",m_pressure);
+    writer.writeCoefs("displacement",m_displacement);
+    writer.writeCoefs("ALEdisplacement",m_ALEdisplacment);
+    writer.writeCoefs("ALEvelocity",m_ALEvelocity);
+    m_nsSolver.writeCheckpoint(writer);
+    m_elSolver.writeCheckpoint(writer);
+    m_aleSolver.writeCheckpoint(writer);
+}
+
+template <class T>
+void gsPartitionedFSI<T>::readCheckpoint(gsCheckpointReader<T> & reader)
+{
+    reader.section("gsPartitionedFSI");
+    // the flow domain is restored first since the flow solver reassembles its mass matrix on it
+    reader.readCoefs("flowGeometry",m_nsSolver.assembler().patches());
+    reader.readCoefs("flowMassGeometry",m_nsSolver.mAssembler().patches());
+    reader.readCoefs("velocity",m_velocity);
+    reader.readCoefs("pressure",m_pressure);
+    reader.readCoefs("displacement",m_displacement);
+    reader.readCoefs("ALEdisplacement",m_ALEdisplacment);
+    reader.readCoefs("ALEvelocity",m_ALEvelocity);
+    m_nsSolver.readCheckpoint(reader);
+    m_elSolver.readCheckpoint(reader);
+    m_aleSolver.readCheckpoint(reader);
+}
+
 } // namespace ends
@@ -0,0 +1,504 @@
+/** @file gsProfiler.h
+
+    @brief Lightweight hierarchical profiler with a JSON report and an optional Chrome trace.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gismo
+{
+
+/** @brief Collects the time spent in profiled scopes as a call tree and writes it to a JSON file at exit.
+ *
+ * The profiler is off by default. It is switched on by the environment variable ELAST_PROFILE=<report.json>,
+ * optionally with ELAST_TRACE=<trace.json> for a trace readable by chrome://tracing or Perfetto,
+ * or by calling gsProfiler::instance().enable(). A disabled fine-grained scope costs one branch;
+ * defining ELAST_NO_PROFILING removes the profiling macros completely.
+ *
+ * Scopes are either regions (coarse operations: assembly, factorization, time steps, output)
+ * or fine-grained scopes (element-wise computations). Only regions appear in the trace.
+ * Every thread records its own call tree; scopes opened by OpenMP threads are attached to the innermost region
+ * of the main thread, so element-wise timings end up under the assembly that started them.
+ * The main thread is the one that runs the static initialization of the program, enable() or setMainThread().
+ * Background threads which do not work for the main thread's current region call detachThread() (or the macro
+ * ELAST_PROFILE_DETACH_THREAD) and record a separate call tree. The times of parallel scopes are summed over the threads.
+*/
+class gsProfiler
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    /// node of a call tree
+    struct Node
+    {
+        Node(const char * name_, Node * parent_)
+            : name(name_), parent(parent_), calls(0), time(0.), minTime(0.), maxTime(0.) {}
+        ~Node()
+        {
+            for (size_t i = 0; i < children.size(); ++i)
+                delete children[i];
+        }
+
+        Node * child(const char * childName)
+        {
+            // names are string literals, so the pointers usually match
+            for (size_t i = 0; i < children.size(); ++i)
+                if (children[i]->name == childName || std::strcmp(children[i]->name,childName) == 0)
+                    return children[i];
+            children.push_back(new Node(childName,this));
+            return children.back();
+        }
+
+        void add(double elapsed)
+        {
+            minTime = calls == 0 ? elapsed : std::min(minTime,elapsed);
+            maxTime = std::max(maxTime,elapsed);
+            time += elapsed;
+            ++calls;
+        }
+
+        long & counter(const char * counterName)
+        {
+            for (size_t i = 0; i < counters.size(); ++i)
+                if (std::strcmp(counters[i].first,counterName) == 0)
+                    return counters[i].second;
+            counters.push_back(std::make_pair(counterName,0L));
+            return counters.back().second;
+        }
+
+        const char * name;
+        Node * parent;
+        std::vector<Node *> children;
+        long calls;
+        double time, minTime, maxTime;
+        std::vector<std::pair<const char *,long> > counters;
+    };
+
+    static gsProfiler & instance()
+    {
+        static gsProfiler profiler;
+        return profiler;
+    }
+
+    static bool enabled() { return instance().m_enabled.load(std::memory_order_relaxed); }
+
+    /// id of the thread that ran the static initialization of the program
+    static std::thread::id initialThread()
+    {
+        static const std::thread::id id = std::this_thread::get_id();
+        return id;
+    }
+
+    /// switch the profiler on; the report (and the trace if a file name is given) is written at exit.
+    /// Must be called before the profiled computations start; the calling thread becomes the main thread.
+    void enable(std::string const & reportFile, std::string const & traceFile = "")
+    {
+        m_reportFile = reportFile;
+        m_traceFile = traceFile;
+        setMainThread();
+        m_start = clock::now();
+        m_enabled = true;
+    }
+
+    /// make the calling thread the main thread whose regions other threads attach to
+    void setMainThread()
+    {
+        m_mainThread = std::this_thread::get_id();
+        m_anchor = nullptr;
+    }
+
+    /// record the scopes of the calling thread under a top-level node with the given name
+    /// instead of attaching them to the current region of the main thread
+    void detachThread(const char * name)
+    {
+        ThreadState & state = thread();
+        if (state.depth == 0)
+            state.current = state.root.child(name);
+        state.base = state.root.child(name);
+        state.detached = true;
+    }
+
+    void enter(const char * name, bool region)
+    {
+        ThreadState & state = thread();
+        const bool main = isMain(state);
+        if (state.depth == 0 && !main)
+            state.current = outerNode(state);
+        state.current = state.current->child(name);
+        ++state.depth;
+        if (region && main)
+            m_anchor = state.current;
+    }
+
+    void leave(bool region, clock::time_point start, double elapsed)
+    {
+        ThreadState & state = thread();
+        const bool main = isMain(state);
+        Node * node = state.current;
+        node->add(elapsed);
+        state.current = node->parent;
+        --state.depth;
+        if (state.depth == 0 && !main)
+            state.current = state.base;
+        if (region)
+        {
+            if (main)
+                m_anchor = state.current;
+            if (!m_traceFile.empty())
+                state.trace.push_back(TraceEvent(node->name,start,elapsed));
+        }
+    }
+
+    /// add to a counter of the innermost scope
+    void count(const char * name, long increment)
+    {
+        ThreadState & state = thread();
+        Node * node = state.depth == 0 && !isMain(state) ? outerNode(state) : state.current;
+        node->counter(name) += increment;
+    }
+
+    /// write the hierarchical report; the call trees of all threads are merged
+    void writeReport() const
+    {
+        Merged root;
+        for (size_t i = 0; i < m_threads.size(); ++i)
+            root.merge(m_threads[i]->root);
+
+        std::ofstream file(m_reportFile.c_str());
+        file << std::setprecision(9);
+        file << "{\n\"version\": 1,\n\"threads\": " << m_threads.size()
+             << ",\n\"wallTime\": " << std::chrono::duration<double>(clock::now() - m_start).count()
+             << ",\n\"scopes\": ";
+        root.writeChildren(file,0);
+        file << "\n}\n";
+    }
+
+    /// write the regions as complete events of the Chrome trace format
+    void writeTrace() const
+    {
+        std::ofstream file(m_traceFile.c_str());
+        file << std::setprecision(12);
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        bool first = true;
+        for (size_t t = 0; t < m_threads.size(); ++t)
+            for (size_t i = 0; i < m_threads[t]->trace.size(); ++i)
+            {
+                const TraceEvent & event = m_threads[t]->trace[i];
+                file << (first ? "\n" : ",\n") << "{\"name\": \"" << escape(event.name)
+                     << "\", \"cat\": \"gsElasticity\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << m_threads[t]->id
+                     << ", \"ts\": " << std::chrono::duration<double,std::micro>(event.start - m_start).count()
+                     << ", \"dur\": " << event.duration*1e6 << "}";
+                first = false;
+            }
+        file << "\n]}\n";
+    }
+
+    ~gsProfiler()
+    {
+        if (m_enabled)
+        {
+            writeReport();
+            if (!m_traceFile.empty())
+                writeTrace();
+        }
+        for (size_t i = 0; i < m_threads.size(); ++i)
+            delete m_threads[i];
+    }
+
+protected:
+    struct TraceEvent
+    {
+        TraceEvent(const char * name_, clock::time_point start_, double duration_)
+            : name(name_), start(start_), duration(duration_) {}
+        const char * name;
+        clock::time_point start;
+        double duration;
+    };
+
+    struct ThreadState
+    {
+        ThreadState(int id_, std::thread::id threadId_)
+            : id(id_), threadId(threadId_), root("root",nullptr), current(&root), base(&root), depth(0), detached(false),
+              anchorMain(nullptr), anchorOwn(nullptr) {}
+        int id;
+        std::thread::id threadId;
+        Node root;
+        Node * current;
+        /// node the scopes of a detached thread are attached to
+        Node * base;
+        int depth;
+        bool detached;
+        /// the last resolved region of the main thread and the corresponding node of this thread
+        Node * anchorMain;
+        Node * anchorOwn;
+        std::vector<TraceEvent> trace;
+    };
+
+    /// node of the merged call tree
+    struct Merged
+    {
+        Merged() : calls(0), time(0.), minTime(0.), maxTime(0.) {}
+
+        void merge(const Node & node)
+        {
+            if (node.calls > 0)
+            {
+                minTime = calls == 0 ? node.minTime : std::min(minTime,node.minTime);
+                maxTime = std::max(maxTime,node.maxTime);
+            }
+            calls += node.calls;
+            time += node.time;
+            for (size_t i = 0; i < node.counters.size(); ++i)
+            {
+                size_t j = 0;
+                while (j < counters.size() && counters[j].first != node.counters[i].first)
+                    ++j;
+                if (j == counters.size())
+                    counters.push_back(std::make_pair(std::string(node.counters[i].first),0L));
+                counters[j].second += node.counters[i].second;
+            }
+            for (size_t i = 0; i < node.children.size(); ++i)
+            {
+                size_t j = 0;
+                while (j < children.size() && children[j].name != node.children[i]->name)
+                    ++j;
+                if (j == children.size())
+                {
+                    children.push_back(Merged());
+                    children.back().name = node.children[i]->name;
+                }
+                children[j].merge(*node.children[i]);
+            }
+        }
+
+        void writeChildren(std::ostream & os, int indent) const
+        {
+            const std::string pad(indent+2,' ');
+            os << "[";
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                const Merged & c = children[i];
+                os << (i == 0 ? "\n" : ",\n") << pad << "{\"name\": \"" << escape(c.name) << "\", \"calls\": " << c.calls
+                   << ", \"time\": " << c.time << ", \"min\": " << c.minTime << ", \"max\": " << c.maxTime;
+                if (!c.counters.empty())
+                {
+                    os << ", \"counters\": {";
+                    for (size_t j = 0; j < c.counters.size(); ++j)
+                        os << (j == 0 ? "" : ", ") << "\"" << escape(c.counters[j].first) << "\": " << c.counters[j].second;
+                    os << "}";
+                }
+                if (!c.children.empty())
+                {
+                    os << ", \"children\": ";
+                    c.writeChildren(os,indent+2);
+                }
+                os << "}";
+            }
+            os << (children.empty() ? "]" : "\n" + std::string(indent,' ') + "]");
+        }
+
+        std::string name;
+        long calls;
+        double time, minTime, maxTime;
+        std::vector<std::pair<std::string,long> > counters;
+        std::vector<Merged> children;
+    };
+
+    gsProfiler()
+        : m_enabled(false), m_anchor(nullptr)
+    {
+        m_mainThread = initialThread();
+        const char * report = std::getenv("ELAST_PROFILE");
+        const char * trace = std::getenv("ELAST_TRACE");
+        if (report != nullptr && report[0] != '\0')
+        {   // the main thread is not necessarily the one which calls instance() first
+            m_reportFile = report;
+            m_traceFile = trace == nullptr ? "" : trace;
+            m_start = clock::now();
+            m_enabled = true;
+        }
+    }
+
+    bool isMain(const ThreadState & state) const { return state.threadId == m_mainThread.load(); }
+
+    ThreadState & thread()
+    {
+        static thread_local ThreadState * state = nullptr;
+        if (state == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_threads.push_back(new ThreadState(m_threads.size(),std::this_thread::get_id()));
+            state = m_threads.back();
+        }
+        return *state;
+    }
+
+    /// node under which a non-main thread opens its outermost scopes
+    Node * outerNode(ThreadState & state)
+    {
+        return state.detached ? state.base : anchor(state);
+    }
+
+    /// node of the given thread that corresponds to the innermost region of the main thread
+    Node * anchor(ThreadState & state)
+    {
+        Node * mainNode = m_anchor.load();
+        if (mainNode == nullptr)
+            return &state.root;
+        if (mainNode != state.anchorMain)
+        {
+            std::vector<const char *> path;
+            for (Node * node = mainNode; node->parent != nullptr; node = node->parent)
+                path.push_back(node->name);
+            Node * own = &state.root;
+            for (size_t i = path.size(); i > 0; --i)
+                own = own->child(path[i-1]);
+            state.anchorMain = mainNode;
+            state.anchorOwn = own;
+        }
+        return state.anchorOwn;
+    }
+
+    static std::string escape(std::string const & name)
+    {
+        std::string result;
+        for (size_t i = 0; i < name.size(); ++i)
+        {
+            if (name[i] == '"' || name[i] == '\\')
+                result += '\\';
+            result += name[i];
+        }
+        return result;
+    }
+
+protected:
+    std::atomic<bool> m_enabled;
+    std::string m_reportFile;
+    std::string m_traceFile;
+    clock::time_point m_start;
+    std::mutex m_mutex;
+    std::vector<ThreadState *> m_threads;
+    std::atomic<std::thread::id> m_mainThread;
+    std::atomic<Node *> m_anchor;
+};
+
+namespace internal
+{
+/// records the id of the thread running the static initialization, i.e. the main thread of the program
+static const std::thread::id elastProfilerInitialThread = gsProfiler::initialThread();
+}
+
+/** @brief Profiles the enclosing scope; usually created by the macros ELAST_PROFILE_REGION and ELAST_PROFILE_SCOPE.
+ *
+ * Regions always measure their duration, so elapsed() can also be used for timing statistics
+ * when the profiler is disabled; fine-grained scopes do nothing unless the profiler is enabled.
+*/
+class gsProfileScope
+{
+public:
+    explicit gsProfileScope(const char * name, bool region = true)
+        : m_region(region), m_active(gsProfiler::enabled())
+    {
+        if (m_active)
+            gsProfiler::instance().enter(name,region);
+        if (m_active || m_region)
+            m_start = gsProfiler::clock::now();
+    }
+
+    ~gsProfileScope()
+    {
+        if (m_active)
+            gsProfiler::instance().leave(m_region,m_start,elapsed());
+    }
+
+    /// seconds since the scope was opened
+    double elapsed() const { return std::chrono::duration<double>(gsProfiler::clock::now() - m_start).count(); }
+
+    /// close the scope before the end of the enclosing block and return its duration in seconds;
+    /// scopes must be closed in the reverse order of opening
+    double stop()
+    {
+        const double time = elapsed();
+        if (m_active)
+            gsProfiler::instance().leave(m_region,m_start,time);
+        m_active = false;
+        return time;
+    }
+
+private:
+    gsProfileScope(const gsProfileScope &);
+    gsProfileScope & operator=(const gsProfileScope &);
+
+    bool m_region;
+    bool m_active;
+    gsProfiler::clock::time_point m_start;
+};
+
+} // namespace ends
+
+#ifndef ELAST_NO_PROFILING
+#define ELAST_PROFILE_CONCAT_(a,b) a##b
+#define ELAST_PROFILE_CONCAT(a,b) ELAST_PROFILE_CONCAT_(a,b)
+/// profile the enclosing scope as a region: assembly, factorization, time step, output etc.
+#define ELAST_PROFILE_REGION(name) gismo::gsProfileScope ELAST_PROFILE_CONCAT(elastProfileScope,__LINE__)(name,true)
+/// profile the enclosing scope as a fine-grained operation, e.g. an element-wise computation
+#define ELAST_PROFILE_SCOPE(name) gismo::gsProfileScope ELAST_PROFILE_CONCAT(elastProfileScope,__LINE__)(name,false)
+/// add to a counter of the innermost profiled scope
+#define ELAST_PROFILE_COUNT(name,increment) \
+    do { if (gismo::gsProfiler::enabled()) gismo::gsProfiler::instance().count(name,increment); } while (false)
+/// record the scopes of a background thread under a separate top-level node;
+/// also takes effect if the profiler is enabled after the thread started
+#define ELAST_PROFILE_DETACH_THREAD(name) gismo::gsProfiler::instance().detachThread(name)
+#else
+#define ELAST_PROFILE_REGION(name) ((void)0)
+#define ELAST_PROFILE_SCOPE(name) ((void)0)
+#define ELAST_PROFILE_COUNT(name,increment) ((void)0)
+#define ELAST_PROFILE_DETACH_THREAD(name) ((void)0)
+#endif
+
+namespace gismo
+{
+
+/// factorize a sparse matrix with an Eigen-like direct solver; the symbolic and the numeric phases are profiled separately
+template <class Solver, class Matrix>
+void gsProfiledFactorize(Solver & solver, const Matrix & matrix)
+{
+    {
+        ELAST_PROFILE_REGION("analyzePattern");
+        solver.analyzePattern(matrix);
+    }
+    {
+        ELAST_PROFILE_REGION("factorize");
+        solver.factorize(matrix);
+    }
+}
+
+/// solve a system with a factorized direct solver; the solution is evaluated inside the profiled scope
+template <class Solver, class Rhs>
+typename Rhs::PlainObject gsProfiledSolve(const Solver & solver, const Rhs & rhs)
+{
+    ELAST_PROFILE_REGION("solve");
+    return solver.solve(rhs);
+}
+
+} // namespace ends
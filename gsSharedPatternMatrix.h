@@ -0,0 +1,89 @@
+/** @file gsSharedPatternMatrix.h
+
+    @brief Linear combination of two sparse matrices on a precomputed union sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/** @brief Computes effective matrices of time integration schemes, e.g. a*K + b*M,
+ * where K is a system matrix and M is a mass matrix of the same size or of a smaller size.
+ * In the latter case, M corresponds to the upper left block of K (e.g. the velocity block
+ * of the Navier-Stokes system), and the entries of K in this block can be scaled differently.
+ *
+ * The union pattern of K and M and the positions of their entries in it are computed once.
+ * Afterwards, the combination is a single pass over the value arrays of K and M
+ * without any allocation as long as the sparsity patterns of K and M do not change.
+ * All matrices are expected to be in the compressed mode.
+*/
+template <class T>
+class gsSharedPatternMatrix
+{
+public:
+    gsSharedPatternMatrix() : m_blockRows(0), m_blockCols(0) {}
+
+    /// compute the union pattern of K and M and the positions of their entries in it
+    void initialize(const gsSparseMatrix<T> & K, const gsSparseMatrix<T> & M);
+
+    /// checks whether K and M have the same size and sparsity pattern as during the initialization
+    bool compatible(const gsSparseMatrix<T> & K, const gsSparseMatrix<T> & M) const
+    {
+        return m_pattern.rows() == K.rows() && m_pattern.cols() == K.cols() &&
+               m_blockRows == M.rows() && m_blockCols == M.cols() &&
+               samePattern(K,m_outerK,m_innerK) && samePattern(M,m_outerM,m_innerM);
+    }
+
+    /// result = a*K + b*M where the entries of K in the block of M are scaled by aBlock instead of a;
+    /// the pattern is recomputed only if K or M changed their pattern;
+    /// the result is reallocated only if it does not have the union pattern yet
+    void combine(T a, T aBlock, const gsSparseMatrix<T> & K, T b, const gsSparseMatrix<T> & M,
+                 gsSparseMatrix<T> & result);
+
+    /// result = a*K + b*M
+    void combine(T a, const gsSparseMatrix<T> & K, T b, const gsSparseMatrix<T> & M,
+                 gsSparseMatrix<T> & result) { combine(a,a,K,b,M,result); }
+
+    /// union sparsity pattern (with zero values)
+    const gsSparseMatrix<T> & pattern() const { return m_pattern; }
+
+protected:
+    /// compares the index arrays of a compressed matrix with the stored ones
+    static bool samePattern(const gsSparseMatrix<T> & A, const std::vector<index_t> & outer,
+                            const std::vector<index_t> & inner)
+    {
+        return A.isCompressed() &&
+               static_cast<size_t>(A.outerSize()+1) == outer.size() &&
+               static_cast<size_t>(A.nonZeros()) == inner.size() &&
+               std::equal(outer.begin(),outer.end(),A.outerIndexPtr()) &&
+               std::equal(inner.begin(),inner.end(),A.innerIndexPtr());
+    }
+
+    /// union pattern
+    gsSparseMatrix<T> m_pattern;
+    /// positions of the entries of K and M in the value array of the union pattern
+    std::vector<index_t> m_mapK;
+    std::vector<index_t> m_mapM;
+    /// size of M and index arrays of K and M used for the initialization
+    index_t m_blockRows, m_blockCols;
+    std::vector<index_t> m_outerK, m_innerK;
+    std::vector<index_t> m_outerM, m_innerM;
+};
+
+} // namespace gismo ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSharedPatternMatrix.hpp)
+#endif
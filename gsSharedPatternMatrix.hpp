@@ -0,0 +1,114 @@
+/** @file gsSharedPatternMatrix.hpp
+
+    @brief Linear combination of two sparse matrices on a precomputed union sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsSharedPatternMatrix.h>
+
+namespace gismo
+{
+
+template <class T>
+void gsSharedPatternMatrix<T>::initialize(const gsSparseMatrix<T> & K, const gsSparseMatrix<T> & M)
+{
+    GISMO_ENSURE(K.isCompressed() && M.isCompressed(),"Matrices must be compressed");
+    GISMO_ENSURE(M.rows() <= K.rows() && M.cols() <= K.cols(),
+                 "The second matrix must fit into the upper left block of the first one");
+    m_blockRows = M.rows();
+    m_blockCols = M.cols();
+    const index_t nnzK = K.nonZeros();
+    const index_t nnzM = M.nonZeros();
+    m_mapK.resize(nnzK);
+    m_mapM.resize(nnzM);
+
+    const index_t * outerK = K.outerIndexPtr();
+    const index_t * innerK = K.innerIndexPtr();
+    const index_t * outerM = M.outerIndexPtr();
+    const index_t * innerM = M.innerIndexPtr();
+    m_outerK.assign(outerK,outerK+K.outerSize()+1);
+    m_innerK.assign(innerK,innerK+nnzK);
+    m_outerM.assign(outerM,outerM+M.outerSize()+1);
+    m_innerM.assign(innerM,innerM+nnzM);
+
+    // merge sorted inner indices of K and M outer vector by outer vector
+    std::vector<index_t> outer(K.outerSize()+1,0);
+    std::vector<index_t> inner;
+    inner.reserve(nnzK + nnzM);
+    index_t nnz = 0;
+    for (index_t j = 0; j < K.outerSize(); ++j)
+    {
+        index_t p = outerK[j];
+        index_t q = j < M.outerSize() ? outerM[j] : 0;
+        const index_t endP = outerK[j+1];
+        const index_t endQ = j < M.outerSize() ? outerM[j+1] : 0;
+        while (p < endP || q < endQ)
+        {
+            if (q == endQ || (p < endP && innerK[p] < innerM[q]))
+            {
+                m_mapK[p] = nnz++;
+                inner.push_back(innerK[p++]);
+            }
+            else if (p == endP || innerM[q] < innerK[p])
+            {
+                m_mapM[q] = nnz++;
+                inner.push_back(innerM[q++]);
+            }
+            else
+            {
+                m_mapK[p++] = nnz;
+                m_mapM[q] = nnz++;
+                inner.push_back(innerM[q++]);
+            }
+        }
+        outer[j+1] = nnz;
+    }
+
+    m_pattern.resize(K.rows(),K.cols());
+    m_pattern.resizeNonZeros(nnz);
+    std::copy(outer.begin(),outer.end(),m_pattern.outerIndexPtr());
+    std::copy(inner.begin(),inner.end(),m_pattern.innerIndexPtr());
+    std::fill(m_pattern.valuePtr(),m_pattern.valuePtr()+nnz,T(0.));
+}
+
+template <class T>
+void gsSharedPatternMatrix<T>::combine(T a, T aBlock, const gsSparseMatrix<T> & K,
+                                       T b, const gsSparseMatrix<T> & M, gsSparseMatrix<T> & result)
+{
+    const bool changed = !compatible(K,M);
+    if (changed)
+        initialize(K,M);
+    // copy the pattern only if the result does not have it yet
+    if (changed || result.rows() != m_pattern.rows() || result.cols() != m_pattern.cols() ||
+        result.nonZeros() != m_pattern.nonZeros() || !result.isCompressed())
+        result = m_pattern;
+
+    T * values = result.valuePtr();
+    std::fill(values,values+result.nonZeros(),T(0.));
+
+    const index_t * outerK = K.outerIndexPtr();
+    const index_t * innerK = K.innerIndexPtr();
+    const T * valuesK = K.valuePtr();
+    // the block of M lies in the first blockOuter outer vectors and has blockInner inner indices
+    const index_t blockOuter = M.outerSize();
+    const index_t blockInner = M.innerSize();
+    for (index_t j = 0; j < K.outerSize(); ++j)
+        for (index_t p = outerK[j]; p < outerK[j+1]; ++p)
+            values[m_mapK[p]] += (j < blockOuter && innerK[p] < blockInner ? aBlock : a) * valuesK[p];
+
+    const T * valuesM = M.valuePtr();
+    for (index_t q = 0; q < M.nonZeros(); ++q)
+        values[m_mapM[q]] += b*valuesM[q];
+}
+
+} // namespace gismo ends
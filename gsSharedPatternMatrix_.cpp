@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsSharedPatternMatrix.h>
+#include <gsElasticity/gsSharedPatternMatrix.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsSharedPatternMatrix<real_t>;
+}
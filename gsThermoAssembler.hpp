@@ -74,7 +74,7 @@ void gsThermoAssembler<T>::assembleThermo()
     gsAssembler<T>::m_system.rhs().setZero();
 
     gsVisitorThermo<T> visitor(m_temperatureField);
-    gsAssembler<T>::template push<gsVisitorThermo<T> >(visitor);
+    gsBaseAssembler<T>::template push<gsVisitorThermo<T> >(visitor);
 
     for (auto const & it : nonDirichletSides)
     {
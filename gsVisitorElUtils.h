@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+
 namespace gismo
 {
 
@@ -103,4 +105,56 @@ inline void setB( gsMatrix<T> & B, const gsMatrix<T> & F, const gsVector<T> & bG
     }
 }
 
+// shared record of the bijectivity check performed during assembly of nonlinear systems;
+// element visitors store here the first quadrature point with a non-positive deformation Jacobian,
+// the flag is shared across threads so that other visitors can skip the remaining elements
+template <class T>
+struct gsJacobianCheck
+{
+    gsJacobianCheck() { reset(); }
+
+    // std::atomic is not copyable; copies take a snapshot of the flag
+    gsJacobianCheck(const gsJacobianCheck & other)
+        : invalid(other.invalid.load()), patch(other.patch), point(other.point), det(other.det) {}
+
+    gsJacobianCheck & operator=(const gsJacobianCheck & other)
+    {
+        invalid.store(other.invalid.load());
+        patch = other.patch;
+        point = other.point;
+        det = other.det;
+        return *this;
+    }
+
+    void reset()
+    {
+        invalid.store(false);
+        patch = -1;
+        det = 0.;
+        point.resize(0);
+    }
+
+    // record an invalid point; returns false if another point was recorded before
+    bool record(index_t patch_, const gsMatrix<T> & point_, T det_)
+    {
+        bool first = false;
+#pragma omp critical (gsJacobianCheck_record)
+        if (!invalid.load())
+        {
+            patch = patch_;
+            point = point_;
+            det = det_;
+            // set last: visitors in other threads read the flag without entering the critical section
+            invalid.store(true);
+            first = true;
+        }
+        return first;
+    }
+
+    std::atomic<bool> invalid; // true if a point with a non-positive Jacobian was found
+    index_t patch; // patch of the invalid point
+    gsVector<T> point; // invalid point in the parametric domain of the patch
+    T det; // deformation Jacobian at the invalid point
+};
+
 } // namespace gismo
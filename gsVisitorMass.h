@@ -17,6 +17,7 @@
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
 {
@@ -40,6 +41,7 @@ public:
         rule = gsQuadrature::get(basisRefs.front(), options);
         // saving necessary info
         density = options.getReal("Density");
+        lumping = options.getInt("Lumping");
         // resize containers for global indices
         globalIndices.resize(dim);
         blockNumbers.resize(dim);
@@ -69,6 +71,15 @@ public:
         // initialize local matrix and rhs
         localMat.setZero(dim*N_D,dim*N_D);
         block = density*basisValuesDisp * quWeights.asDiagonal() * md.measures.asDiagonal() * basisValuesDisp.transpose();
+        // lumped mass matrix: the element matrix is replaced by a diagonal one
+        if (lumping == mass_lumping::row_sum)
+            block = gsMatrix<T>(block.rowwise().sum()).asDiagonal();
+        if (lumping == mass_lumping::hrz)
+        {
+            T elementMass = density*(md.measures.transpose().array()*quWeights.array()).sum();
+            diagonal = block.diagonal();
+            block = (elementMass/diagonal.sum()*diagonal).asDiagonal();
+        }
         for (short_t d = 0; d < dim; ++d)
             localMat.block(d*N_D,d*N_D,N_D,N_D) = block.block(0,0,N_D,N_D);
     }
@@ -115,6 +126,8 @@ protected:
     short_t dim;
     //density
     T density;
+    // type of the mass matrix: consistent or lumped
+    index_t lumping;
     // geometry mapping
     gsMapData<T> md;
     // local components of the global linear system
@@ -131,6 +144,7 @@ protected:
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> block;
+    gsMatrix<T> diagonal;
     // containers for global indices
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<size_t> blockNumbers;
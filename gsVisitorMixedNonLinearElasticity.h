@@ -28,10 +28,14 @@ class gsVisitorMixedNonLinearElasticity
 {
 public:
     gsVisitorMixedNonLinearElasticity(const gsPde<T> & pde_, const gsMultiPatch<T> & displacement_,
-                                      const gsMultiPatch<T> & pressure_)
+                                      const gsMultiPatch<T> & pressure_,
+                                      gsJacobianCheck<T> * jacCheck_ = nullptr,
+                                      bool assembleMatrix_ = true)
         : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde_)),
           displacement(displacement_),
-          pressure(pressure_){}
+          pressure(pressure_),
+          jacCheck(jacCheck_),
+          assembleMatrix(assembleMatrix_) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -61,6 +65,14 @@ public:
                          const gsGeometry<T> & geo,
                          const gsMatrix<T> & quNodes)
     {
+        // find local indices of the displacement and pressure basis functions active on the element
+        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+        N_D = localIndicesDisp.rows();
+        basisRefs.back().active_into(quNodes.col(0), localIndicesPres);
+        N_P = localIndicesPres.rows();
+        // skip evaluation if an invalid point has already been found (possibly by another thread)
+        if (jacCheck && jacCheck->invalid.load())
+            return;
         // store quadrature points of the element for geometry evaluation
         md.points = quNodes;
         // NEED_VALUE to get points in the physical domain for evaluation of the RHS
@@ -69,11 +81,6 @@ public:
         md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
         // Compute image of the quadrature points plus gradient, jacobian and other necessary data
         geo.computeMap(md);
-        // find local indices of the displacement and pressure basis functions active on the element
-        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
-        N_D = localIndicesDisp.rows();
-        basisRefs.back().active_into(quNodes.col(0), localIndicesPres);
-        N_P = localIndicesPres.rows();
         // Evaluate displacement basis functions and their derivatives on the element
         basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
         // Evaluate pressure basis functions on the element
@@ -95,8 +102,11 @@ public:
                          const gsVector<T> & quWeights)
     {
         // Initialize local matrix/rhs                      // A | B^T
-        localMat.setZero(dim*N_D + N_P, dim*N_D + N_P);     // --|--    matrix structure
+        if (assembleMatrix)
+            localMat.setZero(dim*N_D + N_P, dim*N_D + N_P); // --|--    matrix structure
         localRhs.setZero(dim*N_D + N_P,1);                  // B | C
+        if (jacCheck && jacCheck->invalid.load())
+            return;
         // Loop over the quadrature nodes
         for (index_t q = 0; q < quWeights.rows(); ++q)
         {
@@ -110,6 +120,12 @@ public:
             F = I + physDispJac;
             // deformation jacobian J = det(F)
             T J = F.determinant();
+            // bijectivity check; the whole assembly is abandoned as soon as an invalid point is found
+            if (jacCheck && J <= 0)
+            {
+                jacCheck->record(patch,md.points.col(q),J);
+                return;
+            }
             // Right Cauchy Green strain, C = F'*F
             RCG = F.transpose() * F;
             // logarithmic neo-Hooke
@@ -120,8 +136,11 @@ public:
                 // Second Piola-Kirchhoff stress tensor
                 S = (pressureValues.at(q)-mu)*RCGinv + mu*I;
                 // elasticity tensor
-                symmetricIdentityTensor<T>(C,RCGinv);
-                C *= mu-pressureValues.at(q);
+                if (assembleMatrix)
+                {
+                    symmetricIdentityTensor<T>(C,RCGinv);
+                    C *= mu-pressureValues.at(q);
+                }
             }
             /*if (materialLaw == 4) // mixed Kelvin-Voigt
             {
@@ -139,22 +158,25 @@ public:
             for (index_t i = 0; i < N_D; i++)
             {
                 setB<T>(B_i,F,physGradDisp.col(i));
-                materialTangentTemp = B_i.transpose() * C;
-                // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
-                geometricTangentTemp = S * physGradDisp.col(i);
-                // A-matrix
-                for (index_t j = 0; j < N_D; j++)
+                // A-matrix; skipped for residual-only assembly
+                if (assembleMatrix)
                 {
-                    setB<T>(B_j,F,physGradDisp.col(j));
-                    materialTangent = materialTangentTemp * B_j;
-                    T geometricTangent =  geometricTangentTemp.transpose() * physGradDisp.col(j);
-                    // K_tg = K_tg_mat + I*K_tg_geo;
-                    for (short_t d = 0; d < dim; ++d)
-                        materialTangent(d,d) += geometricTangent;
-
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i, dj*N_D+j) += weight * materialTangent(di,dj);
+                    materialTangentTemp = B_i.transpose() * C;
+                    // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
+                    geometricTangentTemp = S * physGradDisp.col(i);
+                    for (index_t j = 0; j < N_D; j++)
+                    {
+                        setB<T>(B_j,F,physGradDisp.col(j));
+                        materialTangent = materialTangentTemp * B_j;
+                        T geometricTangent =  geometricTangentTemp.transpose() * physGradDisp.col(j);
+                        // K_tg = K_tg_mat + I*K_tg_geo;
+                        for (short_t d = 0; d < dim; ++d)
+                            materialTangent(d,d) += geometricTangent;
+
+                        for (short_t di = 0; di < dim; ++di)
+                            for (short_t dj = 0; dj < dim; ++dj)
+                                localMat(di*N_D+i, dj*N_D+j) += weight * materialTangent(di,dj);
+                    }
                 }
 
                 // Second Piola-Kirchhoff stress tensor as vector
@@ -164,18 +186,21 @@ public:
                 for (short_t d = 0; d < dim; d++)
                     localRhs(d*N_D+i) -= weight * localResidual(d);
             }
-            // B-matrix
-            divV = F.cramerInverse().transpose() * physGradDisp;
-            for (short_t d = 0; d < dim; ++d)
+            if (assembleMatrix)
             {
-                block = weight*basisValuesPres.col(q)*divV.row(d);
-                localMat.block(dim*N_D,d*N_D,N_P,N_D) += block.block(0,0,N_P,N_D);
-                localMat.block(d*N_D,dim*N_D,N_D,N_P) += block.transpose().block(0,0,N_D,N_P);
+                // B-matrix
+                divV = F.cramerInverse().transpose() * physGradDisp;
+                for (short_t d = 0; d < dim; ++d)
+                {
+                    block = weight*basisValuesPres.col(q)*divV.row(d);
+                    localMat.block(dim*N_D,d*N_D,N_P,N_D) += block.block(0,0,N_P,N_D);
+                    localMat.block(d*N_D,dim*N_D,N_D,N_P) += block.transpose().block(0,0,N_D,N_P);
+                }
+                // C-matrix
+                if (abs(lambda_inv) > 0)
+                    localMat.block(dim*N_D,dim*N_D,N_P,N_P) -=
+                            (weight*lambda_inv*basisValuesPres.col(q)*basisValuesPres.col(q).transpose()).block(0,0,N_P,N_P);
             }
-            // C-matrix
-            if (abs(lambda_inv) > 0)
-                localMat.block(dim*N_D,dim*N_D,N_P,N_P) -=
-                        (weight*lambda_inv*basisValuesPres.col(q)*basisValuesPres.col(q).transpose()).block(0,0,N_P,N_P);
             // rhs: constraint residual
             localRhs.middleRows(dim*N_D,N_P) += weight*basisValuesPres.col(q)*(lambda_inv*pressureValues.at(q)-log(J));
             // rhs: force
@@ -199,7 +224,8 @@ public:
         blockNumbers.at(dim) = dim;
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
     }
 
 protected:
@@ -236,6 +262,10 @@ protected:
     const gsMultiPatch<T> & pressure;
     // evaluation data of the current pressure field stored as a 1 x numQuadPoints matrix
     gsMatrix<T> pressureValues;
+    // shared record of the bijectivity check; no check if nullptr
+    gsJacobianCheck<T> * jacCheck;
+    // assemble the tangent matrix or only the residual
+    bool assembleMatrix;
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> C, Ctemp, physGradDisp, physDispJac, F, RCG, E, S, RCGinv, B_i, materialTangentTemp, B_j, materialTangent, divV, block, I;
@@ -27,10 +27,11 @@ class gsVisitorNavierStokes
 public:
 
     gsVisitorNavierStokes(const gsPde<T> & pde_, const gsMultiPatch<T> & velocity_,
-                          const gsMultiPatch<T> & pressure_)
+                          const gsMultiPatch<T> & pressure_, bool assembleMatrix_ = true)
         : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde_)),
           velocity(velocity_),
-          pressure(pressure_) {}
+          pressure(pressure_),
+          assembleMatrix(assembleMatrix_) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -94,7 +95,10 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
-        if (assemblyType == 0)
+        // the residual of the nonlinear system does not depend on the linearization type
+        if (!assembleMatrix)
+            assembleResidual(element,quWeights);
+        else if (assemblyType == 0)
             assembleOseen(element,quWeights);
         else if (assemblyType == 1)
             assembleNewtonUpdate(element,quWeights);
@@ -117,11 +121,56 @@ public:
         blockNumbers.at(dim) = dim;
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
     }
 
 protected:
 
+    // adds the contribution of the quadrature point q to the negative residual (-r);
+    // requires physGradVel and physJacCurVel at q
+    void addResidual(index_t q, T weight)
+    {
+        // rhs: force
+        for (short_t d = 0; d < dim; ++d)
+            localRhs.middleRows(d*N_V,N_V).noalias() += weight *density* forceScaling *
+                forceValues(d,q) * basisValuesVel[0].col(q);
+        // rhs: residual diffusion
+        for (short_t d = 0; d < dim; ++d)
+            localRhs.middleRows(d*N_V,N_V).noalias() -= weight * viscosity * density*
+                (physJacCurVel.row(d)*physGradVel).transpose();
+        // rhs: residual nonlinear
+        for (short_t d = 0; d < dim; ++d)
+            localRhs.middleRows(d*N_V,N_V).noalias() -= weight * density*
+                (physJacCurVel.row(d) * mdVelocity.values[0].col(q))(0,0) * basisValuesVel[0].col(q);
+        // rhs: residual pressure
+        for (short_t d = 0; d < dim; ++d)
+            localRhs.middleRows(d*N_V,N_V).noalias() += weight *
+                pressureValues.at(q) * physGradVel.row(d).transpose();
+        // rhs: constraint residual
+        localRhs.middleRows(dim*N_V,N_P).noalias() += weight *
+            basisValuesPres.col(q) * physJacCurVel.trace();
+    }
+
+    // same rhs as in assembleNewtonUpdate, i.e. a negative residual (-r), without the matrix
+    void assembleResidual(gsDomainIterator<T> & element,
+                          const gsVector<T> & quWeights)
+    {
+        localRhs.setZero(dim*N_V + N_P,1);
+        // Loop over the quadrature nodes
+        for (index_t q = 0; q < quWeights.rows(); ++q)
+        {
+            // Multiply quadrature weight by the geometry measure
+            const T weight = quWeights[q] * md.measure(q);
+            // Compute physical gradients of the velocity basis functions at q as a dim x numActiveFunction matrix
+            transformGradients(md, q, basisValuesVel[1], physGradVel);
+            // Compute physical Jacobian of the current velocity field
+            physJacCurVel = mdVelocity.jacobian(q)*(md.jacobian(q).cramerInverse());
+            // rhs: negative residual
+            addResidual(q,weight);
+        }
+    }
+
     void assembleNewtonUpdate(gsDomainIterator<T> & element,
                               const gsVector<T> & quWeights)
     {
@@ -158,25 +207,8 @@ protected:
                 localMat.block(dim*N_V,d*N_V,N_P,N_V) -= block.block(0,0,N_P,N_V); // B
                 localMat.block(d*N_V,dim*N_V,N_V,N_P) -= block.transpose().block(0,0,N_V,N_P); // D
             }
-            // rhs: force
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_V,N_V).noalias() += weight *density* forceScaling *
-                    forceValues(d,q) * basisValuesVel[0].col(q);
-            // rhs: residual diffusion
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_V,N_V).noalias() -= weight * viscosity * density*
-                    (physJacCurVel.row(d)*physGradVel).transpose();
-            // rhs: residual nonlinear
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_V,N_V).noalias() -= weight * density*
-                    (physJacCurVel.row(d) * mdVelocity.values[0].col(q))(0,0) * basisValuesVel[0].col(q);
-            // rhs: residual pressure
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_V,N_V).noalias() += weight *
-                    pressureValues.at(q) * physGradVel.row(d).transpose();
-            // rhs: constraint residual
-            localRhs.middleRows(dim*N_V,N_P).noalias() += weight *
-                basisValuesPres.col(q) * physJacCurVel.trace();
+            // rhs: negative residual
+            addResidual(q,weight);
         }
     }
 
@@ -306,6 +338,8 @@ protected:
     gsMatrix<T> pressureValues;
     // pressure gradients at the current element (only for supg); stored as a dim x numQuadPoints matrix
     gsMatrix<T> pressureGrads;
+    // assemble the linear system or only the residual
+    bool assembleMatrix;
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> block, physGradVel, physJacCurVel;
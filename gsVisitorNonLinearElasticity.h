@@ -27,9 +27,13 @@ template <class T>
 class gsVisitorNonLinearElasticity
 {
 public:
-    gsVisitorNonLinearElasticity(const gsPde<T> & pde_, const gsMultiPatch<T> & displacement_)
+    gsVisitorNonLinearElasticity(const gsPde<T> & pde_, const gsMultiPatch<T> & displacement_,
+                                 gsJacobianCheck<T> * jacCheck_ = nullptr,
+                                 bool assembleMatrix_ = true)
         : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde_)),
-          displacement(displacement_) { }
+          displacement(displacement_),
+          jacCheck(jacCheck_),
+          assembleMatrix(assembleMatrix_) { }
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -67,6 +71,12 @@ public:
                          const gsGeometry<T> & geo,
                          const gsMatrix<T> & quNodes)
     {
+        // find local indices of the displacement basis functions active on the element
+        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+        N_D = localIndicesDisp.rows();
+        // skip evaluation if an invalid point has already been found (possibly by another thread)
+        if (jacCheck && jacCheck->invalid.load())
+            return;
         // store quadrature points of the element for geometry evaluation
         md.points = quNodes;
         // NEED_VALUE to get points in the physical domain for evaluation of the RHS
@@ -75,9 +85,6 @@ public:
         md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
         // Compute image of the quadrature points plus gradient, jacobian and other necessary data
         geo.computeMap(md);
-        // find local indices of the displacement basis functions active on the element
-        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
-        N_D = localIndicesDisp.rows();
         // Evaluate displacement basis functions and their derivatives on the element
         basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
         // Evaluate right-hand side at the image of the quadrature points
@@ -94,8 +101,11 @@ public:
                          const gsVector<T> & quWeights)
     {
         // initialize local matrix and rhs
-        localMat.setZero(dim*N_D,dim*N_D);
+        if (assembleMatrix)
+            localMat.setZero(dim*N_D,dim*N_D);
         localRhs.setZero(dim*N_D,1);
+        if (jacCheck && jacCheck->invalid.load())
+            return;
         // loop over quadrature nodes
         for (index_t q = 0; q < quWeights.rows(); ++q)
         {
@@ -108,6 +118,12 @@ public:
             F = I + physDispJac;
             // deformation jacobian J = det(F)
             T J = F.determinant();
+            // bijectivity check; the whole assembly is abandoned as soon as an invalid point is found
+            if (jacCheck && J <= 0)
+            {
+                jacCheck->record(patch,md.points.col(q),J);
+                return;
+            }
             // Right Cauchy Green strain, C = F'*F
             RCG = F.transpose() * F;
             // Green-Lagrange strain, E = 0.5*(C-I), a.k.a. full geometric strain tensor
@@ -122,43 +138,53 @@ public:
                 RCGinv = RCG.cramerInverse();
                 S = (lambda*log(J)-mu)*RCGinv + mu*I;
                 // elasticity tensor
-                matrixTraceTensor<T>(C,RCGinv,RCGinv);
-                C *= lambda;
-                symmetricIdentityTensor<T>(Ctemp,RCGinv);
-                C += (mu-lambda*log(J))*Ctemp;
+                if (assembleMatrix)
+                {
+                    matrixTraceTensor<T>(C,RCGinv,RCGinv);
+                    C *= lambda;
+                    symmetricIdentityTensor<T>(Ctemp,RCGinv);
+                    C += (mu-lambda*log(J))*Ctemp;
+                }
             }
             if (materialLaw == 2) // quad neo-Hooke
             {
                 RCGinv = RCG.cramerInverse();
                 S = (lambda*(J*J-1)/2-mu)*RCGinv + mu*I;
                 // elasticity tensor
-                matrixTraceTensor<T>(C,RCGinv,RCGinv);
-                C *= lambda*J*J;
-                symmetricIdentityTensor<T>(Ctemp,RCGinv);
-                C += (mu-lambda*(J*J-1)/2)*Ctemp;
+                if (assembleMatrix)
+                {
+                    matrixTraceTensor<T>(C,RCGinv,RCGinv);
+                    C *= lambda*J*J;
+                    symmetricIdentityTensor<T>(Ctemp,RCGinv);
+                    C += (mu-lambda*(J*J-1)/2)*Ctemp;
+                }
             }
             // loop over active basis functions (u_i)
             for (index_t i = 0; i < N_D; i++)
             {
-                // Material tangent K_tg_mat = B_i^T * C * B_j;
                 setB<T>(B_i,F,physGrad.col(i));
-                materialTangentTemp = B_i.transpose() * C;
-                // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
-                geometricTangentTemp = S * physGrad.col(i);
-                // loop over active basis functions (v_j)
-                for (index_t j = 0; j < N_D; j++)
+                // the tangent is skipped for residual-only assembly
+                if (assembleMatrix)
                 {
-                    setB<T>(B_j,F,physGrad.col(j));
+                    // Material tangent K_tg_mat = B_i^T * C * B_j;
+                    materialTangentTemp = B_i.transpose() * C;
+                    // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
+                    geometricTangentTemp = S * physGrad.col(i);
+                    // loop over active basis functions (v_j)
+                    for (index_t j = 0; j < N_D; j++)
+                    {
+                        setB<T>(B_j,F,physGrad.col(j));
 
-                    materialTangent = materialTangentTemp * B_j;
-                    T geometricTangent =  geometricTangentTemp.transpose() * physGrad.col(j);
-                    // K_tg = K_tg_mat + I*K_tg_geo;
-                    for (short_t d = 0; d < dim; ++d)
-                        materialTangent(d,d) += geometricTangent;
+                        materialTangent = materialTangentTemp * B_j;
+                        T geometricTangent =  geometricTangentTemp.transpose() * physGrad.col(j);
+                        // K_tg = K_tg_mat + I*K_tg_geo;
+                        for (short_t d = 0; d < dim; ++d)
+                            materialTangent(d,d) += geometricTangent;
 
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i, dj*N_D+j) += weightBody * materialTangent(di,dj);
+                        for (short_t di = 0; di < dim; ++di)
+                            for (short_t dj = 0; dj < dim; ++dj)
+                                localMat(di*N_D+i, dj*N_D+j) += weightBody * materialTangent(di,dj);
+                    }
                 }
                 // Second Piola-Kirchhoff stress tensor as vector
                 voigtStress<T>(Svec,S);
@@ -185,7 +211,8 @@ public:
         }
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
     }
 
 protected:
@@ -214,6 +241,10 @@ protected:
     const gsMultiPatch<T> & displacement;
     // evaluation data of the current displacement field
     gsMapData<T> mdDisplacement;
+    // shared record of the bijectivity check; no check if nullptr
+    gsJacobianCheck<T> * jacCheck;
+    // assemble the tangent matrix or only the residual
+    bool assembleMatrix;
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> C, Ctemp, physGrad, physDispJac, F, RCG, E, S, RCGinv, B_i, materialTangentTemp, B_j, materialTangent, I;
@@ -17,6 +17,7 @@
 
 #include <gsCore/gsForwardDeclarations.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 #define NS 1000
 
@@ -28,19 +29,24 @@ namespace gismo
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
+/// \param format encoding of the data: ascii, base64 or appended raw binary, optionally compressed
+/// \param numThreads number of threads writing patches concurrently (with OpenMP); 0 - all available
 template<class T>
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false);
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     vtk_format::format format = vtk_format::ascii, index_t numThreads = 0);
 
 /// \brief Write a file containing several fields defined on the same geometry to ONE paraview file
 /// and adds it as a timestep to a Paraview collection
 /// \param fields a map of field pointers
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
-/// \param mesh if true, the parameter mesh is plotted as well
+/// \param format encoding of the data: ascii, base64 or appended raw binary, optionally compressed
+/// \param numThreads number of threads writing patches concurrently (with OpenMP); 0 - all available
 template<class T>
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts=NS);
+                                         gsParaviewCollection & collection, int time, unsigned npts=NS,
+                                         vtk_format::format format = vtk_format::ascii, index_t numThreads = 0);
 
 
 /// \brief Extract and evaluate geometry and the fields for a single patch
@@ -53,7 +59,28 @@ template<class T>
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string, const gsField<T> *> fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts);
+                                unsigned npts,
+                                vtk_format::format format = vtk_format::ascii);
+
+
+/// \brief Sample the geometry and the fields on a uniform grid of a single patch;
+/// the results are padded to 3 rows as required by Paraview
+///
+/// \param geometry a patch used to sample points; must be the patch patchNum of the fields' geometry
+/// \param fields a map of field pointers
+/// \param patchNum a number of patch
+/// \param npts number of points used for sampling the patch
+/// \param points sampled physical points
+/// \param data sampled fields
+/// \param np number of points in each direction; empty if the patch cannot be plotted
+template<class T>
+void gsSampleMultiPhysicsSinglePatch(const gsGeometry<T> & geometry,
+                                     std::map<std::string,const gsField<T> *> fields,
+                                     const unsigned patchNum,
+                                     unsigned npts,
+                                     gsMatrix<T> & points,
+                                     std::map<std::string, gsMatrix<T> > & data,
+                                     gsVector<index_t> & np);
 
 
 /// \brief Utility function to actually write prepaired matrices with data into Paraview file
@@ -62,11 +89,22 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string, const gsField<
 /// \param data a map of matrices with field evaluations to plotfilename where paraview file is written
 /// \param np a vector containg the data range info
 /// \param fn filename where paraview file is written
+/// \param format encoding of the data: ascii, base64 or appended raw binary, optionally compressed
 template<class T>
 void gsWriteParaviewMultiTPgrid(gsMatrix<T> const& points,
                                 std::map<std::string, gsMatrix<T> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn);
+                                std::string const & fn,
+                                vtk_format::format format = vtk_format::ascii);
+
+/// \brief Write a mesh to a .vtp file; uses gsWriteParaview for the ascii format
+///
+/// \param mesh a mesh, e.g. an isoparametric mesh or a control net
+/// \param fn filename where paraview file is written
+/// \param format encoding of the data: ascii, base64 or appended raw binary, optionally compressed
+template<class T>
+void gsWriteParaviewMesh(gsMesh<T> const & mesh, std::string const & fn,
+                         vtk_format::format format = vtk_format::ascii);
 
 }
 
@@ -13,13 +13,24 @@
 */
 
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsElasticity/gsElasticityConfig.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsUtils/gsMesh/gsMesh.h>
 #include <gsCore/gsFunction.h>
 #include <gsCore/gsField.h>
 #include <gsIO/gsWriteParaview.h>
 #include <gsElasticity/gsGeoUtils.h>
+#include <gsElasticity/gsGridEvaluator.h>
+#include <gsElasticity/gsElasticityFunctions.h>
+#include <gsElasticity/gsProfiler.h>
 
+#ifdef ELAST_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define PLOT_PRECISION 11
 
@@ -27,12 +38,175 @@
 namespace gismo
 {
 
+namespace internal
+{
+
+/// @brief Writes data arrays of VTK XML files as ascii text, inline base64 or appended raw binary data;
+/// binary data can be compressed with zlib using the block layout of vtkZLibDataCompressor.
+/// Binary data is stored as UInt32-headed blocks in the native byte order.
+class gsVtkArrayWriter
+{
+public:
+    explicit gsVtkArrayWriter(vtk_format::format format)
+        : m_format(format)
+    {
+#ifndef ELAST_WITH_ZLIB
+        if (compressed())
+        {
+            gsWarn << "gsElasticity is compiled without zlib. Writing uncompressed binary data.\n";
+            m_format = m_format == vtk_format::base64_zlib ? vtk_format::base64 : vtk_format::raw;
+        }
+#endif
+    }
+
+    bool binary() const { return m_format != vtk_format::ascii; }
+    bool appended() const { return m_format == vtk_format::raw || m_format == vtk_format::raw_zlib; }
+    bool compressed() const { return m_format == vtk_format::base64_zlib || m_format == vtk_format::raw_zlib; }
+
+    /// opening tag of the VTK file
+    void begin(std::ostream & file, const std::string & type) const
+    {
+        const uint16_t one = 1;
+        const bool littleEndian = *reinterpret_cast<const char *>(&one) == 1;
+        file << "<?xml version=\"1.0\"?>\n";
+        file << "<VTKFile type=\"" << type << "\" version=\"0.1\" byte_order=\""
+             << (littleEndian ? "LittleEndian" : "BigEndian") << "\"";
+        if (compressed())
+            file << " compressor=\"vtkZLibDataCompressor\"";
+        file << ">\n";
+    }
+
+    /// writes a data array; in the binary formats, the values are converted to the type E
+    /// which must correspond to the VTK type name *type*
+    template <class E, class V>
+    void dataArray(std::ostream & file, const std::string & type, const std::string & attributes,
+                   const std::vector<V> & values)
+    {
+        file << "<DataArray type=\"" << type << "\" " << attributes;
+        if (!binary())
+        {
+            file << " format=\"ascii\">\n";
+            for (size_t i = 0; i < values.size(); ++i)
+                file << values[i] << " ";
+            file << "</DataArray>\n";
+            return;
+        }
+
+        std::vector<E> converted(values.begin(),values.end());
+        std::string header, payload;
+        encode(reinterpret_cast<const char *>(converted.data()),converted.size()*sizeof(E),header,payload);
+        if (appended())
+        {
+            file << " format=\"appended\" offset=\"" << m_appended.size() << "\"/>\n";
+            m_appended += header;
+            m_appended += payload;
+        }
+        else
+        {
+            // the header and the data are encoded separately as VTK does
+            file << " format=\"binary\">\n" << base64(header) << base64(payload) << "\n</DataArray>\n";
+        }
+    }
+
+    /// appended data and the closing tag of the VTK file
+    void end(std::ostream & file)
+    {
+        if (appended())
+        {
+            file << "<AppendedData encoding=\"raw\">\n_";
+            file.write(m_appended.data(),m_appended.size());
+            file << "\n</AppendedData>\n";
+        }
+        file << "</VTKFile>\n";
+    }
+
+protected:
+    /// binary block: a header with the data size (or the compression header) and the (compressed) data
+    void encode(const char * data, size_t size, std::string & header, std::string & payload) const
+    {
+        if (!compressed())
+        {
+            const uint32_t numBytes = size;
+            header.assign(reinterpret_cast<const char *>(&numBytes),sizeof(uint32_t));
+            payload.assign(data,size);
+            return;
+        }
+#ifdef ELAST_WITH_ZLIB
+        // header: number of blocks, block size, size of the last partial block, compressed sizes of the blocks
+        const size_t blockSize = 32768;
+        const size_t numBlocks = (size + blockSize - 1)/blockSize;
+        std::vector<uint32_t> blockHeader(3+numBlocks);
+        blockHeader[0] = numBlocks;
+        blockHeader[1] = blockSize;
+        blockHeader[2] = size % blockSize;
+        std::vector<Bytef> buffer(compressBound(blockSize));
+        for (size_t b = 0; b < numBlocks; ++b)
+        {
+            const size_t begin = b*blockSize;
+            const size_t length = std::min(blockSize,size-begin);
+            uLongf compressedLength = buffer.size();
+            GISMO_ENSURE(compress2(buffer.data(),&compressedLength,reinterpret_cast<const Bytef *>(data+begin),
+                                   length,Z_DEFAULT_COMPRESSION) == Z_OK,"zlib compression of the Paraview output failed.\n");
+            payload.append(reinterpret_cast<const char *>(buffer.data()),compressedLength);
+            blockHeader[3+b] = compressedLength;
+        }
+        header.assign(reinterpret_cast<const char *>(blockHeader.data()),blockHeader.size()*sizeof(uint32_t));
+#endif
+    }
+
+    static std::string base64(const std::string & bytes)
+    {
+        static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string result;
+        result.reserve(4*((bytes.size()+2)/3));
+        size_t i = 0;
+        for (; i + 2 < bytes.size(); i += 3)
+        {
+            const uint32_t chunk = (uint32_t(uint8_t(bytes[i])) << 16) | (uint32_t(uint8_t(bytes[i+1])) << 8) | uint8_t(bytes[i+2]);
+            result += table[(chunk >> 18) & 63];
+            result += table[(chunk >> 12) & 63];
+            result += table[(chunk >> 6) & 63];
+            result += table[chunk & 63];
+        }
+        if (i < bytes.size())
+        {
+            uint32_t chunk = uint32_t(uint8_t(bytes[i])) << 16;
+            if (i + 1 < bytes.size())
+                chunk |= uint32_t(uint8_t(bytes[i+1])) << 8;
+            result += table[(chunk >> 18) & 63];
+            result += table[(chunk >> 12) & 63];
+            result += i + 1 < bytes.size() ? table[(chunk >> 6) & 63] : '=';
+            result += '=';
+        }
+        return result;
+    }
+
+protected:
+    vtk_format::format m_format;
+    /// appended binary data of all arrays
+    std::string m_appended;
+};
+
+/// stores the columns of a matrix one after another, padded with zeros to *numComp* components
+template<class T>
+void vtkFlatten(const gsMatrix<T> & matrix, index_t numComp, std::vector<T> & values)
+{
+    values.assign(numComp*matrix.cols(),0.);
+    const index_t rows = std::min<index_t>(matrix.rows(),numComp);
+    for (index_t j = 0; j < matrix.cols(); ++j)
+        for (index_t i = 0; i < rows; ++i)
+            values[j*numComp+i] = matrix(i,j);
+}
+
+} // namespace internal
+
 
 //---------- START REPEATED from gsWriteParaview.hpp
 
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn)
+                           std::string const & fn,
+                           vtk_format::format format = vtk_format::ascii)
 {
     const short_t d = Geo.parDim();
     gsMesh<T> msh;
@@ -56,91 +230,179 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
         return;
     }
 
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaviewMesh(msh, fn, format);
 }
 
 template<class T>
 void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
-                         std::string const & fn, unsigned resolution = 8)
+                         std::string const & fn, unsigned resolution = 8,
+                         vtk_format::format format = vtk_format::ascii)
 {
     gsMesh<T> msh(basis, resolution);
     Geo.evaluateMesh(msh);
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaviewMesh(msh, fn, format);
 }
 
 
 //---------- END REPEATED from gsWriteParaview.hpp
 
 
+namespace internal
+{
+
+/// number of threads used to write numP patches: all available threads if numThreads = 0
+inline int outputThreads(index_t numThreads, unsigned numP)
+{
+#ifdef _OPENMP
+    const int available = numThreads > 0 ? numThreads : omp_get_max_threads();
+    return std::max(1,std::min(available,(int)numP));
+#else
+    GISMO_UNUSED(numThreads); GISMO_UNUSED(numP);
+    return 1;
+#endif
+}
+
+} // namespace internal
+
 template<class T>
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T>*> fields,
                                  std::string const & fn,
-                                 unsigned npts, bool mesh, bool ctrlNet)
+                                 unsigned npts, bool mesh, bool ctrlNet,
+                                 vtk_format::format format, index_t numThreads)
 {
+    ELAST_PROFILE_REGION("output");
     const unsigned numP = fields.begin()->second->patches().nPatches();
     gsParaviewCollection collection(fn);
     std::string fileName = fn.substr(fn.find_last_of("/\\")+1); // file name without a path
 
-    for ( unsigned i=0; i < numP; ++i )
+    // patches are sampled and written concurrently; an exception cannot leave the parallel region,
+    // so the first one is rethrown afterwards
+    std::exception_ptr error;
+    const int nThreads = internal::outputThreads(numThreads,numP);
+    GISMO_UNUSED(nThreads);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+    for ( index_t i=0; i < (index_t)numP; ++i )
     {
-        const gsBasis<> & dom = fields.begin()->second->isParametrized() ?
-            fields.begin()->second->igaFunction(i).basis() : fields.begin()->second->patch(i).basis();
+        try
+        {
+            ELAST_PROFILE_SCOPE("patch");
+            const gsBasis<> & dom = fields.begin()->second->isParametrized() ?
+                fields.begin()->second->igaFunction(i).basis() : fields.begin()->second->patch(i).basis();
+
+            gsWriteParaviewMultiPhysicsSinglePatch( fields, i, fn + util::to_string(i), npts, format);
+            if ( mesh )
+                writeSingleCompMesh(dom, fields.begin()->second->patch(i), fn + util::to_string(i) + "_mesh", 8, format);
+            if ( ctrlNet ) // Output the control net
+                writeSingleControlNet(fields.begin()->second->patch(i), fn + util::to_string(i) + "_cnet", format);
+        }
+        catch (...)
+        {
+#pragma omp critical (gsWriteParaviewMultiPhysics_error)
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
 
-        gsWriteParaviewMultiPhysicsSinglePatch( fields, i, fn + util::to_string(i), npts);
+    // the collection is filled in the patch order, independently of the order in which the files were written
+    for ( unsigned i=0; i < numP; ++i )
+    {
         collection.addPart(fileName + util::to_string(i), ".vts");
-
         if ( mesh )
-            {
-                writeSingleCompMesh(dom, fields.begin()->second->patch(i), fn + util::to_string(i) + "_mesh");
             collection.addPart(fileName + util::to_string(i) + "_mesh", ".vtp");
-        }
-        if ( ctrlNet ) // Output the control net
-        {
-            writeSingleControlNet(fields.begin()->second->patch(i), fn + util::to_string(i) + "_cnet");
+        if ( ctrlNet )
             collection.addPart(fileName + util::to_string(i) + "_cnet", ".vtp");
-        }
-
     }
     collection.save();
 }
 
 template<class T>
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts)
+                                         gsParaviewCollection & collection, int time, unsigned npts,
+                                         vtk_format::format format, index_t numThreads)
 {
+    ELAST_PROFILE_REGION("output");
     const unsigned numP = fields.begin()->second->patches().nPatches();
     std::string fileName = fn.substr(fn.find_last_of("/\\")+1); // file name without a path
 
-    for ( size_t p = 0; p < numP; ++p)
+    std::exception_ptr error;
+    const int nThreads = internal::outputThreads(numThreads,numP);
+    GISMO_UNUSED(nThreads);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+    for ( index_t p = 0; p < (index_t)numP; ++p)
     {
-        gsWriteParaviewMultiPhysicsSinglePatch(fields,p,fn + util::to_string(time) + "_" + util::to_string(p),npts);
-        collection.addTimestep(fileName + util::to_string(time) + "_",p,time,".vts");
+        try
+        {
+            ELAST_PROFILE_SCOPE("patch");
+            gsWriteParaviewMultiPhysicsSinglePatch(fields,p,fn + util::to_string(time) + "_" + util::to_string(p),npts,format);
+        }
+        catch (...)
+        {
+#pragma omp critical (gsWriteParaviewMultiPhysics_error)
+            if (!error)
+                error = std::current_exception();
+        }
     }
+    if (error)
+        std::rethrow_exception(error);
 
+    for ( size_t p = 0; p < numP; ++p)
+        collection.addTimestep(fileName + util::to_string(time) + "_",p,time,".vts");
 }
 
 template<class T>
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T> *> fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts)
+                                unsigned npts,
+                                vtk_format::format format)
+{
+    gsMatrix<T> eval_geo;
+    std::map<std::string, gsMatrix<T> > data;
+    gsVector<index_t> np;
+    gsSampleMultiPhysicsSinglePatch(fields.begin()->second->patches().patch(patchNum),
+                                    fields,patchNum,npts,eval_geo,data,np);
+    if (np.size() > 0)
+        gsWriteParaviewMultiTPgrid(eval_geo, data, np, fn, format);
+}
+
+template<class T>
+void gsSampleMultiPhysicsSinglePatch(const gsGeometry<T> & geometry,
+                                     std::map<std::string,const gsField<T> *> fields,
+                                     const unsigned patchNum,
+                                     unsigned npts,
+                                     gsMatrix<T> & eval_geo,
+                                     std::map<std::string, gsMatrix<T> > & data,
+                                     gsVector<index_t> & np)
 {
-    const gsGeometry<> & geometry = fields.begin()->second->patches().patch(patchNum);
     const short_t n = geometry.targetDim();
     const short_t d = geometry.domainDim();
 
-    gsMatrix<> ab = geometry.support();
-    gsVector<> a = ab.col(0);
-    gsVector<> b = ab.col(1);
-    gsVector<unsigned> np = distributePoints<T>(geometry,npts);
-    gsMatrix<> pts = gsPointGrid(a,b,np);
-
-    gsMatrix<> eval_geo = geometry.eval(pts);
-    std::map<std::string, gsMatrix<> > data;
+    gsMatrix<T> ab = geometry.support();
+    gsVector<T> a = ab.col(0);
+    gsVector<T> b = ab.col(1);
+    gsVector<unsigned> npu = distributePoints<T>(geometry,npts);
+    gsMatrix<T> pts = gsPointGrid(a,b,npu);
+
+    // tensor-product patches are evaluated on the grid by sum factorization
+    gsGridEvaluator<T> grid(pts,npu);
+    if (gsGridEvaluator<T>::applicable(geometry.basis()))
+        grid.eval_into(geometry,eval_geo);
+    else
+        eval_geo = geometry.eval(pts);
+    data.clear();
     for (typename std::map<std::string,const gsField<T> *>::iterator it = fields.begin(); it != fields.end(); it++)
     {
-        data[it->first] = it->second->isParametric() ?
-                    it->second->function(patchNum).eval(pts) : it->second->function(patchNum).eval(eval_geo);
+        const gsCauchyStressFunction<T> * stress = it->second->isParametric() ?
+                    dynamic_cast<const gsCauchyStressFunction<T> *>(&(it->second->function(patchNum))) : nullptr;
+        if (it->second->isParametrized() && gsGridEvaluator<T>::applicable(it->second->igaFunction(patchNum).basis()))
+            grid.eval_into(it->second->igaFunction(patchNum),data[it->first]);
+        else if (stress != nullptr)
+            stress->evalGrid_into(grid,data[it->first]);
+        else
+            data[it->first] = it->second->isParametric() ?
+                        it->second->function(patchNum).eval(pts) : it->second->function(patchNum).eval(eval_geo);
 
         if ( data[it->first].rows() == 2 )
         {
@@ -149,6 +411,7 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T
         }
     }
 
+    np = npu.template cast<index_t>();
     if (3 -d > 0)
     {
         np.conservativeResize(3);
@@ -157,6 +420,7 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T
     else if (d > 3)
     {
         gsWarn<< "Cannot plot 4D data.\n";
+        np.resize(0);
         return;
     }
 
@@ -169,35 +433,24 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T
     {
         gsWarn<< "Data is more than 3 dimensions.\n";
     }
-
-    /*for (typename std::map<std::string, gsMatrix<> >::iterator it = data.begin(); it != data.end(); it++)
-    {
-        if ( it->second.rows() > 1 )
-        {
-            it->second.conservativeResize(3,eval_geo.cols() );
-            it->second.bottomRows( 3-dd ).setZero();
-        }
-    }*/
-
-    gsWriteParaviewMultiTPgrid(eval_geo, data, np.template cast<index_t>(), fn);
 }
 
 template<class T>
 void gsWriteParaviewMultiTPgrid(gsMatrix<T> const& points,
                                 std::map<std::string, gsMatrix<T> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn)
+                                std::string const & fn,
+                                vtk_format::format format)
 {
-    const int n = points.rows();
-
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    internal::gsVtkArrayWriter writer(format);
+    std::vector<T> values;
 
-    file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    writer.begin(file,"StructuredGrid");
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
@@ -206,37 +459,73 @@ void gsWriteParaviewMultiTPgrid(gsMatrix<T> const& points,
     file <<"<PointData>\n";
     for (typename std::map<std::string, gsMatrix<T> >::iterator it = data.begin(); it != data.end(); it++)
     {
-        file <<"<DataArray type=\"Float32\" Name=\""<< it->first <<"\" format=\"ascii\" NumberOfComponents=\""<< ( it->second.rows()==1 ? 1 : 3) <<"\">\n";
-        if ( it->second.rows()==1 )
-            for ( index_t j=0; j<it->second.cols(); ++j)
-                file<< it->second.at(j) <<" ";
-        else
-        {
-            for ( index_t j=0; j<it->second.cols(); ++j)
-            {
-                for ( index_t i=0; i!=it->second.rows(); ++i)
-                    file<< it->second(i,j) <<" ";
-                for ( index_t i=it->second.rows(); i<3; ++i)
-                    file<<"0 ";
-            }
-        }
-        file <<"</DataArray>\n";
+        const index_t numComp = it->second.rows()==1 ? 1 : 3;
+        internal::vtkFlatten(it->second,numComp,values);
+        writer.template dataArray<float>(file,"Float32","Name=\"" + it->first + "\" NumberOfComponents=\"" +
+                                         util::to_string(numComp) + "\"",values);
     }
     file <<"</PointData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<points.cols(); ++j)
-    {
-        for ( index_t i=0; i!=n; ++i)
-            file<< points(i,j) <<" ";
-        for ( index_t i=n; i<3; ++i)
-            file<<"0 ";
-    }
-    file <<"</DataArray>\n";
+    internal::vtkFlatten(points,3,values);
+    writer.template dataArray<float>(file,"Float32","NumberOfComponents=\"3\"",values);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
-    file <<"</VTKFile>\n";
+    writer.end(file);
+
+    file.close();
+}
+
+template<class T>
+void gsWriteParaviewMesh(gsMesh<T> const & mesh, std::string const & fn, vtk_format::format format)
+{
+    if (format == vtk_format::ascii)
+    {
+        gsWriteParaview(mesh, fn, false);
+        return;
+    }
+
+    std::string mfn(fn);
+    mfn.append(".vtp");
+    std::ofstream file(mfn.c_str(), std::ios::binary);
+    internal::gsVtkArrayWriter writer(format);
+
+    std::vector<T> points(3*mesh.numVertices());
+    for (size_t i = 0; i < mesh.numVertices(); ++i)
+        for (short_t k = 0; k < 3; ++k)
+            points[3*i+k] = mesh.vertex(i)[k];
+    std::vector<index_t> lines, lineOffsets, polys, polyOffsets;
+    for (size_t e = 0; e < mesh.edges().size(); ++e)
+    {
+        lines.push_back(mesh.edges()[e].source->getId());
+        lines.push_back(mesh.edges()[e].target->getId());
+        lineOffsets.push_back(lines.size());
+    }
+    for (size_t f = 0; f < mesh.faces().size(); ++f)
+    {
+        for (size_t v = 0; v < mesh.faces()[f]->vertices.size(); ++v)
+            polys.push_back(mesh.faces()[f]->vertices[v]->getId());
+        polyOffsets.push_back(polys.size());
+    }
+
+    writer.begin(file,"PolyData");
+    file << "<PolyData>\n";
+    file << "<Piece NumberOfPoints=\"" << mesh.numVertices() << "\" NumberOfVerts=\"0\" NumberOfLines=\""
+         << lineOffsets.size() << "\" NumberOfStrips=\"0\" NumberOfPolys=\"" << polyOffsets.size() << "\">\n";
+    file << "<Points>\n";
+    writer.template dataArray<float>(file,"Float32","NumberOfComponents=\"3\"",points);
+    file << "</Points>\n";
+    file << "<Lines>\n";
+    writer.template dataArray<int32_t>(file,"Int32","Name=\"connectivity\"",lines);
+    writer.template dataArray<int32_t>(file,"Int32","Name=\"offsets\"",lineOffsets);
+    file << "</Lines>\n";
+    file << "<Polys>\n";
+    writer.template dataArray<int32_t>(file,"Int32","Name=\"connectivity\"",polys);
+    writer.template dataArray<int32_t>(file,"Int32","Name=\"offsets\"",polyOffsets);
+    file << "</Polys>\n";
+    file << "</Piece>\n";
+    file << "</PolyData>\n";
+    writer.end(file);
 
     file.close();
 }
@@ -8,21 +8,37 @@ namespace gismo
 {
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<real_t>* > fields, std::string const & fn,
-                     unsigned npts, bool mesh, bool cnet);
+                     unsigned npts, bool mesh, bool cnet, vtk_format::format format, index_t numThreads);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<real_t> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts);
+                                         gsParaviewCollection & collection, int time, unsigned npts,
+                                         vtk_format::format format, index_t numThreads);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<real_t>* > fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts);
+                                unsigned npts,
+                                vtk_format::format format);
+
+TEMPLATE_INST
+void gsSampleMultiPhysicsSinglePatch(const gsGeometry<real_t> & geometry,
+                                     std::map<std::string,const gsField<real_t> *> fields,
+                                     const unsigned patchNum,
+                                     unsigned npts,
+                                     gsMatrix<real_t> & points,
+                                     std::map<std::string, gsMatrix<real_t> > & data,
+                                     gsVector<index_t> & np);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiTPgrid(gsMatrix<real_t> const& points,
                                 std::map<std::string, gsMatrix<real_t> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn);
+                                std::string const & fn,
+                                vtk_format::format format);
+
+TEMPLATE_INST
+void gsWriteParaviewMesh(gsMesh<real_t> const & mesh, std::string const & fn,
+                         vtk_format::format format);
 }
@@ -0,0 +1,87 @@
+/** @file gsXdmfCollection.h
+
+    @brief Writes time series of several fields defined on the same geometry
+    to a single HDF5 file with an XDMF description readable by Paraview.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+#include <gsCore/gsLinearAlgebra.h>
+#include <fstream>
+
+namespace gismo
+{
+
+/** @brief A single-file alternative to gsParaviewCollection + gsWriteParaviewMultiPhysicsTimeStep.
+ *
+ * Each call of addTimestep() stores every patch and every field as a compressed HDF5 dataset
+ * of the size numPoints x numComponents in the group /patch<p>/step<s> of fn.h5.
+ * The sampled geometry is stored only if it has changed since the last time step,
+ * so a fixed geometry is written once and an ALE-deformed geometry at every step.
+ * The light-weight XDMF file (fn.xdmf) references the data in fn.h5. Since the datasets of earlier
+ * time steps never change, addTimestep() only appends the description of the new step to it;
+ * open the .xdmf file in Paraview (Xdmf3 reader).
+ *
+ * The HDF5 file is opened only during addTimestep(), so all previous time steps remain readable
+ * if the simulation is interrupted. Requires gsElasticity to be built with HDF5 (ELAST_WITH_HDF5).
+*/
+template <class T>
+class gsXdmfCollection
+{
+public:
+    /// @param fn file name without an extension
+    /// @param compression deflate level from 0 (no compression) to 9
+    explicit gsXdmfCollection(std::string const & fn, index_t compression = 4);
+
+    /// sample the fields on a grid with npts points per patch, write them to the HDF5 file and append
+    /// the time step to the XDMF file; npts and the set of fields must not change between time steps
+    void addTimestep(std::map<std::string, const gsField<T> *> fields, T time, unsigned npts = 1000);
+
+    /// flush the XDMF description of all time steps added so far; addTimestep() keeps it complete anyway
+    void save();
+
+    /// number of stored time steps
+    index_t numTimesteps() const { return m_times.size(); }
+
+protected:
+    /// per-patch information shared by all time steps
+    struct PatchInfo
+    {
+        gsVector<index_t> np;                       // number of sampling points in each direction
+        std::vector<std::string> names;             // field names
+        std::vector<std::string> datasets;          // field dataset names
+        std::vector<index_t> numComp;               // number of components of the fields
+        std::vector<float> lastPoints;              // last stored geometry
+        index_t numGeoSteps;                        // number of stored geometries
+    };
+
+    /// replace characters which are not welcome in HDF5 paths
+    static std::string datasetName(const std::string & name);
+
+    /// write the closing tags and move the write position back in front of them
+    void closeDescription();
+
+protected:
+    std::string m_fn;
+    index_t m_compression;
+    std::vector<PatchInfo> m_patches;
+    std::vector<T> m_times;
+    /// XDMF description, kept open to append time steps
+    std::ofstream m_description;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsXdmfCollection.hpp)
+#endif
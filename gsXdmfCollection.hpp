@@ -0,0 +1,224 @@
+/** @file gsXdmfCollection.hpp
+
+    @brief Implementation of gsXdmfCollection.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsXdmfCollection.h>
+#include <gsElasticity/gsElasticityConfig.h>
+
+#include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+#include <gsCore/gsField.h>
+#include <gsElasticity/gsProfiler.h>
+#include <sstream>
+
+#ifdef ELAST_WITH_HDF5
+#include <hdf5.h>
+#endif
+
+namespace gismo
+{
+
+namespace internal
+{
+
+/// copies the first numComp rows of an evaluation matrix point by point, pads with zeros
+template <class T>
+void xdmfFlatten(const gsMatrix<T> & matrix, index_t numComp, std::vector<float> & values)
+{
+    values.assign(matrix.cols()*numComp,0.f);
+    const index_t rows = std::min(numComp,(index_t)matrix.rows());
+    for (index_t j = 0; j < matrix.cols(); ++j)
+        for (index_t i = 0; i < rows; ++i)
+            values[j*numComp+i] = static_cast<float>(matrix(i,j));
+}
+
+/// XDMF reference to a numPoints x numComp HDF5 dataset
+inline void xdmfDataItem(std::ostream & out, const std::string & path, index_t numPoints, index_t numComp)
+{
+    out << "<DataItem Dimensions=\"" << numPoints << " " << numComp
+        << "\" NumberType=\"Float\" Precision=\"4\" Format=\"HDF\">" << path << "</DataItem>\n";
+}
+
+#ifdef ELAST_WITH_HDF5
+/// write values as a new numPoints x numComp dataset; missing groups are created
+inline void h5WriteDataset(hid_t file, const std::string & path, const std::vector<float> & values,
+                           hsize_t numPoints, hsize_t numComp, int compression)
+{
+    hsize_t dims[2] = {numPoints,numComp};
+    hid_t space = H5Screate_simple(2,dims,NULL);
+    hid_t createList = H5Pcreate(H5P_DATASET_CREATE);
+    if (compression > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+    {
+        // filters require a chunked layout; one chunk holds the whole dataset
+        H5Pset_chunk(createList,2,dims);
+        H5Pset_shuffle(createList);
+        H5Pset_deflate(createList,compression);
+    }
+    hid_t linkList = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(linkList,1);
+    hid_t dset = H5Dcreate2(file,path.c_str(),H5T_NATIVE_FLOAT,space,linkList,createList,H5P_DEFAULT);
+    H5Pclose(linkList);
+    H5Pclose(createList);
+    H5Sclose(space);
+    GISMO_ENSURE(dset >= 0,"Cannot create the HDF5 dataset " + path + ".\n");
+
+    herr_t status = H5Dwrite(dset,H5T_NATIVE_FLOAT,H5S_ALL,H5S_ALL,H5P_DEFAULT,values.data());
+    H5Dclose(dset);
+    GISMO_ENSURE(status >= 0,"Failed to write to the HDF5 dataset " + path + ".\n");
+}
+#endif
+
+} // namespace internal
+
+template <class T>
+gsXdmfCollection<T>::gsXdmfCollection(std::string const & fn, index_t compression)
+    : m_fn(fn),
+      m_compression(compression)
+{
+#ifdef ELAST_WITH_HDF5
+    // create (or truncate) the data file right away
+    hid_t file = H5Fcreate((m_fn + ".h5").c_str(),H5F_ACC_TRUNC,H5P_DEFAULT,H5P_DEFAULT);
+    GISMO_ENSURE(file >= 0,"Cannot create " + m_fn + ".h5.\n");
+    H5Fclose(file);
+
+    m_description.open((m_fn + ".xdmf").c_str());
+    GISMO_ENSURE(m_description.good(),"Cannot create " + m_fn + ".xdmf.\n");
+    m_description << std::setprecision(12)
+                  << "<?xml version=\"1.0\" ?>\n"
+                  << "<Xdmf Version=\"3.0\">\n<Domain>\n"
+                  << "<Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    closeDescription();
+#else
+    GISMO_ERROR("gsXdmfCollection requires HDF5. Reconfigure gsElasticity with HDF5 available.\n");
+#endif
+}
+
+template <class T>
+std::string gsXdmfCollection<T>::datasetName(const std::string & name)
+{
+    std::string result(name);
+    for (size_t i = 0; i < result.size(); ++i)
+        if (result[i] == ' ' || result[i] == '/' || result[i] == '.' || result[i] == ':')
+            result[i] = '_';
+    return result;
+}
+
+template <class T>
+void gsXdmfCollection<T>::addTimestep(std::map<std::string, const gsField<T> *> fields, T time, unsigned npts)
+{
+    ELAST_PROFILE_REGION("output");
+#ifdef ELAST_WITH_HDF5
+    GISMO_ENSURE(!fields.empty(),"No fields to write.\n");
+    const gsField<T> & first = *(fields.begin()->second);
+    const size_t numP = first.patches().nPatches();
+    const bool firstStep = m_times.empty();
+    if (firstStep)
+        m_patches.resize(numP);
+    GISMO_ENSURE(m_patches.size() == numP,"The number of patches has changed.\n");
+
+    hid_t file = H5Fopen((m_fn + ".h5").c_str(),H5F_ACC_RDWR,H5P_DEFAULT);
+    GISMO_ENSURE(file >= 0,"Cannot open " + m_fn + ".h5.\n");
+
+    const index_t step = m_times.size();
+    const std::string h5 = m_fn.substr(m_fn.find_last_of("/\\")+1) + ".h5:"; // file name without a path
+    std::ostringstream grid;
+    grid << std::setprecision(12)
+         << "<Grid Name=\"step" << step << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n"
+         << "<Time Value=\"" << time << "\"/>\n";
+
+    gsMatrix<T> points;
+    std::map<std::string, gsMatrix<T> > data;
+    gsVector<index_t> np;
+    std::vector<float> values;
+    for (size_t p = 0; p < numP; ++p)
+    {
+        gsSampleMultiPhysicsSinglePatch(first.patch(p),fields,p,npts,points,data,np);
+        GISMO_ENSURE(np.size() > 0,"Cannot write patch " + util::to_string(p) + ".\n");
+        PatchInfo & info = m_patches[p];
+        const std::string group = "/patch" + util::to_string(p) + "/";
+        if (firstStep)
+        {
+            info.np = np;
+            info.numGeoSteps = 0;
+            for (typename std::map<std::string, gsMatrix<T> >::const_iterator it = data.begin(); it != data.end(); ++it)
+            {
+                info.names.push_back(it->first);
+                info.datasets.push_back(datasetName(it->first));
+                info.numComp.push_back(it->second.rows() == 1 ? 1 : 3);
+            }
+        }
+        GISMO_ENSURE(info.np == np && info.names.size() == data.size(),
+                     "The sampling grid or the set of fields has changed.\n");
+
+        // store the geometry only if it differs from the last stored one
+        internal::xdmfFlatten(points,3,values);
+        if (info.numGeoSteps == 0 || values != info.lastPoints)
+        {
+            internal::h5WriteDataset(file,group + "geometry" + util::to_string(info.numGeoSteps),
+                                     values,points.cols(),3,m_compression);
+            info.lastPoints.swap(values);
+            ++info.numGeoSteps;
+        }
+
+        grid << "<Grid Name=\"patch" << p << "\" GridType=\"Uniform\">\n"
+             << "<Topology TopologyType=\"3DSMesh\" Dimensions=\""
+             << np(2) << " " << np(1) << " " << np(0) << "\"/>\n"
+             << "<Geometry GeometryType=\"XYZ\">\n";
+        internal::xdmfDataItem(grid,h5 + group + "geometry" + util::to_string(info.numGeoSteps-1),points.cols(),3);
+        grid << "</Geometry>\n";
+
+        index_t f = 0;
+        for (typename std::map<std::string, gsMatrix<T> >::const_iterator it = data.begin(); it != data.end(); ++it, ++f)
+        {
+            const std::string path = group + "step" + util::to_string(step) + "/" + info.datasets[f];
+            internal::xdmfFlatten(it->second,info.numComp[f],values);
+            internal::h5WriteDataset(file,path,values,points.cols(),info.numComp[f],m_compression);
+            grid << "<Attribute Name=\"" << info.names[f] << "\" AttributeType=\""
+                 << (info.numComp[f] == 1 ? "Scalar" : "Vector") << "\" Center=\"Node\">\n";
+            internal::xdmfDataItem(grid,h5 + path,points.cols(),info.numComp[f]);
+            grid << "</Attribute>\n";
+        }
+        grid << "</Grid>\n";
+    }
+    H5Fclose(file);
+    grid << "</Grid>\n";
+
+    m_times.push_back(time);
+    // the data of the step is on disk before the description references it,
+    // so an interrupted simulation stays viewable
+    m_description << grid.str();
+    closeDescription();
+#else
+    GISMO_UNUSED(fields); GISMO_UNUSED(time); GISMO_UNUSED(npts);
+    GISMO_ERROR("gsXdmfCollection requires HDF5. Reconfigure gsElasticity with HDF5 available.\n");
+#endif
+}
+
+template <class T>
+void gsXdmfCollection<T>::save()
+{
+    m_description.flush();
+    GISMO_ENSURE(!m_description.fail(),"Writing " + m_fn + ".xdmf failed.\n");
+}
+
+template <class T>
+void gsXdmfCollection<T>::closeDescription()
+{
+    const std::streampos end = m_description.tellp();
+    m_description << "</Grid>\n</Domain>\n</Xdmf>\n";
+    save();
+    m_description.seekp(end);
+}
+
+} // namespace ends
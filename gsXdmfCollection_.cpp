@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsXdmfCollection.h>
+#include <gsElasticity/gsXdmfCollection.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsXdmfCollection<real_t>;
+}